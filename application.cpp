@@ -231,6 +231,7 @@ int main(int argc, char** argv)
     auto wolk = wolkabout::connect::WolkBuilder(device)
                   .host(PLATFORM_HOST)
                   .feedUpdateHandler(deviceInfoHandler)
+                  .withFlushPolicy(0, std::chrono::milliseconds(1000))
                   .buildWolkSingle();
     wolk->connect();
     bool running = true;
@@ -303,7 +304,6 @@ int main(int argc, char** argv)
             LOG(INFO) << "\t IP_ADD changed";
             LOG(INFO) << "NEW IP: " << ip;
         }
-        wolk->publish();
         std::this_thread::sleep_for(std::chrono::milliseconds(1000));
     }
     return 0;
@@ -0,0 +1,122 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/utilities/CommandQueue.h"
+#include "wolk/utilities/RingCommandQueue.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace wolkabout::connect;
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+struct Result
+{
+    double commandsPerSecond;
+    std::int64_t p50;
+    std::int64_t p99;
+    std::int64_t p999;
+    std::int64_t max;
+};
+
+// Pushes the commands from all the producers at once, and measures how long each command waited to be executed
+Result run(CommandExecutor& executor, std::size_t producers, std::size_t commandsPerProducer)
+{
+    const auto total = producers * commandsPerProducer;
+    auto latencies = std::vector<std::int64_t>{};
+    latencies.reserve(total);
+    std::mutex mutex;
+    std::condition_variable condition;
+    auto done = false;
+
+    const auto start = Clock::now();
+    auto threads = std::vector<std::thread>{};
+    for (auto producer = std::size_t{0}; producer < producers; ++producer)
+        threads.emplace_back([&] {
+            for (auto i = std::size_t{0}; i < commandsPerProducer; ++i)
+            {
+                const auto pushed = Clock::now();
+                executor.pushCommand([&, pushed] {
+                    latencies.emplace_back(
+                      std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - pushed).count());
+                    if (latencies.size() == total)
+                    {
+                        std::lock_guard<std::mutex> lock{mutex};
+                        done = true;
+                        condition.notify_one();
+                    }
+                });
+            }
+        });
+    for (auto& thread : threads)
+        thread.join();
+    {
+        std::unique_lock<std::mutex> lock{mutex};
+        condition.wait(lock, [&] { return done; });
+    }
+    const auto elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::sort(latencies.begin(), latencies.end());
+    const auto percentile = [&](double fraction) {
+        return latencies[static_cast<std::size_t>(fraction * static_cast<double>(latencies.size() - 1))];
+    };
+    return Result{static_cast<double>(total) / elapsed, percentile(0.5), percentile(0.99), percentile(0.999),
+                  latencies.back()};
+}
+
+void print(const std::string& name, std::size_t producers, const Result& result)
+{
+    std::cout << std::left << std::setw(18) << name << std::right << std::setw(10) << producers << std::setw(16)
+              << static_cast<std::uint64_t>(result.commandsPerSecond) << std::setw(12) << result.p50 << std::setw(12)
+              << result.p99 << std::setw(12) << result.p999 << std::setw(14) << result.max << std::endl;
+}
+}    // namespace
+
+int main(int argc, char** argv)
+{
+    const auto commandsPerProducer =
+      argc > 1 ? static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10)) : std::size_t{200000};
+
+    std::cout << std::left << std::setw(18) << "executor" << std::right << std::setw(10) << "producers"
+              << std::setw(16) << "commands/s" << std::setw(12) << "p50 ns" << std::setw(12) << "p99 ns"
+              << std::setw(12) << "p99.9 ns" << std::setw(14) << "max ns" << std::endl;
+    for (const auto producers : {1u, 2u, 4u, 8u})
+    {
+        {
+            CommandQueue queue;
+            print("CommandQueue", producers, run(queue, producers, commandsPerProducer));
+        }
+        {
+            RingCommandQueue queue;
+            print("RingCommandQueue", producers, run(queue, producers, commandsPerProducer));
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,168 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/utilities/BoundedCommandQueue.h"
+#include "wolk/utilities/CommandQueue.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace wolkabout::connect;
+using namespace ::testing;
+
+class BoundedCommandQueueTests : public ::testing::Test
+{
+public:
+    std::unique_ptr<BoundedCommandQueue> makeQueue(std::size_t capacity, BackpressureMode mode)
+    {
+        return std::unique_ptr<BoundedCommandQueue>{
+          new BoundedCommandQueue{std::unique_ptr<CommandExecutor>{new CommandQueue}, capacity, mode}};
+    }
+
+    // Keeps the worker busy until `unblock` is called, so the offered commands stay in the queue
+    void block(BoundedCommandQueue& queue)
+    {
+        queue.pushCommand([this] {
+            std::unique_lock<std::mutex> lock{mutex};
+            condition.wait(lock, [this] { return released; });
+        });
+    }
+
+    void unblock()
+    {
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            released = true;
+        }
+        condition.notify_all();
+    }
+
+    void record(int value)
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        values.emplace_back(value);
+        condition.notify_all();
+    }
+
+    bool waitForValues(std::size_t count)
+    {
+        std::unique_lock<std::mutex> lock{mutex};
+        return condition.wait_for(lock, std::chrono::seconds{1}, [&] { return values.size() >= count; });
+    }
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool released = false;
+    std::vector<int> values;
+};
+
+TEST_F(BoundedCommandQueueTests, RejectsWhenFull)
+{
+    auto queue = makeQueue(2, BackpressureMode::Reject);
+    block(*queue);
+    EXPECT_TRUE(queue->offerCommand([this] { record(1); }));
+    EXPECT_TRUE(queue->offerCommand([this] { record(2); }));
+    EXPECT_FALSE(queue->offerCommand([this] { record(3); }));
+    EXPECT_EQ(queue->getDepth(), 2);
+
+    unblock();
+    ASSERT_TRUE(waitForValues(2));
+    EXPECT_TRUE(queue->offerCommand([this] { record(4); }));
+    ASSERT_TRUE(waitForValues(3));
+    EXPECT_EQ(values, (std::vector<int>{1, 2, 4}));
+    EXPECT_EQ(queue->getDepth(), 0);
+}
+
+TEST_F(BoundedCommandQueueTests, PushedCommandsDoNotCount)
+{
+    auto queue = makeQueue(1, BackpressureMode::Reject);
+    block(*queue);
+    queue->pushCommand([this] { record(1); });
+    queue->pushCommand([this] { record(2); });
+    EXPECT_EQ(queue->getDepth(), 0);
+    EXPECT_TRUE(queue->offerCommand([this] { record(3); }));
+    unblock();
+    ASSERT_TRUE(waitForValues(3));
+}
+
+TEST_F(BoundedCommandQueueTests, BlocksUntilThereIsRoom)
+{
+    auto queue = makeQueue(1, BackpressureMode::Block);
+    block(*queue);
+    EXPECT_TRUE(queue->offerCommand([this] { record(1); }));
+
+    std::atomic_bool offered{false};
+    auto producer = std::thread{[&] {
+        queue->offerCommand([this] { record(2); });
+        offered = true;
+    }};
+    std::this_thread::sleep_for(std::chrono::milliseconds{50});
+    EXPECT_FALSE(offered);
+
+    unblock();
+    producer.join();
+    EXPECT_TRUE(offered);
+    ASSERT_TRUE(waitForValues(2));
+    EXPECT_EQ(values, (std::vector<int>{1, 2}));
+}
+
+TEST_F(BoundedCommandQueueTests, CommandsOfTheQueueAreNotBlocked)
+{
+    auto queue = makeQueue(1, BackpressureMode::Block);
+    queue->pushCommand([&] {
+        for (auto i = 0; i < 3; ++i)
+            queue->offerCommand([this, i] { record(i); });
+    });
+    ASSERT_TRUE(waitForValues(3));
+    EXPECT_EQ(values, (std::vector<int>{0, 1, 2}));
+}
+
+TEST_F(BoundedCommandQueueTests, CoalescesByFeed)
+{
+    auto queue = makeQueue(1, BackpressureMode::CoalesceByFeed);
+    block(*queue);
+    EXPECT_TRUE(queue->offerCommand("D", "A", [this] { record(1); }));
+    EXPECT_TRUE(queue->offerCommand("D", "A", [this] { record(2); }));
+    EXPECT_TRUE(queue->offerCommand("D", "A", [this] { record(3); }));
+    EXPECT_TRUE(queue->offerCommand("D", "B", [this] { record(4); }));
+    EXPECT_EQ(queue->getDepth(), 3);
+
+    // A command that does not belong to a feed can not be coalesced
+    EXPECT_FALSE(queue->offerCommand([this] { record(5); }));
+
+    unblock();
+    ASSERT_TRUE(waitForValues(3));
+    EXPECT_EQ(values, (std::vector<int>{1, 3, 4}));
+    EXPECT_EQ(queue->getDepth(), 0);
+}
+
+TEST_F(BoundedCommandQueueTests, UnlimitedWithoutCapacity)
+{
+    auto queue = makeQueue(0, BackpressureMode::Reject);
+    block(*queue);
+    for (auto i = 0; i < 100; ++i)
+        EXPECT_TRUE(queue->offerCommand([this, i] { record(i); }));
+    EXPECT_EQ(queue->getDepth(), 100);
+    unblock();
+    ASSERT_TRUE(waitForValues(100));
+}
@@ -0,0 +1,149 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#define private public
+#define protected public
+#include "wolk/persistence/BoundedInMemoryPersistence.h"
+#undef private
+#undef protected
+
+#include <gtest/gtest.h>
+
+using namespace wolkabout;
+using namespace wolkabout::connect;
+using namespace ::testing;
+
+class BoundedInMemoryPersistenceTests : public ::testing::Test
+{
+public:
+    static Reading makeReading(std::uint64_t timestamp) { return Reading{"T", "12.5", timestamp}; }
+
+    static std::vector<std::uint64_t> timestamps(Persistence& persistence, const std::string& key)
+    {
+        auto result = std::vector<std::uint64_t>{};
+        for (const auto& reading : persistence.getReadings(key, 1000))
+            result.emplace_back(reading->getTimestamp());
+        return result;
+    }
+};
+
+TEST_F(BoundedInMemoryPersistenceTests, PutGetRemoveReadings)
+{
+    BoundedInMemoryPersistence persistence;
+    EXPECT_TRUE(persistence.isEmpty());
+    EXPECT_TRUE(persistence.putReading("Device+T", makeReading(1)));
+    EXPECT_TRUE(persistence.putReading("Device+T", makeReading(2)));
+    EXPECT_TRUE(persistence.putReading("Device+H", Reading{"H", std::vector<std::string>{"1", "2"}, 3}));
+    EXPECT_FALSE(persistence.isEmpty());
+    EXPECT_EQ(persistence.getReadingsKeys().size(), 2u);
+    EXPECT_EQ(persistence.getReadingsCount(), 3u);
+    EXPECT_EQ(timestamps(persistence, "Device+T"), (std::vector<std::uint64_t>{1, 2}));
+
+    persistence.removeReadings("Device+T", 1);
+    EXPECT_EQ(timestamps(persistence, "Device+T"), (std::vector<std::uint64_t>{2}));
+    persistence.removeReadings("Device+T", 5);
+    persistence.removeReadings("Device+H", 1);
+    EXPECT_TRUE(persistence.getReadingsKeys().empty());
+    EXPECT_EQ(persistence.getReadingsCount(), 0u);
+    EXPECT_EQ(persistence.getReadingsSize(), 0u);
+    EXPECT_TRUE(persistence.m_fronts.empty());
+    EXPECT_TRUE(persistence.isEmpty());
+}
+
+TEST_F(BoundedInMemoryPersistenceTests, DropOldestEvictsAcrossFeeds)
+{
+    BoundedInMemoryPersistence persistence{0, 3, OverflowPolicy::DropOldest};
+    EXPECT_TRUE(persistence.putReading("Device+T", makeReading(1)));
+    EXPECT_TRUE(persistence.putReading("Device+H", makeReading(2)));
+    EXPECT_TRUE(persistence.putReading("Device+T", makeReading(3)));
+    EXPECT_TRUE(persistence.putReading("Device+H", makeReading(4)));
+    EXPECT_TRUE(persistence.putReading("Device+H", makeReading(5)));
+
+    EXPECT_EQ(timestamps(persistence, "Device+T"), (std::vector<std::uint64_t>{3}));
+    EXPECT_EQ(timestamps(persistence, "Device+H"), (std::vector<std::uint64_t>{4, 5}));
+    EXPECT_EQ(persistence.getReadingsCount(), 3u);
+    EXPECT_EQ(persistence.getEvictionCounters().droppedOldest, 2u);
+    EXPECT_EQ(persistence.getEvictionCounters().droppedNewest, 0u);
+}
+
+TEST_F(BoundedInMemoryPersistenceTests, DropNewestRejectsReadings)
+{
+    BoundedInMemoryPersistence persistence{0, 2, OverflowPolicy::DropNewest};
+    EXPECT_TRUE(persistence.putReading("Device+T", makeReading(1)));
+    EXPECT_TRUE(persistence.putReading("Device+T", makeReading(2)));
+    EXPECT_FALSE(persistence.putReading("Device+T", makeReading(3)));
+    EXPECT_EQ(timestamps(persistence, "Device+T"), (std::vector<std::uint64_t>{1, 2}));
+    EXPECT_EQ(persistence.getEvictionCounters().droppedNewest, 1u);
+
+    persistence.removeReadings("Device+T", 1);
+    EXPECT_TRUE(persistence.putReading("Device+T", makeReading(4)));
+    EXPECT_EQ(timestamps(persistence, "Device+T"), (std::vector<std::uint64_t>{2, 4}));
+}
+
+TEST_F(BoundedInMemoryPersistenceTests, DownsampleThinsTheLargestFeed)
+{
+    BoundedInMemoryPersistence persistence{0, 10, OverflowPolicy::Downsample};
+    EXPECT_TRUE(persistence.putReading("Device+H", makeReading(100)));
+    EXPECT_TRUE(persistence.putReading("Device+H", makeReading(101)));
+    for (auto i = std::uint64_t{1}; i <= 9; ++i)
+        EXPECT_TRUE(persistence.putReading("Device+T", makeReading(i)));
+
+    // The older half of the feed was thinned out, while the newest readings stayed
+    EXPECT_EQ(timestamps(persistence, "Device+T"), (std::vector<std::uint64_t>{1, 3, 5, 6, 7, 8, 9}));
+    EXPECT_EQ(timestamps(persistence, "Device+H"), (std::vector<std::uint64_t>{100, 101}));
+    EXPECT_EQ(persistence.getEvictionCounters().downsampled, 2u);
+    EXPECT_EQ(persistence.getEvictionCounters().droppedOldest, 0u);
+    EXPECT_EQ(persistence.getReadingsCount(), 9u);
+}
+
+TEST_F(BoundedInMemoryPersistenceTests, DownsampleFallsBackToDropOldest)
+{
+    BoundedInMemoryPersistence persistence{0, 2, OverflowPolicy::Downsample};
+    EXPECT_TRUE(persistence.putReading("Device+T", makeReading(1)));
+    EXPECT_TRUE(persistence.putReading("Device+H", makeReading(2)));
+    EXPECT_TRUE(persistence.putReading("Device+T", makeReading(3)));
+    EXPECT_EQ(timestamps(persistence, "Device+T"), (std::vector<std::uint64_t>{3}));
+    EXPECT_EQ(persistence.getEvictionCounters().droppedOldest, 1u);
+}
+
+TEST_F(BoundedInMemoryPersistenceTests, ByteCap)
+{
+    const auto size = BoundedInMemoryPersistence::estimateSize(makeReading(0)) + std::string{"Device+T"}.size();
+    BoundedInMemoryPersistence persistence{size * 3, 0, OverflowPolicy::DropOldest};
+    for (auto i = std::uint64_t{1}; i <= 5; ++i)
+        EXPECT_TRUE(persistence.putReading("Device+T", makeReading(i)));
+    EXPECT_EQ(timestamps(persistence, "Device+T"), (std::vector<std::uint64_t>{3, 4, 5}));
+    EXPECT_EQ(persistence.getReadingsSize(), size * 3);
+
+    // A reading that could never fit is rejected without evicting anything
+    EXPECT_FALSE(persistence.putReading("Device+T", Reading{"T", std::string(size * 4, 'a'), 6}));
+    EXPECT_EQ(persistence.getReadingsCount(), 3u);
+}
+
+TEST_F(BoundedInMemoryPersistenceTests, AttributesAndParameters)
+{
+    BoundedInMemoryPersistence persistence{1, 1};
+    EXPECT_TRUE(persistence.putAttribute("Device+A", std::make_shared<Attribute>("A", DataType::STRING, "Value")));
+    EXPECT_TRUE(persistence.putParameter("Device+P", Parameter{ParameterName::EXTERNAL_ID, "Value"}));
+    EXPECT_FALSE(persistence.isEmpty());
+    EXPECT_EQ(persistence.getAttributeKeys(), std::vector<std::string>{"Device+A"});
+    EXPECT_EQ(persistence.getAttributeUnderKey("Device+A")->getValue(), "Value");
+    EXPECT_EQ(persistence.getParameterForKey("Device+P").second, "Value");
+    persistence.removeAttributes();
+    persistence.removeParameters("Device+P");
+    EXPECT_TRUE(persistence.isEmpty());
+}
@@ -0,0 +1,135 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "wolk/service/data/CatchUpAggregator.h"
+
+#include <gtest/gtest.h>
+
+using namespace wolkabout;
+using namespace wolkabout::connect;
+using namespace ::testing;
+
+class CatchUpAggregatorTests : public ::testing::Test
+{
+public:
+    // Readings are old once they are more than 10 seconds older than this
+    static const std::uint64_t NOW = 100000;
+
+    void enable(AggregateFunction numeric = AggregateFunction::Average,
+                AggregateFunction text = AggregateFunction::Last)
+    {
+        aggregator.setPolicy(CatchUpPolicy{std::chrono::seconds{10}, std::chrono::seconds{1}, numeric, text});
+    }
+
+    static std::shared_ptr<Reading> makeReading(const std::string& value, std::uint64_t timestamp)
+    {
+        return std::make_shared<Reading>("T", value, timestamp);
+    }
+
+    std::vector<FoldedReading> fold(const std::vector<std::shared_ptr<Reading>>& readings) const
+    {
+        return aggregator.fold(readings, NOW);
+    }
+
+    CatchUpAggregator aggregator;
+};
+
+TEST_F(CatchUpAggregatorTests, DisabledKeepsEverything)
+{
+    EXPECT_FALSE(aggregator.getPolicy().isEnabled());
+    EXPECT_FALSE(CatchUpPolicy(std::chrono::seconds{10}).isEnabled());
+    const auto folded = fold({makeReading("1", 1000), makeReading("2", 1001)});
+    ASSERT_EQ(folded.size(), 2u);
+    EXPECT_EQ(folded[0].count, 1u);
+    EXPECT_EQ(folded[1].reading.getTimestamp(), 1001u);
+}
+
+TEST_F(CatchUpAggregatorTests, FoldsOldReadingsPerWindow)
+{
+    enable();
+    const auto folded = fold({makeReading("1", 1000), makeReading("2", 1500), makeReading("6", 1999),
+                              makeReading("5", 2000), makeReading("7", 95000), makeReading("8", 95001)});
+    ASSERT_EQ(folded.size(), 4u);
+    EXPECT_EQ(folded[0].reading.getStringValue(), "3");
+    EXPECT_EQ(folded[0].reading.getTimestamp(), 1000u);
+    EXPECT_EQ(folded[0].count, 3u);
+    EXPECT_EQ(folded[1].reading.getStringValue(), "5");
+    EXPECT_EQ(folded[1].count, 1u);
+
+    // The live readings are kept at full resolution
+    EXPECT_EQ(folded[2].reading.getTimestamp(), 95000u);
+    EXPECT_EQ(folded[3].reading.getTimestamp(), 95001u);
+}
+
+TEST_F(CatchUpAggregatorTests, NumericFunctions)
+{
+    const auto readings =
+      std::vector<std::shared_ptr<Reading>>{makeReading("4", 1100), makeReading("-2", 1200), makeReading("9", 1300)};
+
+    enable(AggregateFunction::Minimum);
+    EXPECT_EQ(fold(readings).front().reading.getStringValue(), "-2");
+    EXPECT_EQ(fold(readings).front().reading.getTimestamp(), 1200u);
+    enable(AggregateFunction::Maximum);
+    EXPECT_EQ(fold(readings).front().reading.getStringValue(), "9");
+    enable(AggregateFunction::Count);
+    EXPECT_EQ(fold(readings).front().reading.getStringValue(), "3");
+    EXPECT_EQ(fold(readings).front().reading.getTimestamp(), 1000u);
+    enable(AggregateFunction::First);
+    EXPECT_EQ(fold(readings).front().reading.getStringValue(), "4");
+    EXPECT_EQ(fold(readings).front().count, 3u);
+}
+
+TEST_F(CatchUpAggregatorTests, TextKeepsFirstOrLast)
+{
+    const auto readings = std::vector<std::shared_ptr<Reading>>{makeReading("ON", 1100), makeReading("12", 1200),
+                                                                makeReading("OFF", 1300)};
+
+    enable(AggregateFunction::Average, AggregateFunction::Last);
+    auto folded = fold(readings);
+    ASSERT_EQ(folded.size(), 1u);
+    EXPECT_EQ(folded.front().reading.getStringValue(), "OFF");
+    EXPECT_EQ(folded.front().reading.getTimestamp(), 1300u);
+    EXPECT_EQ(folded.front().count, 3u);
+
+    enable(AggregateFunction::Average, AggregateFunction::First);
+    EXPECT_EQ(fold(readings).front().reading.getStringValue(), "ON");
+
+    // Only first and last are used for text
+    EXPECT_EQ(CatchUpPolicy({}, {}, AggregateFunction::Average, AggregateFunction::Count).getTextFunction(),
+              AggregateFunction::Last);
+}
+
+TEST_F(CatchUpAggregatorTests, NeverFoldsMultiValueOrUnstampedReadings)
+{
+    enable();
+    const auto multiValue = std::make_shared<Reading>("T", std::vector<std::string>{"1", "2"}, 1200);
+    const auto folded =
+      fold({makeReading("1", 1100), multiValue, makeReading("3", 1300), makeReading("4", 0), makeReading("5", 0)});
+    ASSERT_EQ(folded.size(), 5u);
+    for (const auto& reading : folded)
+        EXPECT_EQ(reading.count, 1u);
+}
+
+TEST_F(CatchUpAggregatorTests, FoldableReadings)
+{
+    EXPECT_FALSE(aggregator.isFoldable(*makeReading("1", 1000), NOW));
+
+    enable();
+    EXPECT_TRUE(aggregator.isFoldable(*makeReading("1", 1000), NOW));
+    EXPECT_FALSE(aggregator.isFoldable(*makeReading("1", 95000), NOW));
+    EXPECT_FALSE(aggregator.isFoldable(*makeReading("1", 0), NOW));
+    EXPECT_FALSE(aggregator.isFoldable(Reading{"T", std::vector<std::string>{"1", "2"}, 1000}, NOW));
+}
@@ -0,0 +1,73 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/utilities/CommandQueue.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+using namespace wolkabout::connect;
+using namespace ::testing;
+
+TEST(CommandQueueTests, ExecutesCommandsInOrder)
+{
+    std::mutex mutex;
+    std::condition_variable condition;
+    auto order = std::vector<int>{};
+
+    CommandQueue queue;
+    for (auto i = 0; i < 10; ++i)
+        queue.pushCommand([&, i] {
+            std::lock_guard<std::mutex> lock{mutex};
+            order.emplace_back(i);
+            condition.notify_one();
+        });
+
+    std::unique_lock<std::mutex> lock{mutex};
+    condition.wait_for(lock, std::chrono::seconds{1}, [&] { return order.size() == 10; });
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+}
+
+TEST(CommandQueueTests, CommandsCanPushCommands)
+{
+    std::mutex mutex;
+    std::condition_variable condition;
+    auto done = false;
+
+    CommandQueue queue;
+    queue.pushCommand([&] {
+        queue.pushCommand([&] {
+            std::lock_guard<std::mutex> lock{mutex};
+            done = true;
+            condition.notify_one();
+        });
+    });
+
+    std::unique_lock<std::mutex> lock{mutex};
+    condition.wait_for(lock, std::chrono::seconds{1}, [&] { return done; });
+    EXPECT_TRUE(done);
+}
+
+TEST(CommandQueueTests, IgnoresEmptyTasks)
+{
+    CommandQueue queue;
+    ASSERT_NO_FATAL_FAILURE(queue.pushCommand(Task{}));
+}
@@ -0,0 +1,160 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/persistence/CompressedPersistence.h"
+#include "wolk/persistence/CompressedSegment.h"
+
+#include <gtest/gtest.h>
+
+using namespace wolkabout;
+using namespace wolkabout::connect;
+using namespace ::testing;
+
+class CompressedPersistenceTests : public ::testing::Test
+{
+public:
+    static std::vector<std::uint64_t> timestamps(Persistence& persistence, const std::string& key)
+    {
+        auto result = std::vector<std::uint64_t>{};
+        for (const auto& reading : persistence.getReadings(key, 1000))
+            result.emplace_back(reading->getTimestamp());
+        return result;
+    }
+
+    static std::vector<std::shared_ptr<Reading>> readAll(const CompressedSegment& segment)
+    {
+        auto readings = std::vector<std::shared_ptr<Reading>>{};
+        auto cursor = segment.begin();
+        while (auto reading = segment.read(cursor))
+            readings.emplace_back(std::move(reading));
+        return readings;
+    }
+};
+
+TEST_F(CompressedPersistenceTests, SegmentRoundTrip)
+{
+    const auto readings = std::vector<Reading>{
+      Reading{"T", "21.5", 1650000000000},
+      Reading{"T", "21.5", 1650000001000},
+      Reading{"T", "21.75", 1650000002000},
+      Reading{"T", "-3", 1650000002999},
+      Reading{"T", "12.50", 1650000004000},
+      Reading{"SW", "true", 1650000004000},
+      Reading{"T", "1e+20", 1000},
+      Reading{"T", "0.1", 1650000009000},
+      Reading{"T", "", 1650000009000},
+      Reading{"LOC", std::vector<std::string>{"45.2671", "19.8335"}, 18446744073709551615u},
+      Reading{"LOC", std::vector<std::string>{}, 0},
+      Reading{"SW", "true", 1650000012000},
+    };
+
+    auto segment = CompressedSegment{};
+    for (const auto& reading : readings)
+        ASSERT_TRUE(segment.append(reading));
+    ASSERT_EQ(segment.getCount(), readings.size());
+
+    // Everything is read back exactly as it was written, also after going through bytes
+    auto restored = CompressedSegment{};
+    ASSERT_TRUE(CompressedSegment::deserialize(segment.serialize(), restored));
+    for (const auto& current : {&segment, &restored})
+    {
+        const auto decoded = readAll(*current);
+        ASSERT_EQ(decoded.size(), readings.size());
+        for (auto i = std::size_t{0}; i < readings.size(); ++i)
+        {
+            EXPECT_EQ(decoded[i]->getReference(), readings[i].getReference());
+            EXPECT_EQ(decoded[i]->getStringValues(), readings[i].getStringValues());
+            EXPECT_EQ(decoded[i]->getTimestamp(), readings[i].getTimestamp());
+        }
+    }
+
+    // The segment read back can be appended to
+    ASSERT_TRUE(restored.append(Reading{"T", "22", 1650000013000}));
+    EXPECT_EQ(readAll(restored).back()->getStringValue(), "22");
+}
+
+TEST_F(CompressedPersistenceTests, SegmentRejectsInvalidBytes)
+{
+    auto segment = CompressedSegment{};
+    ASSERT_TRUE(segment.append(Reading{"T", "1", 1}));
+    auto bytes = segment.serialize();
+    auto restored = CompressedSegment{};
+    EXPECT_FALSE(CompressedSegment::deserialize({}, restored));
+    bytes.pop_back();
+    EXPECT_FALSE(CompressedSegment::deserialize(bytes, restored));
+
+    segment.seal();
+    EXPECT_FALSE(segment.append(Reading{"T", "2", 2}));
+}
+
+TEST_F(CompressedPersistenceTests, SegmentIsCompact)
+{
+    // A day of a regularly sampled temperature feed
+    auto segment = CompressedSegment{};
+    for (auto i = std::uint64_t{0}; i < 8640; ++i)
+        ASSERT_TRUE(segment.append(Reading{"T", std::to_string(20 + (i / 60) % 10), 1650000000000 + i * 10000}));
+    EXPECT_LT(segment.getSize(), 8640u * 4);
+}
+
+TEST_F(CompressedPersistenceTests, PutGetRemoveReadings)
+{
+    CompressedPersistence persistence{4};
+    EXPECT_TRUE(persistence.isEmpty());
+    for (auto i = std::uint64_t{1}; i <= 10; ++i)
+        EXPECT_TRUE(persistence.putReading("Device+T", Reading{"T", std::to_string(i), i}));
+    EXPECT_TRUE(persistence.putReading("Device+H", Reading{"H", "OFF", 11}));
+    EXPECT_EQ(persistence.getReadingsKeys().size(), 2u);
+    EXPECT_EQ(persistence.getReadingsCount(), 11u);
+    EXPECT_GT(persistence.getReadingsSize(), 0u);
+
+    EXPECT_EQ(timestamps(persistence, "Device+T"), (std::vector<std::uint64_t>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10}));
+    const auto readings = persistence.getReadings("Device+T", 2);
+    ASSERT_EQ(readings.size(), 2u);
+    EXPECT_EQ(readings.back()->getStringValue(), "2");
+
+    // Removing across segment boundaries
+    persistence.removeReadings("Device+T", 3);
+    EXPECT_EQ(timestamps(persistence, "Device+T"), (std::vector<std::uint64_t>{4, 5, 6, 7, 8, 9, 10}));
+    persistence.removeReadings("Device+T", 5);
+    EXPECT_EQ(timestamps(persistence, "Device+T"), (std::vector<std::uint64_t>{9, 10}));
+    EXPECT_EQ(persistence.getReadingsCount(), 3u);
+
+    EXPECT_TRUE(persistence.putReading("Device+T", Reading{"T", "11", 11}));
+    persistence.removeReadings("Device+T", 2);
+    EXPECT_EQ(timestamps(persistence, "Device+T"), (std::vector<std::uint64_t>{11}));
+    persistence.removeReadings("Device+T", 5);
+    persistence.removeReadings("Device+H", 1);
+    EXPECT_TRUE(persistence.getReadingsKeys().empty());
+    EXPECT_TRUE(persistence.isEmpty());
+
+    // A feed that was drained starts over
+    EXPECT_TRUE(persistence.putReading("Device+T", Reading{"T", "12", 12}));
+    EXPECT_EQ(timestamps(persistence, "Device+T"), (std::vector<std::uint64_t>{12}));
+}
+
+TEST_F(CompressedPersistenceTests, AttributesAndParameters)
+{
+    CompressedPersistence persistence;
+    EXPECT_TRUE(persistence.putAttribute("Device+A", std::make_shared<Attribute>("A", DataType::STRING, "Value")));
+    EXPECT_TRUE(persistence.putParameter("Device+P", Parameter{ParameterName::EXTERNAL_ID, "Value"}));
+    EXPECT_FALSE(persistence.isEmpty());
+    EXPECT_EQ(persistence.getAttributeUnderKey("Device+A")->getValue(), "Value");
+    EXPECT_EQ(persistence.getParameterKeys(), std::vector<std::string>{"Device+P"});
+    persistence.removeAttributes("Device+A");
+    persistence.removeParameters();
+    EXPECT_TRUE(persistence.isEmpty());
+}
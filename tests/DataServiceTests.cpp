@@ -16,6 +16,7 @@
 
 #include <any>
 #include <sstream>
+#include <thread>
 #include <utility>
 
 #define private public
@@ -32,6 +33,7 @@
 #include "tests/mocks/OutboundMessageHandlerMock.h"
 #include "tests/mocks/OutboundRetryMessageHandlerMock.h"
 #include "tests/mocks/PersistenceMock.h"
+#include "wolk/persistence/BoundedInMemoryPersistence.h"
 
 #include <gtest/gtest.h>
 
@@ -159,6 +161,219 @@ TEST_F(DataServiceTests, PublishReadingsHappyFlow)
     ASSERT_NO_FATAL_FAILURE(service->publishReadingsForPersistenceKey(DEVICE_KEY + "+" + "T"));
 }
 
+TEST_F(DataServiceTests, PublishReadingsYieldsWhenBudgetIsExhausted)
+{
+    EXPECT_CALL(*persistenceMock, getReadingsKeys).WillOnce(Return(std::vector<std::string>{DEVICE_KEY + "+T"}));
+    EXPECT_CALL(*persistenceMock, getReadings)
+      .WillOnce(Return(std::vector<std::shared_ptr<Reading>>{std::make_shared<Reading>("T", "TestValue", 123456789)}));
+    EXPECT_CALL(*persistenceMock, removeReadings).Times(1);
+    EXPECT_CALL(*dataProtocolMock, makeOutboundMessage(A<const std::string&>(), A<FeedValuesMessage>()))
+      .WillOnce(Return(ByMove(std::unique_ptr<wolkabout::Message>{new wolkabout::Message{"", ""}})));
+    EXPECT_CALL(*connectivityServiceMock, publish).WillOnce(Return(true));
+
+    auto budget = PublishBudget{1};
+    EXPECT_TRUE(service->publishReadings(budget));
+    EXPECT_EQ(budget.getSpentMessages(), 1);
+    EXPECT_FALSE(budget.hasFailed());
+}
+
+TEST_F(DataServiceTests, PublishReadingsStopsWhenPublishFails)
+{
+    EXPECT_CALL(*persistenceMock, getReadingsKeys).WillOnce(Return(std::vector<std::string>{DEVICE_KEY + "+T"}));
+    EXPECT_CALL(*persistenceMock, getReadings)
+      .WillOnce(Return(std::vector<std::shared_ptr<Reading>>{std::make_shared<Reading>("T", "TestValue", 123456789)}));
+    EXPECT_CALL(*persistenceMock, removeReadings).Times(0);
+    EXPECT_CALL(*dataProtocolMock, makeOutboundMessage(A<const std::string&>(), A<FeedValuesMessage>()))
+      .WillOnce(Return(ByMove(std::unique_ptr<wolkabout::Message>{new wolkabout::Message{"", ""}})));
+    EXPECT_CALL(*connectivityServiceMock, publish).WillOnce(Return(false));
+
+    auto budget = PublishBudget{};
+    EXPECT_FALSE(service->publishReadings(budget));
+    EXPECT_TRUE(budget.hasFailed());
+}
+
+TEST_F(DataServiceTests, PublishReadingsYieldsWhenRateLimited)
+{
+    service->setRateLimiter(RateLimiter{1});
+    EXPECT_CALL(*persistenceMock, getReadingsKeys).WillOnce(Return(std::vector<std::string>{DEVICE_KEY + "+T"}));
+    EXPECT_CALL(*persistenceMock, getReadings)
+      .WillOnce(Return(std::vector<std::shared_ptr<Reading>>{std::make_shared<Reading>("T", "TestValue", 123456789)}));
+    EXPECT_CALL(*persistenceMock, removeReadings).Times(1);
+    EXPECT_CALL(*dataProtocolMock, makeOutboundMessage(A<const std::string&>(), A<FeedValuesMessage>()))
+      .WillOnce(Return(ByMove(std::unique_ptr<wolkabout::Message>{new wolkabout::Message{"", ""}})));
+    EXPECT_CALL(*connectivityServiceMock, publish).WillOnce(Return(true));
+
+    auto budget = PublishBudget{};
+    EXPECT_TRUE(service->publishReadings(budget));
+    EXPECT_GT(service->getRateLimitDelay().count(), 0);
+    EXPECT_EQ(service->getRateLimiterMetrics().publishedMessages, 1);
+    EXPECT_EQ(service->getRateLimiterMetrics().throttled, 1);
+}
+
+TEST_F(DataServiceTests, PublishReadingsKeepsThemUntilDelivered)
+{
+    service->setInFlightWindow(1);
+    EXPECT_CALL(*persistenceMock, getReadingsKeys).WillOnce(Return(std::vector<std::string>{DEVICE_KEY + "+T"}));
+    EXPECT_CALL(*persistenceMock, getReadings(DEVICE_KEY + "+T", 50))
+      .WillOnce(Return(std::vector<std::shared_ptr<Reading>>{std::make_shared<Reading>("T", "TestValue", 123456789)}));
+    EXPECT_CALL(*dataProtocolMock, makeOutboundMessage(A<const std::string&>(), A<FeedValuesMessage>()))
+      .WillOnce(Return(ByMove(std::unique_ptr<wolkabout::Message>{new wolkabout::Message{"", ""}})));
+    auto published = std::shared_ptr<wolkabout::Message>{};
+    EXPECT_CALL(*connectivityServiceMock, publish).WillOnce(DoAll(SaveArg<0>(&published), Return(true)));
+
+    // The window is full, and the readings are not removed before the delivery
+    EXPECT_CALL(*persistenceMock, removeReadings).Times(0);
+    auto budget = PublishBudget{};
+    EXPECT_TRUE(service->publishReadings(budget));
+    EXPECT_TRUE(service->isInFlightWindowFull());
+    ASSERT_NE(published, nullptr);
+    Mock::VerifyAndClearExpectations(persistenceMock.get());
+
+    EXPECT_CALL(*persistenceMock, getReadings(DEVICE_KEY + "+T", 1))
+      .WillOnce(Return(std::vector<std::shared_ptr<Reading>>{std::make_shared<Reading>("T", "TestValue", 123456789)}));
+    EXPECT_CALL(*persistenceMock, removeReadings(DEVICE_KEY + "+T", 1)).Times(1);
+    service->notifyDelivered(published);
+    EXPECT_FALSE(service->isInFlightWindowFull());
+}
+
+TEST_F(DataServiceTests, PublishReadingsInFlightWhilePersistenceEvicts)
+{
+    // Set up a persistence that keeps only three readings, and drops the oldest ones
+    BoundedInMemoryPersistence persistence{0, 3, OverflowPolicy::DropOldest};
+    DataService evictingService{*dataProtocolMock,
+                                persistence,
+                                *connectivityServiceMock,
+                                *outboundRetryMessageHandlerMock,
+                                _internalFeedUpdateSetHandler,
+                                _internalParameterSyncHandler,
+                                _internalDetailsSyncHandler};
+    evictingService.setInFlightWindow(4);
+    auto publishedTimestamps = std::vector<std::uint64_t>{};
+    EXPECT_CALL(*dataProtocolMock, makeOutboundMessage(A<const std::string&>(), A<FeedValuesMessage>()))
+      .Times(2)
+      .WillRepeatedly([&](const std::string&, FeedValuesMessage message) {
+          for (const auto& readings : message.getReadings())
+              publishedTimestamps.emplace_back(readings.first);
+          return std::unique_ptr<wolkabout::Message>{new wolkabout::Message{"", ""}};
+      });
+    auto published = std::vector<std::shared_ptr<wolkabout::Message>>{};
+    EXPECT_CALL(*connectivityServiceMock, publish)
+      .Times(2)
+      .WillRepeatedly([&](std::shared_ptr<wolkabout::Message> message) {
+          published.emplace_back(message);
+          return true;
+      });
+    const auto key = DEVICE_KEY + "+T";
+    const auto storedTimestamps = [&] {
+        auto timestamps = std::vector<std::uint64_t>{};
+        for (const auto& reading : persistence.getReadings(key, 10))
+            timestamps.emplace_back(reading->getTimestamp());
+        return timestamps;
+    };
+
+    // Publish the first readings, and let the persistence evict two of them while they are in flight
+    for (auto timestamp = std::uint64_t{1}; timestamp <= 3; ++timestamp)
+        persistence.putReading(key, Reading{"T", "TestValue", timestamp});
+    ASSERT_NO_FATAL_FAILURE(evictingService.publishReadingsForPersistenceKey(key));
+    for (auto timestamp = std::uint64_t{4}; timestamp <= 5; ++timestamp)
+        persistence.putReading(key, Reading{"T", "TestValue", timestamp});
+
+    // Only the readings that were not published yet go out next
+    ASSERT_NO_FATAL_FAILURE(evictingService.publishReadingsForPersistenceKey(key));
+    EXPECT_EQ(publishedTimestamps, (std::vector<std::uint64_t>{1, 2, 3, 4, 5}));
+    ASSERT_EQ(published.size(), 2);
+
+    // Confirming the first batch removes only its reading that was left, and none of the newer ones
+    evictingService.notifyDelivered(published[0]);
+    EXPECT_EQ(storedTimestamps(), (std::vector<std::uint64_t>{4, 5}));
+    evictingService.notifyDelivered(published[1]);
+    EXPECT_TRUE(storedTimestamps().empty());
+}
+
+TEST_F(DataServiceTests, PublishReadingsOfUnstampedBatch)
+{
+    // Set up a persistence holding the readings, and record the values that are published
+    BoundedInMemoryPersistence persistence;
+    DataService batchService{*dataProtocolMock,
+                             persistence,
+                             *connectivityServiceMock,
+                             *outboundRetryMessageHandlerMock,
+                             _internalFeedUpdateSetHandler,
+                             _internalParameterSyncHandler,
+                             _internalDetailsSyncHandler};
+    auto publishedValues = std::vector<std::string>{};
+    EXPECT_CALL(*dataProtocolMock, makeOutboundMessage(A<const std::string&>(), A<FeedValuesMessage>()))
+      .Times(2)
+      .WillRepeatedly([&](const std::string&, FeedValuesMessage message) {
+          for (const auto& readings : message.getReadings())
+              for (const auto& reading : readings.second)
+                  publishedValues.emplace_back(reading.getStringValue());
+          return std::unique_ptr<wolkabout::Message>{new wolkabout::Message{"", ""}};
+      });
+    EXPECT_CALL(*connectivityServiceMock, publish).Times(2).WillRepeatedly(Return(true));
+    const auto key = DEVICE_KEY + "+T";
+
+    // The samples of the batch all get the same timestamp, and none of them is lost
+    auto batch = ReadingBatch{"T", std::vector<std::uint64_t>{1, 2, 3}};
+    batch.stamp(1000);
+    ASSERT_NO_FATAL_FAILURE(batchService.addReadings(DEVICE_KEY, batch));
+    ASSERT_NO_FATAL_FAILURE(batchService.publishReadingsForPersistenceKey(key));
+    EXPECT_EQ(publishedValues, (std::vector<std::string>{"1", "2", "3"}));
+    EXPECT_TRUE(persistence.getReadings(key, 10).empty());
+
+    // The reorder buffer keeps them as well, and only drops the repeated sample
+    publishedValues.clear();
+    batchService.setReorderLateness(std::chrono::milliseconds{1});
+    batch = ReadingBatch{"T", std::vector<std::uint64_t>{4, 5, 5}};
+    batch.stamp(2000);
+    ASSERT_NO_FATAL_FAILURE(batchService.addReadings(DEVICE_KEY, batch));
+    std::this_thread::sleep_for(std::chrono::milliseconds{2});
+    ASSERT_NO_FATAL_FAILURE(batchService.publishReadings());
+    EXPECT_EQ(publishedValues, (std::vector<std::string>{"4", "5"}));
+    EXPECT_TRUE(persistence.getReadings(key, 10).empty());
+}
+
+TEST_F(DataServiceTests, PublishReadingsAgainAfterRequeue)
+{
+    service->setInFlightWindow(4);
+    EXPECT_CALL(*persistenceMock, getReadings(DEVICE_KEY + "+T", 50))
+      .Times(2)
+      .WillRepeatedly(
+        Return(std::vector<std::shared_ptr<Reading>>{std::make_shared<Reading>("T", "TestValue", 123456789)}));
+    EXPECT_CALL(*persistenceMock, getReadings(DEVICE_KEY + "+T", 51))
+      .Times(2)
+      .WillRepeatedly(
+        Return(std::vector<std::shared_ptr<Reading>>{std::make_shared<Reading>("T", "TestValue", 123456789)}));
+    EXPECT_CALL(*persistenceMock, removeReadings).Times(0);
+    EXPECT_CALL(*dataProtocolMock, makeOutboundMessage(A<const std::string&>(), A<FeedValuesMessage>()))
+      .WillOnce(Return(ByMove(std::unique_ptr<wolkabout::Message>{new wolkabout::Message{"", ""}})))
+      .WillOnce(Return(ByMove(std::unique_ptr<wolkabout::Message>{new wolkabout::Message{"", ""}})));
+    EXPECT_CALL(*connectivityServiceMock, publish).Times(2).WillRepeatedly(Return(true));
+
+    // The reading in flight is skipped, and after the connection is lost, it is published again
+    ASSERT_NO_FATAL_FAILURE(service->publishReadingsForPersistenceKey(DEVICE_KEY + "+T"));
+    service->requeueInFlight();
+    ASSERT_NO_FATAL_FAILURE(service->publishReadingsForPersistenceKey(DEVICE_KEY + "+T"));
+}
+
+TEST_F(DataServiceTests, PublishReadingsHigherPriorityFirst)
+{
+    service->setFeedPriority("LL", FeedPriority::Critical);
+    EXPECT_CALL(*persistenceMock, getReadingsKeys)
+      .WillOnce(Return(std::vector<std::string>{DEVICE_KEY + "+T", DEVICE_KEY + "+LL"}));
+    EXPECT_CALL(*persistenceMock, getReadings(DEVICE_KEY + "+T", _)).Times(0);
+    EXPECT_CALL(*persistenceMock, getReadings(DEVICE_KEY + "+LL", _))
+      .WillOnce(Return(std::vector<std::shared_ptr<Reading>>{std::make_shared<Reading>("LL", "DEBUG", 123456789)}));
+    EXPECT_CALL(*persistenceMock, removeReadings(DEVICE_KEY + "+LL", 1)).Times(1);
+    EXPECT_CALL(*dataProtocolMock, makeOutboundMessage(A<const std::string&>(), A<FeedValuesMessage>()))
+      .WillOnce(Return(ByMove(std::unique_ptr<wolkabout::Message>{new wolkabout::Message{"", ""}})));
+    EXPECT_CALL(*connectivityServiceMock, publish).WillOnce(Return(true));
+
+    auto budget = PublishBudget{1};
+    EXPECT_TRUE(service->publishReadings(budget));
+    EXPECT_EQ(service->getFeedPriority("T"), FeedPriority::Normal);
+}
+
 TEST_F(DataServiceTests, CheckIfSubscriptionExistButItsEmpty)
 {
     ASSERT_FALSE(service->checkIfSubscriptionIsWaiting(ParametersUpdateMessage{{}}));
@@ -170,10 +385,10 @@ TEST_F(DataServiceTests, CheckIfSubscriptionExistTwoSubscription)
     service->m_parameterSubscriptions.emplace(
       0, DataService::ParameterSubscription{
            {ParameterName::FIRMWARE_UPDATE_REPOSITORY, ParameterName::FIRMWARE_UPDATE_CHECK_TIME},
-           [](const std::vector<Parameter>&) {}});
+           [](const std::vector<Parameter>&) {}, nullptr});
     service->m_parameterSubscriptions.emplace(
       1, DataService::ParameterSubscription{{ParameterName::FILE_TRANSFER_PLATFORM_ENABLED},
-                                            [](const std::vector<Parameter>&) {}});
+                                            [](const std::vector<Parameter>&) {}, nullptr});
     std::atomic_bool callbackCalled{false};
     std::mutex mutex;
     std::condition_variable conditionVariable;
@@ -181,7 +396,8 @@ TEST_F(DataServiceTests, CheckIfSubscriptionExistTwoSubscription)
       2, DataService::ParameterSubscription{{ParameterName::EXTERNAL_ID}, [&](const std::vector<Parameter>&) {
                                                 callbackCalled = true;
                                                 conditionVariable.notify_one();
-                                            }});
+                                            },
+                                            nullptr});
 
     // Now parse the subscription
     ASSERT_TRUE(
@@ -231,6 +447,33 @@ TEST_F(DataServiceTests, AddReadingMultiStringReading)
     ASSERT_NO_FATAL_FAILURE(service->addReading(DEVICE_KEY, "T", {"Value1", "Value2", "Value3"}, 1234567890));
 }
 
+TEST_F(DataServiceTests, AddReadingNumericValue)
+{
+    EXPECT_CALL(*persistenceMock, putReading(DEVICE_KEY + "+" + "T", _))
+      .WillOnce([&](const std::string&, const Reading& reading) {
+          EXPECT_EQ(reading.getReference(), "T");
+          EXPECT_EQ(reading.getStringValue(), "42");
+          EXPECT_EQ(reading.getTimestamp(), 1234567890u);
+          return true;
+      });
+    ASSERT_NO_FATAL_FAILURE(service->addReading(DEVICE_KEY, "T", ReadingValue{42}, 1234567890));
+}
+
+TEST_F(DataServiceTests, AddReadingsBatch)
+{
+    auto timestamps = std::vector<std::uint64_t>{};
+    EXPECT_CALL(*persistenceMock, putReading(DEVICE_KEY + "+" + "T", _))
+      .Times(3)
+      .WillRepeatedly([&](const std::string&, const Reading& reading) {
+          EXPECT_EQ(reading.getReference(), "T");
+          timestamps.emplace_back(reading.getTimestamp());
+          return true;
+      });
+    ASSERT_NO_FATAL_FAILURE(service->addReadings(
+      DEVICE_KEY, ReadingBatch{"T", std::vector<std::uint64_t>{123, 456, 789}, {1234567890, 1234567891, 1234567892}}));
+    EXPECT_EQ(timestamps, (std::vector<std::uint64_t>{1234567890, 1234567891, 1234567892}));
+}
+
 TEST_F(DataServiceTests, AddReading)
 {
     EXPECT_CALL(*persistenceMock, putReading).Times(1);
@@ -246,6 +489,27 @@ TEST_F(DataServiceTests, AddReadings)
                                                             {"T", std::uint64_t{789}, 1234567892}}));
 }
 
+TEST_F(DataServiceTests, AddReadingFilteredByReportingPolicy)
+{
+    service->setReportingPolicy("T", ReportingPolicy::absoluteDeadband(1));
+    EXPECT_CALL(*persistenceMock, putReading(DEVICE_KEY + "+T", _)).Times(2);
+    ASSERT_NO_FATAL_FAILURE(service->addReading(DEVICE_KEY, "T", ReadingValue{20.0}, 1));
+    ASSERT_NO_FATAL_FAILURE(service->addReading(DEVICE_KEY, "T", "20.5", 2));
+    ASSERT_NO_FATAL_FAILURE(
+      service->addReadings(DEVICE_KEY, ReadingBatch{"T", std::vector<double>{20.2, 21.5}, {3, 4}}));
+}
+
+TEST_F(DataServiceTests, AddReadingHeldBackForReordering)
+{
+    service->setReorderLateness(std::chrono::hours{1});
+    EXPECT_CALL(*persistenceMock, putReading).Times(1);
+    ASSERT_NO_FATAL_FAILURE(service->addReading(DEVICE_KEY, "T", "2", 2000));
+    ASSERT_NO_FATAL_FAILURE(service->addReading(DEVICE_KEY, "T", "1", 1000));
+
+    // Readings without a timestamp are stored right away
+    ASSERT_NO_FATAL_FAILURE(service->addReading(DEVICE_KEY, "T", "3", 0));
+}
+
 TEST_F(DataServiceTests, AddAttribute)
 {
     EXPECT_CALL(*persistenceMock, putAttribute).Times(1);
@@ -259,6 +523,60 @@ TEST_F(DataServiceTests, UpdateParameter)
       service->updateParameter(DEVICE_KEY, Parameter{ParameterName::EXTERNAL_ID, "TestExternalId"}));
 }
 
+TEST_F(DataServiceTests, AddAttributeUnchangedIsSuppressed)
+{
+    EXPECT_CALL(*persistenceMock, getAttributes)
+      .WillOnce(Return(std::map<std::string, std::shared_ptr<Attribute>>{
+        {DEVICE_KEY + "+" + "T", std::make_shared<Attribute>("T", DataType::STRING, "TestValue")}}));
+    EXPECT_CALL(*dataProtocolMock, makeOutboundMessage(_, A<AttributeRegistrationMessage>()))
+      .WillOnce(Return(ByMove(std::unique_ptr<wolkabout::Message>{new wolkabout::Message{"", ""}})));
+    EXPECT_CALL(*connectivityServiceMock, publish).WillOnce(Return(true));
+    ASSERT_NO_FATAL_FAILURE(service->publishAttributes());
+
+    // The same value is not stored again, but a different one is
+    EXPECT_CALL(*persistenceMock, putAttribute).Times(1);
+    ASSERT_NO_FATAL_FAILURE(service->addAttribute(DEVICE_KEY, Attribute{"T", DataType::STRING, "TestValue"}));
+    ASSERT_NO_FATAL_FAILURE(service->addAttribute(DEVICE_KEY, Attribute{"T", DataType::STRING, "OtherValue"}));
+}
+
+TEST_F(DataServiceTests, PublishAttributesOnlyFetchesChangedKeys)
+{
+    EXPECT_CALL(*persistenceMock, getAttributes).WillOnce(Return(std::map<std::string, std::shared_ptr<Attribute>>()));
+    ASSERT_NO_FATAL_FAILURE(service->publishAttributes());
+
+    // After the first publish, only the keys that were added are looked up
+    EXPECT_CALL(*persistenceMock, putAttribute).Times(1);
+    ASSERT_NO_FATAL_FAILURE(service->addAttribute(DEVICE_KEY, Attribute{"T", DataType::STRING, "TestValue"}));
+    EXPECT_CALL(*persistenceMock, getAttributeUnderKey(DEVICE_KEY + "+" + "T"))
+      .WillOnce(Return(std::make_shared<Attribute>("T", DataType::STRING, "TestValue")));
+    EXPECT_CALL(*persistenceMock, removeAttributes(DEVICE_KEY + "+" + "T")).Times(1);
+    EXPECT_CALL(*dataProtocolMock, makeOutboundMessage(DEVICE_KEY, A<AttributeRegistrationMessage>()))
+      .WillOnce(Return(ByMove(std::unique_ptr<wolkabout::Message>{new wolkabout::Message{"", ""}})));
+    EXPECT_CALL(*connectivityServiceMock, publish).WillOnce(Return(true));
+    ASSERT_NO_FATAL_FAILURE(service->publishAttributes());
+
+    // Nothing changed since, so nothing is fetched
+    ASSERT_NO_FATAL_FAILURE(service->publishAttributes());
+}
+
+TEST_F(DataServiceTests, UpdateParameterAfterPlatformChangeIsNotSuppressed)
+{
+    const auto parameter = Parameter{ParameterName::EXTERNAL_ID, "TestExternalId"};
+    EXPECT_CALL(*persistenceMock, getParameters)
+      .WillOnce(Return(std::map<std::string, Parameter>{{DEVICE_KEY + "+" + toString(parameter.first), parameter}}));
+    EXPECT_CALL(*dataProtocolMock, makeOutboundMessage(_, A<ParametersUpdateMessage>()))
+      .WillOnce(Return(ByMove(std::unique_ptr<wolkabout::Message>{new wolkabout::Message{"", ""}})));
+    EXPECT_CALL(*connectivityServiceMock, publish).WillOnce(Return(true));
+    ASSERT_NO_FATAL_FAILURE(service->publishParameters());
+
+    EXPECT_CALL(*persistenceMock, putParameter).Times(1);
+    ASSERT_NO_FATAL_FAILURE(service->updateParameter(DEVICE_KEY, parameter));
+
+    // The platform now has another value, so the previous one needs to be sent again
+    service->rememberPlatformParameters(DEVICE_KEY, {Parameter{ParameterName::EXTERNAL_ID, "PlatformValue"}});
+    ASSERT_NO_FATAL_FAILURE(service->updateParameter(DEVICE_KEY, parameter));
+}
+
 TEST_F(DataServiceTests, RegisterSingleFeedTest)
 {
     auto feed = Feed{"Test Feed", "T", FeedType::IN_OUT, Unit::AMPERE};
@@ -267,7 +585,9 @@ TEST_F(DataServiceTests, RegisterSingleFeedTest)
           return std::unique_ptr<wolkabout::Message>{new wolkabout::Message{"", ""}};
       });
     EXPECT_CALL(*connectivityServiceMock, publish).WillOnce(Return(true));
-    ASSERT_NO_FATAL_FAILURE(service->registerFeed(DEVICE_KEY, feed));
+    auto registered = false;
+    ASSERT_NO_FATAL_FAILURE(registered = service->registerFeed(DEVICE_KEY, feed));
+    EXPECT_TRUE(registered);
 }
 
 TEST_F(DataServiceTests, RegisterSingleFeedTestFailsToPublish)
@@ -278,7 +598,9 @@ TEST_F(DataServiceTests, RegisterSingleFeedTestFailsToPublish)
           return std::unique_ptr<wolkabout::Message>{new wolkabout::Message{"", ""}};
       });
     EXPECT_CALL(*connectivityServiceMock, publish).WillOnce(Return(false));
-    ASSERT_NO_FATAL_FAILURE(service->registerFeed(DEVICE_KEY, feed));
+    auto registered = true;
+    ASSERT_NO_FATAL_FAILURE(registered = service->registerFeed(DEVICE_KEY, feed));
+    EXPECT_FALSE(registered);
 }
 
 TEST_F(DataServiceTests, RegisterSingleFeedTestFailsToParse)
@@ -287,7 +609,9 @@ TEST_F(DataServiceTests, RegisterSingleFeedTestFailsToParse)
     EXPECT_CALL(*dataProtocolMock, makeOutboundMessage(_, A<FeedRegistrationMessage>()))
       .WillOnce([&](const std::string&, const FeedRegistrationMessage&) { return nullptr; });
     EXPECT_CALL(*connectivityServiceMock, publish).Times(0);
-    ASSERT_NO_FATAL_FAILURE(service->registerFeed(DEVICE_KEY, feed));
+    auto registered = true;
+    ASSERT_NO_FATAL_FAILURE(registered = service->registerFeed(DEVICE_KEY, feed));
+    EXPECT_FALSE(registered);
 }
 
 TEST_F(DataServiceTests, RemoveSingleFeedTest)
@@ -380,8 +704,37 @@ TEST_F(DataServiceTests, SynchronizeParametersTest)
       .WillOnce([&](const std::string&, const SynchronizeParametersMessage&) {
           return std::unique_ptr<wolkabout::Message>{new wolkabout::Message{"", ""}};
       });
-    EXPECT_CALL(*connectivityServiceMock, publish).WillOnce(Return(true));
-    ASSERT_NO_FATAL_FAILURE(service->synchronizeParameters(DEVICE_KEY, {}, [](const std::vector<Parameter>&) {}));
+    EXPECT_CALL(*connectivityServiceMock, publish).Times(0);
+    EXPECT_CALL(*dataProtocolMock, getResponseChannelForMessage(MessageType::SYNCHRONIZE_PARAMETERS, DEVICE_KEY))
+      .Times(1);
+    EXPECT_CALL(*outboundRetryMessageHandlerMock, addMessage).Times(1);
+    EXPECT_TRUE(service->synchronizeParameters(DEVICE_KEY, {}, [](const std::vector<Parameter>&) {}));
+    EXPECT_EQ(service->m_parameterSubscriptions.size(), 1u);
+}
+
+TEST_F(DataServiceTests, SynchronizeParametersTimesOut)
+{
+    std::mutex mutex;
+    std::condition_variable conditionVariable;
+    auto timedOut = false;
+    EXPECT_CALL(*dataProtocolMock, makeOutboundMessage(_, A<SynchronizeParametersMessage>()))
+      .WillOnce([&](const std::string&, const SynchronizeParametersMessage&) {
+          return std::unique_ptr<wolkabout::Message>{new wolkabout::Message{"", ""}};
+      });
+    EXPECT_CALL(*outboundRetryMessageHandlerMock, addMessage)
+      .WillOnce([&](const RetryMessageStruct& retryMessageStruct) { retryMessageStruct.onFail({}); });
+    EXPECT_TRUE(service->synchronizeParameters(
+      DEVICE_KEY, {ParameterName::EXTERNAL_ID}, [](const std::vector<Parameter>&) { FAIL(); },
+      [&] {
+          std::lock_guard<std::mutex> lock{mutex};
+          timedOut = true;
+          conditionVariable.notify_one();
+      }));
+
+    // The subscription is gone, and its caller is told the request timed out
+    std::unique_lock<std::mutex> lock{mutex};
+    EXPECT_TRUE(conditionVariable.wait_for(lock, std::chrono::seconds{1}, [&] { return timedOut; }));
+    EXPECT_TRUE(service->m_parameterSubscriptions.empty());
 }
 
 TEST_F(DataServiceTests, SynchronizeParametersTestFailsToPublish)
@@ -391,7 +744,7 @@ TEST_F(DataServiceTests, SynchronizeParametersTestFailsToPublish)
           return std::unique_ptr<wolkabout::Message>{new wolkabout::Message{"", ""}};
       });
     EXPECT_CALL(*connectivityServiceMock, publish).WillOnce(Return(false));
-    ASSERT_NO_FATAL_FAILURE(service->synchronizeParameters(DEVICE_KEY, {}, [](const std::vector<Parameter>&) {}));
+    EXPECT_FALSE(service->synchronizeParameters(DEVICE_KEY, {}, nullptr));
 }
 
 TEST_F(DataServiceTests, SynchronizeParametersTestFailsToParse)
@@ -430,6 +783,127 @@ TEST_F(DataServiceTests, PublishReadings)
     ASSERT_NO_FATAL_FAILURE(service->publishReadings(DEVICE_KEY));
 }
 
+TEST_F(DataServiceTests, PublishReadingsForDeviceOnlyVisitsItsFeeds)
+{
+    EXPECT_CALL(*persistenceMock, getReadingsKeys)
+      .WillOnce(Return(std::vector<std::string>{DEVICE_KEY + "+T", "OtherDevice+T"}));
+    EXPECT_CALL(*persistenceMock, getReadings("OtherDevice+T", _)).Times(0);
+    EXPECT_CALL(*persistenceMock, getReadings(DEVICE_KEY + "+T", _))
+      .WillOnce(Return(std::vector<std::shared_ptr<Reading>>{std::make_shared<Reading>("T", "TestValue", 123456789)}))
+      .WillOnce(Return(std::vector<std::shared_ptr<Reading>>{}));
+    EXPECT_CALL(*persistenceMock, removeReadings(DEVICE_KEY + "+T", 1)).Times(1);
+    EXPECT_CALL(*dataProtocolMock, makeOutboundMessage(DEVICE_KEY, A<FeedValuesMessage>()))
+      .WillOnce(Return(ByMove(std::unique_ptr<wolkabout::Message>{new wolkabout::Message{"", ""}})));
+    EXPECT_CALL(*connectivityServiceMock, publish).WillOnce(Return(true));
+    ASSERT_NO_FATAL_FAILURE(service->publishReadings(DEVICE_KEY));
+
+    // The drained feed is no longer indexed, and the persistence is not listed again
+    EXPECT_EQ(service->m_index.count(DataKind::Readings, service->m_keys.internDevice(DEVICE_KEY)), 0u);
+    ASSERT_NO_FATAL_FAILURE(service->publishReadings(DEVICE_KEY));
+}
+
+TEST_F(DataServiceTests, PublishReadingsBatchedAcrossFeeds)
+{
+    service->setReadingsBatching(true);
+    EXPECT_CALL(*persistenceMock, getReadingsKeys)
+      .WillOnce(Return(std::vector<std::string>{DEVICE_KEY + "+T", DEVICE_KEY + "+H"}));
+    EXPECT_CALL(*persistenceMock, getReadings(DEVICE_KEY + "+T", _))
+      .WillOnce(Return(std::vector<std::shared_ptr<Reading>>{std::make_shared<Reading>("T", "TestValue", 123456789)}));
+    EXPECT_CALL(*persistenceMock, getReadings(DEVICE_KEY + "+H", _))
+      .WillOnce(Return(std::vector<std::shared_ptr<Reading>>{std::make_shared<Reading>("H", "TestValue", 123456789)}));
+    EXPECT_CALL(*persistenceMock, removeReadings(_, 1)).Times(2);
+    EXPECT_CALL(*dataProtocolMock, makeOutboundMessage(DEVICE_KEY, A<FeedValuesMessage>()))
+      .WillOnce([&](const std::string&, const FeedValuesMessage& message) {
+          EXPECT_EQ(message.getReadings().at(123456789).size(), 2u);
+          return std::unique_ptr<wolkabout::Message>{new wolkabout::Message{"", ""}};
+      });
+    EXPECT_CALL(*connectivityServiceMock, publish).WillOnce(Return(true));
+    ASSERT_NO_FATAL_FAILURE(service->publishReadings());
+}
+
+TEST_F(DataServiceTests, PublishReadingsBatchedSplitsOnPayloadSize)
+{
+    service->setReadingsBatching(true, 1);
+    EXPECT_CALL(*persistenceMock, getReadingsKeys)
+      .WillOnce(Return(std::vector<std::string>{DEVICE_KEY + "+T", DEVICE_KEY + "+H"}));
+    EXPECT_CALL(*persistenceMock, getReadings(DEVICE_KEY + "+T", _))
+      .WillOnce(Return(std::vector<std::shared_ptr<Reading>>{std::make_shared<Reading>("T", "TestValue", 123456789)}));
+    EXPECT_CALL(*persistenceMock, getReadings(DEVICE_KEY + "+H", _))
+      .WillOnce(Return(std::vector<std::shared_ptr<Reading>>{std::make_shared<Reading>("H", "TestValue", 123456789)}))
+      .WillOnce(Return(std::vector<std::shared_ptr<Reading>>{std::make_shared<Reading>("H", "TestValue", 123456789)}));
+    EXPECT_CALL(*persistenceMock, removeReadings(_, 1)).Times(2);
+    EXPECT_CALL(*dataProtocolMock, makeOutboundMessage(DEVICE_KEY, A<FeedValuesMessage>()))
+      .Times(2)
+      .WillRepeatedly([&](const std::string&, const FeedValuesMessage&) {
+          return std::unique_ptr<wolkabout::Message>{new wolkabout::Message{"", ""}};
+      });
+    EXPECT_CALL(*connectivityServiceMock, publish).Times(2).WillRepeatedly(Return(true));
+    ASSERT_NO_FATAL_FAILURE(service->publishReadings());
+}
+
+TEST_F(DataServiceTests, PublishReadingsCatchesUpOldReadings)
+{
+    service->setCatchUpPolicy(CatchUpPolicy{std::chrono::hours{1}, std::chrono::minutes{1}});
+    const auto now = static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+        .count());
+    EXPECT_CALL(*persistenceMock, getReadingsKeys).WillOnce(Return(std::vector<std::string>{DEVICE_KEY + "+T"}));
+    EXPECT_CALL(*persistenceMock, getReadings(DEVICE_KEY + "+T", 50))
+      .WillOnce(Return(std::vector<std::shared_ptr<Reading>>{
+        std::make_shared<Reading>("T", "1", 60000), std::make_shared<Reading>("T", "2", 61000),
+        std::make_shared<Reading>("T", "3", 62000), std::make_shared<Reading>("T", "4", now)}))
+      .WillOnce(Return(std::vector<std::shared_ptr<Reading>>{}));
+    EXPECT_CALL(*persistenceMock, removeReadings(DEVICE_KEY + "+T", 4)).Times(1);
+    EXPECT_CALL(*dataProtocolMock, makeOutboundMessage(DEVICE_KEY, A<FeedValuesMessage>()))
+      .WillOnce([&](const std::string&, const FeedValuesMessage& message) {
+          // The old readings are folded into their average, while the live one is sent as it is
+          EXPECT_EQ(message.getReadings().size(), 2u);
+          EXPECT_EQ(message.getReadings().count(60000), 1u);
+          EXPECT_EQ(message.getReadings().count(now), 1u);
+          return std::unique_ptr<wolkabout::Message>{new wolkabout::Message{"", ""}};
+      });
+    EXPECT_CALL(*connectivityServiceMock, publish).WillOnce(Return(true));
+    ASSERT_NO_FATAL_FAILURE(service->publishReadings());
+}
+
+TEST_F(DataServiceTests, PublishReadingsCatchingUpReadsFurtherOnlyForOldReadings)
+{
+    service->setCatchUpPolicy(CatchUpPolicy{std::chrono::hours{1}, std::chrono::minutes{1}});
+    const auto now = static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+        .count());
+    auto live = std::vector<std::shared_ptr<Reading>>{};
+    auto old = std::vector<std::shared_ptr<Reading>>{};
+    for (auto i = std::uint64_t{0}; i < 60; ++i)
+    {
+        live.emplace_back(std::make_shared<Reading>("T", std::to_string(i), now + i));
+        old.emplace_back(std::make_shared<Reading>("H", std::to_string(i), 60000 + i));
+    }
+
+    // The live readings are published as they are, so a message worth of them is all that is read
+    EXPECT_CALL(*persistenceMock, getReadings(DEVICE_KEY + "+T", Ne(50u))).Times(0);
+    EXPECT_CALL(*persistenceMock, getReadings(DEVICE_KEY + "+T", 50))
+      .WillOnce(Return(std::vector<std::shared_ptr<Reading>>{live.begin(), live.begin() + 50}))
+      .WillOnce(Return(std::vector<std::shared_ptr<Reading>>{live.begin() + 50, live.end()}))
+      .WillOnce(Return(std::vector<std::shared_ptr<Reading>>{}));
+
+    // The old ones fold into a single window, that is read further until it is complete
+    EXPECT_CALL(*persistenceMock, getReadings(DEVICE_KEY + "+H", 50))
+      .WillOnce(Return(std::vector<std::shared_ptr<Reading>>{old.begin(), old.begin() + 50}))
+      .WillOnce(Return(std::vector<std::shared_ptr<Reading>>{}));
+    EXPECT_CALL(*persistenceMock, getReadings(DEVICE_KEY + "+H", 1000)).WillOnce(Return(old));
+    EXPECT_CALL(*persistenceMock, removeReadings(DEVICE_KEY + "+T", 50)).Times(1);
+    EXPECT_CALL(*persistenceMock, removeReadings(DEVICE_KEY + "+T", 10)).Times(1);
+    EXPECT_CALL(*persistenceMock, removeReadings(DEVICE_KEY + "+H", 60)).Times(1);
+    EXPECT_CALL(*dataProtocolMock, makeOutboundMessage(DEVICE_KEY, A<FeedValuesMessage>()))
+      .WillRepeatedly([&](const std::string&, const FeedValuesMessage&) {
+          return std::unique_ptr<wolkabout::Message>{new wolkabout::Message{"", ""}};
+      });
+    EXPECT_CALL(*connectivityServiceMock, publish).WillRepeatedly(Return(true));
+    ASSERT_NO_FATAL_FAILURE(service->publishReadingsForPersistenceKey(DEVICE_KEY + "+T"));
+    ASSERT_NO_FATAL_FAILURE(service->publishReadingsForPersistenceKey(DEVICE_KEY + "+H"));
+}
+
 TEST_F(DataServiceTests, PublishAttributesNoAttributes)
 {
     EXPECT_CALL(*persistenceMock, getAttributes).WillOnce(Return(std::map<std::string, std::shared_ptr<Attribute>>()));
@@ -470,15 +944,16 @@ TEST_F(DataServiceTests, PublishAttributesHappyFlow)
 
 TEST_F(DataServiceTests, PublishAttributesForDeviceNoAttributes)
 {
-    EXPECT_CALL(*persistenceMock, getAttributes).WillOnce(Return(std::map<std::string, std::shared_ptr<Attribute>>()));
+    EXPECT_CALL(*persistenceMock, getAttributeKeys).WillOnce(Return(std::vector<std::string>{}));
+    EXPECT_CALL(*persistenceMock, getAttributeUnderKey).Times(0);
     ASSERT_NO_FATAL_FAILURE(service->publishAttributes(DEVICE_KEY));
 }
 
 TEST_F(DataServiceTests, PublishAttributesForDeviceFailsToParse)
 {
-    EXPECT_CALL(*persistenceMock, getAttributes)
-      .WillOnce(Return(std::map<std::string, std::shared_ptr<Attribute>>{
-        {DEVICE_KEY + "+" + "T", std::make_shared<Attribute>("T", DataType::STRING, "TestValue")}}));
+    EXPECT_CALL(*persistenceMock, getAttributeKeys).WillOnce(Return(std::vector<std::string>{DEVICE_KEY + "+" + "T"}));
+    EXPECT_CALL(*persistenceMock, getAttributeUnderKey(DEVICE_KEY + "+" + "T"))
+      .WillOnce(Return(std::make_shared<Attribute>("T", DataType::STRING, "TestValue")));
     EXPECT_CALL(*dataProtocolMock, makeOutboundMessage(_, A<AttributeRegistrationMessage>()))
       .WillOnce(Return(ByMove(nullptr)));
     ASSERT_NO_FATAL_FAILURE(service->publishAttributes(DEVICE_KEY));
@@ -486,9 +961,9 @@ TEST_F(DataServiceTests, PublishAttributesForDeviceFailsToParse)
 
 TEST_F(DataServiceTests, PublishAttributesForDeviceFailsToPublish)
 {
-    EXPECT_CALL(*persistenceMock, getAttributes)
-      .WillOnce(Return(std::map<std::string, std::shared_ptr<Attribute>>{
-        {DEVICE_KEY + "+" + "T", std::make_shared<Attribute>("T", DataType::STRING, "TestValue")}}));
+    EXPECT_CALL(*persistenceMock, getAttributeKeys).WillOnce(Return(std::vector<std::string>{DEVICE_KEY + "+" + "T"}));
+    EXPECT_CALL(*persistenceMock, getAttributeUnderKey(DEVICE_KEY + "+" + "T"))
+      .WillOnce(Return(std::make_shared<Attribute>("T", DataType::STRING, "TestValue")));
     EXPECT_CALL(*dataProtocolMock, makeOutboundMessage(_, A<AttributeRegistrationMessage>()))
       .WillOnce(Return(ByMove(std::unique_ptr<wolkabout::Message>{new wolkabout::Message{"", ""}})));
     EXPECT_CALL(*connectivityServiceMock, publish).WillOnce(Return(false));
@@ -497,9 +972,9 @@ TEST_F(DataServiceTests, PublishAttributesForDeviceFailsToPublish)
 
 TEST_F(DataServiceTests, PublishAttributesForDeviceHappyFlow)
 {
-    EXPECT_CALL(*persistenceMock, getAttributes)
-      .WillOnce(Return(std::map<std::string, std::shared_ptr<Attribute>>{
-        {DEVICE_KEY + "+" + "T", std::make_shared<Attribute>("T", DataType::STRING, "TestValue")}}));
+    EXPECT_CALL(*persistenceMock, getAttributeKeys).WillOnce(Return(std::vector<std::string>{DEVICE_KEY + "+" + "T"}));
+    EXPECT_CALL(*persistenceMock, getAttributeUnderKey(DEVICE_KEY + "+" + "T"))
+      .WillOnce(Return(std::make_shared<Attribute>("T", DataType::STRING, "TestValue")));
     EXPECT_CALL(*dataProtocolMock, makeOutboundMessage(_, A<AttributeRegistrationMessage>()))
       .WillOnce(Return(ByMove(std::unique_ptr<wolkabout::Message>{new wolkabout::Message{"", ""}})));
     EXPECT_CALL(*connectivityServiceMock, publish).WillOnce(Return(true));
@@ -546,15 +1021,17 @@ TEST_F(DataServiceTests, PublishParametersHappyFlow)
 
 TEST_F(DataServiceTests, PublishParametersForDeviceNoAttributes)
 {
-    EXPECT_CALL(*persistenceMock, getParameters).WillOnce(Return(std::map<std::string, Parameter>()));
+    EXPECT_CALL(*persistenceMock, getParameterKeys).WillOnce(Return(std::vector<std::string>{}));
+    EXPECT_CALL(*persistenceMock, getParameterForKey).Times(0);
     ASSERT_NO_FATAL_FAILURE(service->publishParameters(DEVICE_KEY));
 }
 
 TEST_F(DataServiceTests, PublishParametersForDeviceFailsToParse)
 {
-    EXPECT_CALL(*persistenceMock, getParameters)
-      .WillOnce(Return(std::map<std::string, Parameter>{
-        {DEVICE_KEY + "+" + "T", Parameter{ParameterName::EXTERNAL_ID, "TestExternalId"}}}));
+    const auto key = DEVICE_KEY + "+" + toString(ParameterName::EXTERNAL_ID);
+    EXPECT_CALL(*persistenceMock, getParameterKeys).WillOnce(Return(std::vector<std::string>{key}));
+    EXPECT_CALL(*persistenceMock, getParameterForKey(key))
+      .WillOnce(Return(Parameter{ParameterName::EXTERNAL_ID, "TestExternalId"}));
     EXPECT_CALL(*dataProtocolMock, makeOutboundMessage(_, A<ParametersUpdateMessage>()))
       .WillOnce(Return(ByMove(nullptr)));
     ASSERT_NO_FATAL_FAILURE(service->publishParameters(DEVICE_KEY));
@@ -562,9 +1039,10 @@ TEST_F(DataServiceTests, PublishParametersForDeviceFailsToParse)
 
 TEST_F(DataServiceTests, PublishParametersForDeviceFailsToPublish)
 {
-    EXPECT_CALL(*persistenceMock, getParameters)
-      .WillOnce(Return(std::map<std::string, Parameter>{
-        {DEVICE_KEY + "+" + "T", Parameter{ParameterName::EXTERNAL_ID, "TestExternalId"}}}));
+    const auto key = DEVICE_KEY + "+" + toString(ParameterName::EXTERNAL_ID);
+    EXPECT_CALL(*persistenceMock, getParameterKeys).WillOnce(Return(std::vector<std::string>{key}));
+    EXPECT_CALL(*persistenceMock, getParameterForKey(key))
+      .WillOnce(Return(Parameter{ParameterName::EXTERNAL_ID, "TestExternalId"}));
     EXPECT_CALL(*dataProtocolMock, makeOutboundMessage(_, A<ParametersUpdateMessage>()))
       .WillOnce(Return(ByMove(std::unique_ptr<wolkabout::Message>{new wolkabout::Message{"", ""}})));
     EXPECT_CALL(*connectivityServiceMock, publish).WillOnce(Return(false));
@@ -573,15 +1051,26 @@ TEST_F(DataServiceTests, PublishParametersForDeviceFailsToPublish)
 
 TEST_F(DataServiceTests, PublishParametersForDeviceHappyFlow)
 {
-    EXPECT_CALL(*persistenceMock, getParameters)
-      .WillOnce(Return(std::map<std::string, Parameter>{
-        {DEVICE_KEY + "+" + "T", Parameter{ParameterName::EXTERNAL_ID, "TestExternalId"}}}));
+    const auto key = DEVICE_KEY + "+" + toString(ParameterName::EXTERNAL_ID);
+    EXPECT_CALL(*persistenceMock, getParameterKeys).WillOnce(Return(std::vector<std::string>{key}));
+    EXPECT_CALL(*persistenceMock, getParameterForKey(key))
+      .WillOnce(Return(Parameter{ParameterName::EXTERNAL_ID, "TestExternalId"}));
     EXPECT_CALL(*dataProtocolMock, makeOutboundMessage(_, A<ParametersUpdateMessage>()))
       .WillOnce(Return(ByMove(std::unique_ptr<wolkabout::Message>{new wolkabout::Message{"", ""}})));
     EXPECT_CALL(*connectivityServiceMock, publish).WillOnce(Return(true));
     ASSERT_NO_FATAL_FAILURE(service->publishParameters(DEVICE_KEY));
 }
 
+TEST_F(DataServiceTests, PublishParametersForDeviceSkipsRemovedKeys)
+{
+    EXPECT_CALL(*persistenceMock, getParameterKeys)
+      .WillOnce(Return(std::vector<std::string>{DEVICE_KEY + "+" + toString(ParameterName::EXTERNAL_ID)}));
+    EXPECT_CALL(*persistenceMock, getParameterForKey).WillOnce(Return(Parameter{}));
+    EXPECT_CALL(*dataProtocolMock, makeOutboundMessage(_, A<ParametersUpdateMessage>())).Times(0);
+    ASSERT_NO_FATAL_FAILURE(service->publishParameters(DEVICE_KEY));
+    EXPECT_EQ(service->m_index.count(DataKind::Parameters, service->m_keys.internDevice(DEVICE_KEY)), 0u);
+}
+
 TEST_F(DataServiceTests, MessageReceivedMessageIsNull)
 {
     EXPECT_CALL(*dataProtocolMock, getDeviceKey).Times(0);
@@ -696,7 +1185,8 @@ TEST_F(DataServiceTests, MessageReceivedMessageParameterHappyFlowAnswersSubscrip
                                                  callbackCalled = true;
                                                  conditionVariable.notify_one();
                                              }
-                                         }});
+                                         },
+                                         nullptr});
 
     ASSERT_NO_FATAL_FAILURE(service->messageReceived(std::make_shared<wolkabout::Message>("", "")));
     if (!callbackCalled)
@@ -0,0 +1,106 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/service/data/DeviceIndex.h"
+
+#include <gtest/gtest.h>
+
+using namespace wolkabout::connect;
+using namespace ::testing;
+
+TEST(DeviceIndexTests, KeysAreGroupedByDevice)
+{
+    KeyInterner interner{"+"};
+    DeviceIndex index;
+    const auto& temperature = interner.intern("DeviceKey", "T");
+    const auto& humidity = interner.intern("DeviceKey", "H");
+    const auto& other = interner.intern("OtherDevice", "T");
+    index.add(DataKind::Readings, temperature);
+    index.add(DataKind::Readings, humidity);
+    index.add(DataKind::Readings, other);
+
+    EXPECT_EQ(index.get(DataKind::Readings, temperature.deviceId), (std::vector<FeedId>{temperature.id, humidity.id}));
+    EXPECT_EQ(index.get(DataKind::Readings, other.deviceId), std::vector<FeedId>{other.id});
+    EXPECT_EQ(index.count(DataKind::Readings, temperature.deviceId), 2u);
+}
+
+TEST(DeviceIndexTests, KindsAreKeptApart)
+{
+    KeyInterner interner{"+"};
+    DeviceIndex index;
+    const auto& key = interner.intern("DeviceKey", "T");
+    index.add(DataKind::Attributes, key);
+
+    EXPECT_EQ(index.count(DataKind::Attributes, key.deviceId), 1u);
+    EXPECT_EQ(index.count(DataKind::Readings, key.deviceId), 0u);
+    EXPECT_EQ(index.count(DataKind::Parameters, key.deviceId), 0u);
+}
+
+TEST(DeviceIndexTests, AddingTwiceKeepsOneEntry)
+{
+    KeyInterner interner{"+"};
+    DeviceIndex index;
+    const auto& key = interner.intern("DeviceKey", "T");
+    index.add(DataKind::Readings, key);
+    index.add(DataKind::Readings, key);
+    EXPECT_EQ(index.count(DataKind::Readings, key.deviceId), 1u);
+}
+
+TEST(DeviceIndexTests, RemoveKey)
+{
+    KeyInterner interner{"+"};
+    DeviceIndex index;
+    const auto& key = interner.intern("DeviceKey", "T");
+    ASSERT_NO_FATAL_FAILURE(index.remove(DataKind::Readings, key));
+    index.add(DataKind::Readings, key);
+    index.remove(DataKind::Readings, key);
+    EXPECT_TRUE(index.get(DataKind::Readings, key.deviceId).empty());
+}
+
+TEST(DeviceIndexTests, UnknownDevice)
+{
+    DeviceIndex index;
+    EXPECT_TRUE(index.get(DataKind::Readings, 42).empty());
+    EXPECT_EQ(index.count(DataKind::Readings, 42), 0u);
+}
+
+TEST(DeviceIndexTests, SeededPerKind)
+{
+    DeviceIndex index;
+    EXPECT_FALSE(index.isSeeded(DataKind::Readings));
+    index.markSeeded(DataKind::Readings);
+    EXPECT_TRUE(index.isSeeded(DataKind::Readings));
+    EXPECT_FALSE(index.isSeeded(DataKind::Attributes));
+    EXPECT_FALSE(index.isSeeded(DataKind::Parameters));
+}
+
+TEST(DeviceIndexTests, ContainsAndDevicesWithKeys)
+{
+    KeyInterner interner{"+"};
+    DeviceIndex index;
+    const auto& key = interner.intern("DeviceKey", "T");
+    const auto& other = interner.intern("OtherDevice", "T");
+    index.add(DataKind::Attributes, key);
+    index.add(DataKind::Attributes, other);
+    index.remove(DataKind::Attributes, other);
+
+    EXPECT_TRUE(index.contains(DataKind::Attributes, key));
+    EXPECT_FALSE(index.contains(DataKind::Parameters, key));
+    EXPECT_FALSE(index.contains(DataKind::Attributes, other));
+    EXPECT_EQ(index.getDevices(DataKind::Attributes), std::vector<DeviceId>{key.deviceId});
+    EXPECT_TRUE(index.getDevices(DataKind::Readings).empty());
+}
@@ -30,6 +30,7 @@
 #include "core/utilities/Logger.h"
 #include "core/utilities/Timer.h"
 #include "tests/mocks/FileDownloaderMock.h"
+#include "wolk/utilities/CommandQueue.h"
 
 #include <gtest/gtest.h>
 
@@ -51,7 +52,7 @@ public:
 
     const std::string FILE_NAME = "test.file";
 
-    CommandBuffer commandBuffer;
+    CommandQueue commandBuffer;
 
     std::mutex mutex;
 
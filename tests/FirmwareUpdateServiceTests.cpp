@@ -258,7 +258,7 @@ TEST_F(FirmwareUpdateServiceTests, ObtainParametersHappyFlow)
     EXPECT_CALL(GetFirmwareParametersListenerReference(), receiveParameters("TestRepository", "TestTime")).Times(1);
     EXPECT_CALL(dataServiceMock, synchronizeParameters)
       .WillOnce([&](const std::string&, const std::vector<ParameterName>&,
-                    std::function<void(std::vector<Parameter>)> callback) {
+                    std::function<void(std::vector<Parameter>)> callback, std::function<void()>) {
           callback({{ParameterName::FIRMWARE_UPDATE_REPOSITORY, "TestRepository"},
                     {ParameterName::FIRMWARE_UPDATE_CHECK_TIME, "TestTime"}});
           return true;
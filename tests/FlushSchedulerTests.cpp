@@ -0,0 +1,141 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#define private public
+#define protected public
+#include "wolk/service/data/FlushScheduler.h"
+#undef private
+#undef protected
+
+#include "core/utilities/Logger.h"
+#include "wolk/utilities/SharedExecutor.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+
+using namespace wolkabout;
+using namespace wolkabout::connect;
+using namespace ::testing;
+
+class FlushSchedulerTests : public ::testing::Test
+{
+public:
+    static void SetUpTestCase() { Logger::init(LogLevel::TRACE, Logger::Type::CONSOLE); }
+
+    void makeScheduler(FlushPolicy policy)
+    {
+        scheduler = std::unique_ptr<FlushScheduler>{new FlushScheduler{policy, [this] { ++flushes; }}};
+        scheduler->m_running = true;
+    }
+
+    std::atomic<int> flushes{0};
+    std::unique_ptr<FlushScheduler> scheduler;
+};
+
+TEST_F(FlushSchedulerTests, DisabledPolicy)
+{
+    EXPECT_FALSE(FlushPolicy{}.isEnabled());
+    EXPECT_TRUE(FlushPolicy{10}.isEnabled());
+    EXPECT_TRUE((FlushPolicy{0, std::chrono::milliseconds{100}}.isEnabled()));
+}
+
+TEST_F(FlushSchedulerTests, CheckPeriod)
+{
+    EXPECT_EQ(FlushPolicy{10}.getCheckPeriod(), std::chrono::milliseconds{1000});
+    EXPECT_EQ((FlushPolicy{0, std::chrono::milliseconds{500}}.getCheckPeriod()), std::chrono::milliseconds{250});
+    EXPECT_EQ((FlushPolicy{0, std::chrono::milliseconds{0}, std::chrono::milliseconds{4}}.getCheckPeriod()),
+              std::chrono::milliseconds{10});
+}
+
+TEST_F(FlushSchedulerTests, NotRunningDoesNotFlush)
+{
+    makeScheduler(FlushPolicy{2});
+    scheduler->m_running = false;
+    scheduler->notifyBuffered(5);
+    EXPECT_EQ(flushes, 0);
+}
+
+TEST_F(FlushSchedulerTests, FlushesOnCount)
+{
+    makeScheduler(FlushPolicy{3});
+    scheduler->notifyBuffered();
+    scheduler->notifyBuffered();
+    EXPECT_EQ(flushes, 0);
+    scheduler->notifyBuffered();
+    EXPECT_EQ(flushes, 1);
+    EXPECT_EQ(scheduler->m_buffered, 0u);
+}
+
+TEST_F(FlushSchedulerTests, CoalescesWhileFlushIsScheduled)
+{
+    makeScheduler(FlushPolicy{1});
+    scheduler->notifyBuffered();
+    scheduler->notifyBuffered();
+    scheduler->notifyBuffered();
+    EXPECT_EQ(flushes, 1);
+
+    scheduler->notifyFlushStarted();
+    scheduler->notifyBuffered();
+    EXPECT_EQ(flushes, 2);
+}
+
+TEST_F(FlushSchedulerTests, FlushesOnAge)
+{
+    makeScheduler(FlushPolicy{0, std::chrono::milliseconds{100}});
+    scheduler->notifyBuffered();
+    const auto oldest = scheduler->m_oldest;
+    EXPECT_FALSE(scheduler->evaluate(oldest + std::chrono::milliseconds{50}));
+    EXPECT_TRUE(scheduler->evaluate(oldest + std::chrono::milliseconds{100}));
+}
+
+TEST_F(FlushSchedulerTests, IntervalIsMinimumBetweenFlushes)
+{
+    makeScheduler(FlushPolicy{1, std::chrono::milliseconds{0}, std::chrono::milliseconds{1000}});
+    scheduler->notifyBuffered();
+    EXPECT_EQ(flushes, 1);
+    scheduler->notifyFlushStarted();
+
+    // The count is reached again, but the interval did not pass
+    scheduler->notifyBuffered();
+    EXPECT_EQ(flushes, 1);
+    const auto lastFlush = scheduler->m_lastFlush;
+    EXPECT_FALSE(scheduler->evaluate(lastFlush + std::chrono::milliseconds{500}));
+    EXPECT_TRUE(scheduler->evaluate(lastFlush + std::chrono::milliseconds{1000}));
+}
+
+TEST_F(FlushSchedulerTests, NothingBufferedDoesNotFlush)
+{
+    makeScheduler(FlushPolicy{0, std::chrono::milliseconds{0}, std::chrono::milliseconds{100}});
+    EXPECT_FALSE(scheduler->evaluate(std::chrono::steady_clock::now()));
+}
+
+TEST_F(FlushSchedulerTests, ChecksOnTheGivenTimer)
+{
+    SharedExecutor executor{1};
+    scheduler = std::unique_ptr<FlushScheduler>{
+      new FlushScheduler{FlushPolicy{0, std::chrono::milliseconds{20}}, [this] { ++flushes; }, executor.makeTimer()}};
+    scheduler->start();
+    scheduler->notifyBuffered();
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{1};
+    while (flushes == 0 && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    scheduler->stop();
+    EXPECT_EQ(flushes, 1);
+}
@@ -0,0 +1,128 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/service/data/InFlightWindow.h"
+
+#include <gtest/gtest.h>
+
+using namespace wolkabout::connect;
+using namespace ::testing;
+
+namespace
+{
+std::vector<std::shared_ptr<wolkabout::Reading>> makeReadings(std::uint64_t firstTimestamp, std::uint64_t count)
+{
+    auto readings = std::vector<std::shared_ptr<wolkabout::Reading>>{};
+    for (auto timestamp = firstTimestamp; timestamp < firstTimestamp + count; ++timestamp)
+        readings.emplace_back(std::make_shared<wolkabout::Reading>("T", "TestValue", timestamp));
+    return readings;
+}
+}    // namespace
+
+TEST(InFlightWindowTests, DefaultIsDisabled)
+{
+    const auto window = InFlightWindow{};
+    EXPECT_FALSE(window.isEnabled());
+    EXPECT_FALSE(window.isFull());
+}
+
+TEST(InFlightWindowTests, ReadingsInFlightAreSkipped)
+{
+    auto window = InFlightWindow{2};
+    const auto first = std::make_shared<wolkabout::Message>("", "");
+    const auto second = std::make_shared<wolkabout::Message>("", "");
+    EXPECT_TRUE(window.add(first, {{"D+T", makeReadings(1, 3)}, {"D+H", makeReadings(1, 1)}}).empty());
+    EXPECT_FALSE(window.isFull());
+    EXPECT_TRUE(window.add(second, {{"D+T", makeReadings(4, 2)}}).empty());
+    EXPECT_TRUE(window.isFull());
+    EXPECT_EQ(window.getInFlight("D+T"), 5);
+    EXPECT_EQ(window.getInFlight("D+H"), 1);
+    EXPECT_EQ(window.getInFlight("D+P"), 0);
+}
+
+TEST(InFlightWindowTests, CommitsInOrder)
+{
+    auto window = InFlightWindow{4};
+    const auto first = std::make_shared<wolkabout::Message>("", "");
+    const auto second = std::make_shared<wolkabout::Message>("", "");
+    window.add(first, {{"D+T", makeReadings(1, 3)}});
+    window.add(second, {{"D+T", makeReadings(4, 2)}});
+
+    // The second batch waits for the first one
+    EXPECT_TRUE(window.confirm(second));
+    EXPECT_TRUE(window.getCommittableKeys().empty());
+    EXPECT_TRUE(window.commit().empty());
+    EXPECT_EQ(window.getInFlight("D+T"), 5);
+    EXPECT_TRUE(window.confirm(first));
+    EXPECT_EQ(window.getCommittableKeys(), std::vector<std::string>{"D+T"});
+    const auto committed = window.commit();
+    ASSERT_EQ(committed.size(), 2);
+    EXPECT_EQ(committed[0].second, 3);
+    EXPECT_EQ(committed[1].second, 2);
+    EXPECT_EQ(window.getSize(), 0);
+    EXPECT_EQ(window.getInFlight("D+T"), 0);
+
+    // Unknown messages change nothing
+    EXPECT_FALSE(window.confirm(first));
+}
+
+TEST(InFlightWindowTests, BatchWithoutMessageIsConfirmed)
+{
+    auto window = InFlightWindow{4};
+    EXPECT_EQ(window.add(nullptr, {{"D+T", makeReadings(1, 1)}}).size(), 1);
+
+    const auto message = std::make_shared<wolkabout::Message>("", "");
+    window.add(message, {{"D+T", makeReadings(2, 2)}});
+    EXPECT_TRUE(window.add(nullptr, {{"D+T", makeReadings(4, 1)}}).empty());
+    EXPECT_TRUE(window.confirm(message));
+    EXPECT_EQ(window.commit().size(), 2);
+}
+
+TEST(InFlightWindowTests, AlignForgetsEvictedReadings)
+{
+    auto window = InFlightWindow{4};
+    const auto first = std::make_shared<wolkabout::Message>("", "");
+    const auto second = std::make_shared<wolkabout::Message>("", "");
+    window.add(first, {{"D+T", makeReadings(1, 2)}});
+    window.add(second, {{"D+T", makeReadings(3, 2)}});
+
+    // Nothing was evicted
+    EXPECT_EQ(window.align("D+T", makeReadings(1, 6)), 4);
+    EXPECT_EQ(window.getInFlight("D+T"), 4);
+
+    // The persistence evicted three readings, so only one of the second batch is left at the front
+    EXPECT_EQ(window.align("D+T", makeReadings(4, 3)), 1);
+    EXPECT_EQ(window.getInFlight("D+T"), 1);
+    window.confirm(first);
+    EXPECT_TRUE(window.commit().empty());
+    window.confirm(second);
+    const auto committed = window.commit();
+    ASSERT_EQ(committed.size(), 1);
+    EXPECT_EQ(committed[0].second, 1);
+
+    // Unknown keys have nothing in flight
+    EXPECT_EQ(window.align("D+H", makeReadings(1, 1)), 0);
+}
+
+TEST(InFlightWindowTests, RequeueForgetsTheBatches)
+{
+    auto window = InFlightWindow{1};
+    window.add(std::make_shared<wolkabout::Message>("", ""), {{"D+T", makeReadings(1, 3)}});
+    EXPECT_EQ(window.requeue(), 1);
+    EXPECT_FALSE(window.isFull());
+    EXPECT_EQ(window.getInFlight("D+T"), 0);
+}
@@ -0,0 +1,81 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/service/data/KeyInterner.h"
+
+#include <gtest/gtest.h>
+
+using namespace wolkabout::connect;
+using namespace ::testing;
+
+TEST(KeyInternerTests, InternBuildsPersistenceKey)
+{
+    KeyInterner interner{"+"};
+    const auto& key = interner.intern("DeviceKey", "T");
+    EXPECT_EQ(key.deviceKey, "DeviceKey");
+    EXPECT_EQ(key.reference, "T");
+    EXPECT_EQ(key.persistenceKey, "DeviceKey+T");
+    EXPECT_EQ(interner.size(), 1u);
+}
+
+TEST(KeyInternerTests, InternReturnsSameEntry)
+{
+    KeyInterner interner{"+"};
+    const auto& first = interner.intern("DeviceKey", "T");
+    const auto& second = interner.intern("DeviceKey", "T");
+    EXPECT_EQ(&first, &second);
+    EXPECT_EQ(interner.size(), 1u);
+}
+
+TEST(KeyInternerTests, DevicesShareIdentifier)
+{
+    KeyInterner interner{"+"};
+    const auto& temperature = interner.intern("DeviceKey", "T");
+    const auto& humidity = interner.intern("DeviceKey", "H");
+    const auto& other = interner.intern("OtherDevice", "T");
+    EXPECT_NE(temperature.id, humidity.id);
+    EXPECT_EQ(temperature.deviceId, humidity.deviceId);
+    EXPECT_NE(temperature.deviceId, other.deviceId);
+    EXPECT_EQ(interner.internDevice("DeviceKey"), temperature.deviceId);
+}
+
+TEST(KeyInternerTests, ResolveKnownKey)
+{
+    KeyInterner interner{"+"};
+    const auto& key = interner.intern("DeviceKey", "T");
+    EXPECT_EQ(interner.resolve("DeviceKey+T"), &key);
+}
+
+TEST(KeyInternerTests, ResolveUnknownKey)
+{
+    KeyInterner interner{"+"};
+    const auto key = interner.resolve("DeviceKey+T");
+    ASSERT_NE(key, nullptr);
+    EXPECT_EQ(key->deviceKey, "DeviceKey");
+    EXPECT_EQ(key->reference, "T");
+    EXPECT_EQ(&interner.intern("DeviceKey", "T"), key);
+    EXPECT_EQ(interner.get(key->id), key);
+}
+
+TEST(KeyInternerTests, ResolveInvalidKey)
+{
+    KeyInterner interner{"+"};
+    EXPECT_EQ(interner.resolve("DeviceKey"), nullptr);
+    EXPECT_EQ(interner.resolve("+T"), nullptr);
+    EXPECT_EQ(interner.get(0), nullptr);
+    EXPECT_EQ(interner.size(), 0u);
+}
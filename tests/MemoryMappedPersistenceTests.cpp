@@ -0,0 +1,208 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#define private public
+#define protected public
+#include "wolk/persistence/MemoryMappedPersistence.h"
+#undef private
+#undef protected
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+
+using namespace wolkabout;
+using namespace wolkabout::connect;
+using namespace ::testing;
+
+class MemoryMappedPersistenceTests : public ::testing::Test
+{
+public:
+    void SetUp() override { std::remove(PATH.c_str()); }
+
+    void TearDown() override { std::remove(PATH.c_str()); }
+
+    // Every reading takes up 64 bytes, so a segment of 4096 bytes holds 63 of them
+    static std::unique_ptr<MemoryMappedPersistence> open(std::uint32_t segmentCount = 4)
+    {
+        return std::unique_ptr<MemoryMappedPersistence>{new MemoryMappedPersistence{PATH, segmentCount, 4096}};
+    }
+
+    static Reading makeReading(std::uint64_t timestamp) { return Reading{"T", "12.500000000000000000000", timestamp}; }
+
+    static const std::string PATH;
+};
+
+const std::string MemoryMappedPersistenceTests::PATH = "./MemoryMappedPersistenceTests.bin";
+
+TEST_F(MemoryMappedPersistenceTests, FailsToOpen)
+{
+    EXPECT_THROW(MemoryMappedPersistence("./missing-directory/persistence.bin"), std::runtime_error);
+}
+
+TEST_F(MemoryMappedPersistenceTests, PutGetRemoveReadings)
+{
+    auto persistence = open();
+    EXPECT_TRUE(persistence->isEmpty());
+    EXPECT_TRUE(persistence->putReading("Device+T", makeReading(1)));
+    EXPECT_TRUE(persistence->putReading("Device+T", makeReading(2)));
+    EXPECT_TRUE(persistence->putReading("Device+H", Reading{"H", std::vector<std::string>{"1", "2"}, 3}));
+    EXPECT_FALSE(persistence->isEmpty());
+    EXPECT_EQ(persistence->getReadingsKeys().size(), 2u);
+
+    auto readings = persistence->getReadings("Device+T", 5);
+    ASSERT_EQ(readings.size(), 2u);
+    EXPECT_EQ(readings.front()->getReference(), "T");
+    EXPECT_EQ(readings.front()->getStringValue(), "12.500000000000000000000");
+    EXPECT_EQ(readings.front()->getTimestamp(), 1u);
+    EXPECT_EQ(readings.back()->getTimestamp(), 2u);
+    readings = persistence->getReadings("Device+H", 5);
+    ASSERT_EQ(readings.size(), 1u);
+    EXPECT_EQ(readings.front()->getStringValues(), (std::vector<std::string>{"1", "2"}));
+
+    persistence->removeReadings("Device+T", 1);
+    readings = persistence->getReadings("Device+T", 5);
+    ASSERT_EQ(readings.size(), 1u);
+    EXPECT_EQ(readings.front()->getTimestamp(), 2u);
+    persistence->removeReadings("Device+T", 5);
+    persistence->removeReadings("Device+H", 5);
+    EXPECT_TRUE(persistence->getReadingsKeys().empty());
+    EXPECT_TRUE(persistence->isEmpty());
+}
+
+TEST_F(MemoryMappedPersistenceTests, ReadingsSurviveReopening)
+{
+    {
+        auto persistence = open();
+        for (auto i = std::uint64_t{0}; i < 100; ++i)
+            ASSERT_TRUE(persistence->putReading("Device+T", makeReading(i)));
+        persistence->removeReadings("Device+T", 10);
+    }
+
+    auto persistence = open();
+    const auto readings = persistence->getReadings("Device+T", 1000);
+    ASSERT_EQ(readings.size(), 90u);
+    EXPECT_EQ(readings.front()->getTimestamp(), 10u);
+    EXPECT_EQ(readings.back()->getTimestamp(), 99u);
+
+    // New readings keep being appended after the recovered ones
+    ASSERT_TRUE(persistence->putReading("Device+T", makeReading(100)));
+    EXPECT_EQ(persistence->getReadings("Device+T", 1000).back()->getTimestamp(), 100u);
+}
+
+TEST_F(MemoryMappedPersistenceTests, FullRingDropsOldestSegment)
+{
+    auto persistence = open(2);
+    for (auto i = std::uint64_t{0}; i < 63 * 2 + 1; ++i)
+        ASSERT_TRUE(persistence->putReading("Device+T", makeReading(i)));
+
+    EXPECT_EQ(persistence->getDroppedReadingsCount(), 63u);
+    const auto readings = persistence->getReadings("Device+T", 1000);
+    ASSERT_EQ(readings.size(), 64u);
+    EXPECT_EQ(readings.front()->getTimestamp(), 63u);
+}
+
+TEST_F(MemoryMappedPersistenceTests, DrainedSegmentsAreReused)
+{
+    auto persistence = open(2);
+    for (auto i = std::uint64_t{0}; i < 1000; ++i)
+    {
+        ASSERT_TRUE(persistence->putReading("Device+T", makeReading(i)));
+        persistence->removeReadings("Device+T", 1);
+    }
+    EXPECT_EQ(persistence->getDroppedReadingsCount(), 0u);
+    EXPECT_TRUE(persistence->isEmpty());
+}
+
+TEST_F(MemoryMappedPersistenceTests, FreeSegmentIsTakenBeforeDroppingPinnedOne)
+{
+    {
+        // The first segment stays pinned by its readings, while the second one is drained
+        auto persistence = open(3);
+        for (auto i = std::uint64_t{0}; i < 63; ++i)
+            ASSERT_TRUE(persistence->putReading("Device+A", makeReading(i)));
+        for (auto i = std::uint64_t{0}; i < 63 * 2; ++i)
+            ASSERT_TRUE(persistence->putReading("Device+B", makeReading(i)));
+        persistence->removeReadings("Device+B", 63);
+        ASSERT_TRUE(persistence->putReading("Device+B", makeReading(63 * 2)));
+
+        EXPECT_EQ(persistence->getDroppedReadingsCount(), 0u);
+        EXPECT_EQ(persistence->getReadings("Device+A", 1000).size(), 63u);
+    }
+
+    // The readings are recovered in the order they were written
+    auto persistence = open(3);
+    EXPECT_EQ(persistence->getReadings("Device+A", 1000).size(), 63u);
+    const auto readings = persistence->getReadings("Device+B", 1000);
+    ASSERT_EQ(readings.size(), 64u);
+    EXPECT_EQ(readings.front()->getTimestamp(), 63u);
+    EXPECT_EQ(readings.back()->getTimestamp(), 63u * 2);
+}
+
+TEST_F(MemoryMappedPersistenceTests, TornRecordIsNotRecovered)
+{
+    {
+        auto persistence = open();
+        ASSERT_TRUE(persistence->putReading("Device+T", makeReading(1)));
+        ASSERT_TRUE(persistence->putReading("Device+T", makeReading(2)));
+
+        // Corrupt the payload of the second record
+        const auto location = persistence->m_readings["Device+T"].back();
+        persistence->m_memory[persistence->segmentStart(location.segment) + location.offset + 20] ^= 0xFF;
+    }
+
+    auto persistence = open();
+    const auto readings = persistence->getReadings("Device+T", 10);
+    ASSERT_EQ(readings.size(), 1u);
+    EXPECT_EQ(readings.front()->getTimestamp(), 1u);
+}
+
+TEST_F(MemoryMappedPersistenceTests, DifferentSizeClearsFile)
+{
+    {
+        auto persistence = open(4);
+        ASSERT_TRUE(persistence->putReading("Device+T", makeReading(1)));
+    }
+    auto persistence = open(8);
+    EXPECT_TRUE(persistence->getReadingsKeys().empty());
+}
+
+TEST_F(MemoryMappedPersistenceTests, ReadingLargerThanSegmentIsRejected)
+{
+    auto persistence = open();
+    EXPECT_FALSE(persistence->putReading("Device+T", Reading{"T", std::string(5000, 'A'), 1}));
+    EXPECT_TRUE(persistence->isEmpty());
+}
+
+TEST_F(MemoryMappedPersistenceTests, AttributesAndParameters)
+{
+    auto persistence = open();
+    EXPECT_TRUE(persistence->putAttribute("Device+A", std::make_shared<Attribute>("A", DataType::STRING, "V")));
+    EXPECT_TRUE(persistence->putParameter("Device+EXTERNAL_ID", Parameter{ParameterName::EXTERNAL_ID, "ID"}));
+    EXPECT_EQ(persistence->getAttributeUnderKey("Device+A")->getValue(), "V");
+    EXPECT_EQ(persistence->getParameterForKey("Device+EXTERNAL_ID").second, "ID");
+    EXPECT_EQ(persistence->getAttributeKeys(), std::vector<std::string>{"Device+A"});
+    EXPECT_EQ(persistence->getParameterKeys(), std::vector<std::string>{"Device+EXTERNAL_ID"});
+    EXPECT_FALSE(persistence->isEmpty());
+
+    persistence->removeAttributes("Device+A");
+    persistence->removeParameters();
+    EXPECT_EQ(persistence->getAttributeUnderKey("Device+A"), nullptr);
+    EXPECT_TRUE(persistence->getParameters().empty());
+    EXPECT_TRUE(persistence->isEmpty());
+}
@@ -0,0 +1,47 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/service/data/PriorityPolicy.h"
+
+#include <gtest/gtest.h>
+
+using namespace wolkabout::connect;
+using namespace ::testing;
+
+TEST(PriorityPolicyTests, DefaultIsStrict)
+{
+    const auto policy = PriorityPolicy{};
+    EXPECT_EQ(policy.getMode(), PriorityMode::Strict);
+    EXPECT_EQ(PriorityPolicy::strict().getMode(), PriorityMode::Strict);
+}
+
+TEST(PriorityPolicyTests, WeightedKeepsTheWeights)
+{
+    const auto policy = PriorityPolicy::weighted({{10, 5, 3, 1}});
+    EXPECT_EQ(policy.getMode(), PriorityMode::Weighted);
+    EXPECT_EQ(policy.getWeight(FeedPriority::Critical), 10);
+    EXPECT_EQ(policy.getWeight(FeedPriority::High), 5);
+    EXPECT_EQ(policy.getWeight(FeedPriority::Normal), 3);
+    EXPECT_EQ(policy.getWeight(FeedPriority::Low), 1);
+}
+
+TEST(PriorityPolicyTests, ZeroWeightIsOne)
+{
+    const auto policy = PriorityPolicy::weighted({{4, 0, 2, 0}});
+    EXPECT_EQ(policy.getWeight(FeedPriority::High), 1);
+    EXPECT_EQ(policy.getWeight(FeedPriority::Low), 1);
+}
@@ -0,0 +1,96 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/service/data/PublishBudget.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+using namespace wolkabout::connect;
+using namespace ::testing;
+
+TEST(PublishBudgetTests, DefaultIsUnlimited)
+{
+    auto budget = PublishBudget{};
+    EXPECT_TRUE(budget.isUnlimited());
+    for (auto i = 0; i < 1000; ++i)
+        budget.consume(1024);
+    EXPECT_FALSE(budget.isExhausted());
+}
+
+TEST(PublishBudgetTests, MessageLimit)
+{
+    auto budget = PublishBudget{2};
+    EXPECT_FALSE(budget.isUnlimited());
+    budget.consume(10);
+    EXPECT_FALSE(budget.isExhausted());
+    budget.consume(10);
+    EXPECT_TRUE(budget.isExhausted());
+    EXPECT_EQ(budget.getSpentMessages(), 2);
+    EXPECT_EQ(budget.getSpentBytes(), 20);
+}
+
+TEST(PublishBudgetTests, ChangingMessageLimitKeepsSpent)
+{
+    auto budget = PublishBudget{3};
+    budget.consume(10);
+    budget.setMessageLimit(1);
+    EXPECT_TRUE(budget.isExhausted());
+    budget.setMessageLimit(3);
+    EXPECT_FALSE(budget.isExhausted());
+    EXPECT_EQ(budget.getMessageLimit(), 3);
+    EXPECT_EQ(budget.getSpentMessages(), 1);
+}
+
+TEST(PublishBudgetTests, ByteLimit)
+{
+    auto budget = PublishBudget{0, 100};
+    budget.consume(60);
+    EXPECT_FALSE(budget.isExhausted());
+    budget.consume(60);
+    EXPECT_TRUE(budget.isExhausted());
+}
+
+TEST(PublishBudgetTests, TimeLimit)
+{
+    auto budget = PublishBudget{0, 0, std::chrono::milliseconds{10}};
+    EXPECT_FALSE(budget.isExhausted());
+    std::this_thread::sleep_for(std::chrono::milliseconds{20});
+    EXPECT_TRUE(budget.isExhausted());
+}
+
+TEST(PublishBudgetTests, Restart)
+{
+    auto budget = PublishBudget{1};
+    budget.consume(10);
+    ASSERT_TRUE(budget.isExhausted());
+    budget.restart();
+    EXPECT_FALSE(budget.isExhausted());
+    EXPECT_EQ(budget.getSpentMessages(), 0);
+}
+
+TEST(PublishBudgetTests, FailureLastsUntilRestart)
+{
+    auto budget = PublishBudget{};
+    EXPECT_FALSE(budget.hasFailed());
+    budget.fail();
+    EXPECT_TRUE(budget.hasFailed());
+    EXPECT_FALSE(budget.isExhausted());
+    budget.restart();
+    EXPECT_FALSE(budget.hasFailed());
+}
@@ -0,0 +1,80 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/service/data/RateLimiter.h"
+
+#include <gtest/gtest.h>
+
+using namespace wolkabout::connect;
+using namespace ::testing;
+
+TEST(RateLimiterTests, DefaultIsDisabled)
+{
+    auto limiter = RateLimiter{};
+    EXPECT_FALSE(limiter.isEnabled());
+    for (auto i = 0; i < 1000; ++i)
+    {
+        ASSERT_TRUE(limiter.isAvailable());
+        limiter.consume(1024);
+    }
+    EXPECT_EQ(limiter.getDelay().count(), 0);
+    EXPECT_EQ(limiter.getMetrics().publishedMessages, 1000);
+}
+
+TEST(RateLimiterTests, BurstThenRate)
+{
+    auto limiter = RateLimiter{10, 0, 3};
+    const auto start = RateLimiter::Clock::now();
+    for (auto i = 0; i < 3; ++i)
+    {
+        ASSERT_TRUE(limiter.isAvailable(start));
+        limiter.consume(10);
+    }
+    EXPECT_FALSE(limiter.isAvailable(start));
+    EXPECT_EQ(limiter.getDelay(start).count(), 100);
+
+    // A tenth of a second brings back a single message
+    EXPECT_FALSE(limiter.isAvailable(start + std::chrono::milliseconds{50}));
+    EXPECT_TRUE(limiter.isAvailable(start + std::chrono::milliseconds{100}));
+    limiter.consume(10);
+    EXPECT_FALSE(limiter.isAvailable(start + std::chrono::milliseconds{100}));
+
+    // The bucket does not fill up over the burst
+    EXPECT_TRUE(limiter.isAvailable(start + std::chrono::seconds{10}));
+    for (auto i = 0; i < 3; ++i)
+        limiter.consume(10);
+    EXPECT_FALSE(limiter.isAvailable(start + std::chrono::seconds{10}));
+
+    const auto metrics = limiter.getMetrics();
+    EXPECT_EQ(metrics.publishedMessages, 7);
+    EXPECT_EQ(metrics.publishedBytes, 70);
+    EXPECT_EQ(metrics.throttled, 4);
+}
+
+TEST(RateLimiterTests, LargeMessageIsPaidOff)
+{
+    auto limiter = RateLimiter{0, 1000};
+    const auto start = RateLimiter::Clock::now();
+    ASSERT_TRUE(limiter.isAvailable(start));
+    limiter.consume(3000);
+
+    // The bucket is in debt for the two seconds over the burst, and a bit to get a byte back
+    EXPECT_FALSE(limiter.isAvailable(start + std::chrono::seconds{1}));
+    EXPECT_EQ(limiter.getDelay(start + std::chrono::seconds{1}).count(), 1001);
+    EXPECT_FALSE(limiter.isAvailable(start + std::chrono::seconds{2}));
+    EXPECT_TRUE(limiter.isAvailable(start + std::chrono::milliseconds{2001}));
+}
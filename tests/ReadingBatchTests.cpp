@@ -0,0 +1,68 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/service/data/ReadingBatch.h"
+
+#include <gtest/gtest.h>
+
+using namespace wolkabout::connect;
+using namespace ::testing;
+
+TEST(ReadingBatchTests, ColumnarConstruction)
+{
+    const auto batch =
+      ReadingBatch{"T", std::vector<int>{1, 2, 3}, std::vector<std::uint64_t>{1234567890, 1234567891, 1234567892}};
+    EXPECT_EQ(batch.getReference(), "T");
+    EXPECT_EQ(batch.size(), 3u);
+    EXPECT_TRUE(batch.isValid());
+    EXPECT_EQ(batch.getValues()[1], ReadingValue{2});
+    EXPECT_EQ(batch.getTimestamps()[2], 1234567892u);
+}
+
+TEST(ReadingBatchTests, StampFillsMissingTimestamps)
+{
+    auto batch = ReadingBatch{"T", std::vector<double>{1.0, 2.0}};
+    EXPECT_FALSE(batch.isValid());
+    batch.stamp(1234567890);
+    EXPECT_TRUE(batch.isValid());
+    EXPECT_EQ(batch.getTimestamps(), (std::vector<std::uint64_t>{1234567890, 1234567890}));
+}
+
+TEST(ReadingBatchTests, StampKeepsExistingTimestamps)
+{
+    auto batch = ReadingBatch{"T"};
+    batch.reserve(2);
+    batch.add(1u, 1000);
+    batch.add(2u);
+    batch.stamp(2000);
+    EXPECT_EQ(batch.getTimestamps(), (std::vector<std::uint64_t>{1000, 2000}));
+}
+
+TEST(ReadingBatchTests, MismatchedColumnsAreInvalid)
+{
+    auto batch = ReadingBatch{"T", std::vector<int>{1, 2, 3}, std::vector<std::uint64_t>{1, 2}};
+    batch.stamp(1234567890);
+    EXPECT_FALSE(batch.isValid());
+}
+
+TEST(ReadingBatchTests, AddAlignsTimestamps)
+{
+    auto batch = ReadingBatch{"T", std::vector<int>{1, 2}};
+    batch.add(3, 1234567890);
+    EXPECT_TRUE(batch.isValid());
+    EXPECT_EQ(batch.getTimestamps(), (std::vector<std::uint64_t>{0, 0, 1234567890}));
+}
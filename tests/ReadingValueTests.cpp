@@ -0,0 +1,86 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/service/data/ReadingValue.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+using namespace wolkabout::connect;
+using namespace ::testing;
+
+TEST(ReadingValueTests, DefaultIsEmptyString)
+{
+    const auto value = ReadingValue{};
+    EXPECT_TRUE(value.isString());
+    EXPECT_TRUE(value.getString().empty());
+    EXPECT_EQ(value.toString(), "");
+}
+
+TEST(ReadingValueTests, StringValue)
+{
+    const auto value = ReadingValue{"TestValue"};
+    EXPECT_EQ(value.getType(), ReadingValue::Type::String);
+    EXPECT_EQ(value.toString(), "TestValue");
+    EXPECT_EQ(value, ReadingValue{std::string{"TestValue"}});
+}
+
+TEST(ReadingValueTests, SignedValue)
+{
+    const auto value = ReadingValue{-42};
+    EXPECT_EQ(value.getType(), ReadingValue::Type::Signed);
+    EXPECT_FALSE(value.isString());
+    EXPECT_EQ(value.getSigned(), -42);
+    EXPECT_DOUBLE_EQ(value.getNumber(), -42.0);
+    EXPECT_EQ(value.toString(), "-42");
+}
+
+TEST(ReadingValueTests, UnsignedValue)
+{
+    const auto value = ReadingValue{std::uint64_t{18446744073709551615u}};
+    EXPECT_EQ(value.getType(), ReadingValue::Type::Unsigned);
+    EXPECT_EQ(value.getUnsigned(), 18446744073709551615u);
+    EXPECT_EQ(value.toString(), "18446744073709551615");
+}
+
+TEST(ReadingValueTests, FloatingValues)
+{
+    EXPECT_EQ(ReadingValue{1.5f}.getType(), ReadingValue::Type::Float);
+    EXPECT_EQ(ReadingValue{1.5}.getType(), ReadingValue::Type::Double);
+    EXPECT_DOUBLE_EQ(ReadingValue{1.5f}.getNumber(), 1.5);
+    EXPECT_DOUBLE_EQ(ReadingValue{1.5}.getNumber(), 1.5);
+}
+
+TEST(ReadingValueTests, BooleanValue)
+{
+    const auto value = ReadingValue{true};
+    EXPECT_EQ(value.getType(), ReadingValue::Type::Boolean);
+    EXPECT_TRUE(value.getBool());
+    EXPECT_DOUBLE_EQ(value.getNumber(), 1.0);
+}
+
+TEST(ReadingValueTests, Equality)
+{
+    EXPECT_EQ(ReadingValue{5}, ReadingValue{5});
+    EXPECT_NE(ReadingValue{5}, ReadingValue{6});
+    EXPECT_NE(ReadingValue{5}, ReadingValue{5u});
+    EXPECT_NE(ReadingValue{5}, ReadingValue{"5"});
+    EXPECT_EQ(ReadingValue{1.5}, ReadingValue{1.5});
+    EXPECT_NE(ReadingValue{1.5}, ReadingValue{1.5f});
+    EXPECT_EQ(ReadingValue{std::nan("")}, ReadingValue{std::nan("")});
+}
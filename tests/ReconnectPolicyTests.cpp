@@ -0,0 +1,49 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "wolk/utilities/ReconnectPolicy.h"
+
+#include <gtest/gtest.h>
+
+using namespace wolkabout::connect;
+using namespace ::testing;
+
+TEST(ReconnectPolicyTests, DelayGrowsUpToTheMaximum)
+{
+    const auto policy = ReconnectPolicy{std::chrono::milliseconds{100}, std::chrono::milliseconds{1000}, 2.0, 0.0};
+    EXPECT_EQ(policy.getDelay(0, 0.5), std::chrono::milliseconds{100});
+    EXPECT_EQ(policy.getDelay(1, 0.5), std::chrono::milliseconds{200});
+    EXPECT_EQ(policy.getDelay(3, 0.5), std::chrono::milliseconds{800});
+    EXPECT_EQ(policy.getDelay(4, 0.5), std::chrono::milliseconds{1000});
+    EXPECT_EQ(policy.getDelay(1000000, 0.5), std::chrono::milliseconds{1000});
+}
+
+TEST(ReconnectPolicyTests, JitterLeavesOutARandomPart)
+{
+    const auto policy = ReconnectPolicy{std::chrono::milliseconds{1000}, std::chrono::milliseconds{1000}, 2.0, 0.5};
+    EXPECT_EQ(policy.getDelay(0, 0.0), std::chrono::milliseconds{1000});
+    EXPECT_EQ(policy.getDelay(0, 0.5), std::chrono::milliseconds{750});
+    EXPECT_EQ(policy.getDelay(0, 1.0), std::chrono::milliseconds{500});
+}
+
+TEST(ReconnectPolicyTests, InvalidValuesAreClamped)
+{
+    const auto policy = ReconnectPolicy{std::chrono::milliseconds{0}, std::chrono::milliseconds{-5}, 0.5, 2.0};
+    EXPECT_EQ(policy.getInitialDelay(), std::chrono::milliseconds{1});
+    EXPECT_EQ(policy.getMaxDelay(), std::chrono::milliseconds{1});
+    EXPECT_EQ(policy.getMultiplier(), 1.0);
+    EXPECT_EQ(policy.getJitter(), 1.0);
+}
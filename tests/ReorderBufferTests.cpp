@@ -0,0 +1,110 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/service/data/ReorderBuffer.h"
+
+#include <gtest/gtest.h>
+
+using namespace wolkabout;
+using namespace wolkabout::connect;
+using namespace ::testing;
+
+namespace
+{
+std::vector<std::uint64_t> timestamps(const std::vector<Reading>& readings)
+{
+    auto result = std::vector<std::uint64_t>{};
+    for (const auto& reading : readings)
+        result.emplace_back(reading.getTimestamp());
+    return result;
+}
+}    // namespace
+
+TEST(ReorderBufferTests, DisabledLetsEverythingThrough)
+{
+    ReorderBuffer buffer;
+    EXPECT_FALSE(buffer.isEnabled());
+    EXPECT_EQ(buffer.push("D+T", Reading{"T", "1", 200}).size(), 1);
+    EXPECT_EQ(buffer.push("D+T", Reading{"T", "2", 100}).size(), 1);
+    EXPECT_EQ(buffer.getBufferedCount(), 0);
+}
+
+TEST(ReorderBufferTests, OutOfOrderReadingsAreSorted)
+{
+    const auto now = ReorderBuffer::Clock::now();
+    ReorderBuffer buffer{std::chrono::milliseconds{1000}};
+    EXPECT_TRUE(buffer.push("D+T", Reading{"T", "3", 3000}, now).empty());
+    EXPECT_TRUE(buffer.push("D+T", Reading{"T", "1", 1000}, now).empty());
+    EXPECT_TRUE(buffer.push("D+T", Reading{"T", "2", 2000}, now).empty());
+    EXPECT_EQ(buffer.getBufferedCount(), 3);
+
+    // Once the window passes, the readings go through in order
+    const auto released = buffer.push("D+T", Reading{"T", "4", 3500}, now + std::chrono::milliseconds{1000});
+    EXPECT_EQ(timestamps(released), (std::vector<std::uint64_t>{1000, 2000, 3000}));
+    EXPECT_EQ(buffer.getBufferedCount(), 1);
+}
+
+TEST(ReorderBufferTests, DuplicatesAreCollapsed)
+{
+    const auto now = ReorderBuffer::Clock::now();
+    ReorderBuffer buffer{std::chrono::milliseconds{1000}};
+    buffer.push("D+T", Reading{"T", "1", 1000}, now);
+    buffer.push("D+T", Reading{"T", "2", 1000}, now);
+    buffer.push("D+T", Reading{"T", "2", 1000}, now);
+    const auto released = buffer.push("D+T", Reading{"T", "3", 5000}, now + std::chrono::seconds{1});
+    ASSERT_EQ(released.size(), 2);
+    EXPECT_EQ(released.front().getStringValue(), "1");
+    EXPECT_EQ(released.back().getStringValue(), "2");
+
+    // Once let through, the repeated reading is dropped, while the distinct and older ones go through right away
+    EXPECT_TRUE(buffer.push("D+T", Reading{"T", "2", 1000}, now).empty());
+    EXPECT_EQ(buffer.push("D+T", Reading{"T", "4", 1000}, now).size(), 1);
+    EXPECT_EQ(buffer.push("D+T", Reading{"T", "5", 500}, now).size(), 1);
+}
+
+TEST(ReorderBufferTests, QuietFeedsAreReleasedAfterTheWindow)
+{
+    const auto now = ReorderBuffer::Clock::now();
+    ReorderBuffer buffer{std::chrono::milliseconds{1000}};
+    buffer.push("D+T", Reading{"T", "2", 2000}, now);
+    buffer.push("D+H", Reading{"H", "1", 1000}, now + std::chrono::milliseconds{500});
+    EXPECT_TRUE(buffer.release(now + std::chrono::milliseconds{999}).empty());
+
+    const auto released = buffer.release(now + std::chrono::milliseconds{1000});
+    ASSERT_EQ(released.size(), 1);
+    EXPECT_EQ(released.front().first, "D+T");
+    EXPECT_EQ(buffer.release(now + std::chrono::milliseconds{1500}).size(), 1);
+    EXPECT_EQ(buffer.getBufferedCount(), 0);
+}
+
+TEST(ReorderBufferTests, ReadingsWithoutTimestampAreNotHeld)
+{
+    ReorderBuffer buffer{std::chrono::milliseconds{1000}};
+    EXPECT_EQ(buffer.push("D+T", Reading{"T", "1", 0}).size(), 1);
+}
+
+TEST(ReorderBufferTests, OrderSortsAndCollapses)
+{
+    auto readings = std::vector<Reading>{Reading{"T", "1", 300}, Reading{"H", "1", 100}, Reading{"T", "2", 100},
+                                         Reading{"T", "3", 300}, Reading{"T", "1", 300}};
+    ReorderBuffer::order(readings);
+    ASSERT_EQ(readings.size(), 4);
+    EXPECT_EQ(timestamps(readings), (std::vector<std::uint64_t>{100, 100, 300, 300}));
+    EXPECT_EQ(readings[0].getReference(), "H");
+    EXPECT_EQ(readings[2].getStringValue(), "1");
+    EXPECT_EQ(readings[3].getStringValue(), "3");
+}
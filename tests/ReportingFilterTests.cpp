@@ -0,0 +1,114 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/service/data/ReportingFilter.h"
+
+#include <gtest/gtest.h>
+
+using namespace wolkabout::connect;
+using namespace ::testing;
+
+class ReportingFilterTests : public ::testing::Test
+{
+public:
+    KeyInterner keys{"+"};
+    ReportingFilter filter;
+};
+
+TEST_F(ReportingFilterTests, NoPolicyReportsEverything)
+{
+    const auto& key = keys.intern("DeviceKey", "T");
+    EXPECT_TRUE(filter.shouldReport(key, ReadingValue{1.0}, 1));
+    EXPECT_TRUE(filter.shouldReport(key, ReadingValue{1.0}, 2));
+    EXPECT_EQ(filter.getPolicy("T").getMode(), ReportingMode::Always);
+}
+
+TEST_F(ReportingFilterTests, OnChange)
+{
+    const auto& key = keys.intern("DeviceKey", "IP");
+    filter.setPolicy("IP", ReportingPolicy::onChange());
+    EXPECT_TRUE(filter.shouldReport(key, std::string{"10.0.0.1"}, 1));
+    EXPECT_FALSE(filter.shouldReport(key, std::string{"10.0.0.1"}, 2));
+    EXPECT_TRUE(filter.shouldReport(key, std::string{"10.0.0.2"}, 3));
+    EXPECT_FALSE(filter.shouldReport(key, ReadingValue{"10.0.0.2"}, 4));
+}
+
+TEST_F(ReportingFilterTests, AbsoluteDeadband)
+{
+    const auto& key = keys.intern("DeviceKey", "T");
+    filter.setPolicy("T", ReportingPolicy::absoluteDeadband(0.5));
+    EXPECT_TRUE(filter.shouldReport(key, ReadingValue{20.0}, 1));
+    EXPECT_FALSE(filter.shouldReport(key, ReadingValue{20.4}, 2));
+    EXPECT_FALSE(filter.shouldReport(key, ReadingValue{19.6}, 3));
+    EXPECT_TRUE(filter.shouldReport(key, ReadingValue{20.6}, 4));
+
+    // The deadband is measured from the last reported value, and numbers in strings are compared as numbers
+    EXPECT_FALSE(filter.shouldReport(key, std::string{"20.9"}, 5));
+    EXPECT_TRUE(filter.shouldReport(key, std::string{"21.2"}, 6));
+}
+
+TEST_F(ReportingFilterTests, PercentDeadband)
+{
+    const auto& key = keys.intern("DeviceKey", "P");
+    filter.setPolicy("P", ReportingPolicy::percentDeadband(10));
+    EXPECT_TRUE(filter.shouldReport(key, ReadingValue{100}, 1));
+    EXPECT_FALSE(filter.shouldReport(key, ReadingValue{109}, 2));
+    EXPECT_TRUE(filter.shouldReport(key, ReadingValue{111}, 3));
+    EXPECT_FALSE(filter.shouldReport(key, ReadingValue{101}, 4));
+    EXPECT_TRUE(filter.shouldReport(key, ReadingValue{99}, 5));
+}
+
+TEST_F(ReportingFilterTests, HeartbeatReportsUnchangedValue)
+{
+    const auto& key = keys.intern("DeviceKey", "T");
+    filter.setPolicy("T", ReportingPolicy::onChange(std::chrono::milliseconds{1000}));
+    EXPECT_TRUE(filter.shouldReport(key, ReadingValue{true}, 1000));
+    EXPECT_FALSE(filter.shouldReport(key, ReadingValue{true}, 1999));
+    EXPECT_TRUE(filter.shouldReport(key, ReadingValue{true}, 2000));
+    EXPECT_FALSE(filter.shouldReport(key, ReadingValue{true}, 500));
+}
+
+TEST_F(ReportingFilterTests, FeedsOfDevicesAreTrackedSeparately)
+{
+    const auto& first = keys.intern("DeviceKey", "T");
+    const auto& second = keys.intern("OtherDevice", "T");
+    filter.setPolicy("T", ReportingPolicy::onChange());
+    EXPECT_TRUE(filter.shouldReport(first, ReadingValue{1}, 1));
+    EXPECT_TRUE(filter.shouldReport(second, ReadingValue{1}, 1));
+    EXPECT_FALSE(filter.shouldReport(first, ReadingValue{1}, 2));
+}
+
+TEST_F(ReportingFilterTests, MultiValueFeedsAreComparedAsWhole)
+{
+    const auto& key = keys.intern("DeviceKey", "LOC");
+    filter.setPolicy("LOC", ReportingPolicy::absoluteDeadband(1));
+    EXPECT_TRUE(filter.shouldReport(key, std::vector<std::string>{"45.1", "19.8"}, 1));
+    EXPECT_FALSE(filter.shouldReport(key, std::vector<std::string>{"45.1", "19.8"}, 2));
+    EXPECT_TRUE(filter.shouldReport(key, std::vector<std::string>{"45.1", "19.9"}, 3));
+}
+
+TEST_F(ReportingFilterTests, ChangingPolicyForgetsState)
+{
+    const auto& key = keys.intern("DeviceKey", "T");
+    filter.setPolicy("T", ReportingPolicy::onChange());
+    EXPECT_TRUE(filter.shouldReport(key, ReadingValue{1}, 1));
+    filter.setPolicy("T", ReportingPolicy::absoluteDeadband(5));
+    EXPECT_TRUE(filter.shouldReport(key, ReadingValue{1}, 2));
+    filter.setPolicy("T", ReportingPolicy{});
+    EXPECT_TRUE(filter.shouldReport(key, ReadingValue{1}, 3));
+    EXPECT_EQ(filter.getPolicy("T").getMode(), ReportingMode::Always);
+}
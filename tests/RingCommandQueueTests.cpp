@@ -0,0 +1,149 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/utilities/RingCommandQueue.h"
+
+#include "core/utilities/Timer.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace wolkabout;
+using namespace wolkabout::connect;
+using namespace ::testing;
+
+TEST(RingCommandQueueTests, CapacityIsPowerOfTwo)
+{
+    RingCommandQueue queue{1000};
+    EXPECT_EQ(queue.getCapacity(), 1024);
+}
+
+TEST(RingCommandQueueTests, ExecutesCommandsInOrder)
+{
+    std::mutex mutex;
+    std::condition_variable condition;
+    auto order = std::vector<int>{};
+
+    RingCommandQueue queue{4};
+    for (auto i = 0; i < 10; ++i)
+        queue.pushCommand([&, i] {
+            std::lock_guard<std::mutex> lock{mutex};
+            order.emplace_back(i);
+            condition.notify_one();
+        });
+
+    std::unique_lock<std::mutex> lock{mutex};
+    condition.wait_for(lock, std::chrono::seconds{1}, [&] { return order.size() == 10; });
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+}
+
+TEST(RingCommandQueueTests, CommandsCanFillTheRingWithCommands)
+{
+    std::mutex mutex;
+    std::condition_variable condition;
+    auto order = std::vector<int>{};
+
+    // The worker pushes more commands than the ring holds, and they still execute in order
+    RingCommandQueue queue{2};
+    queue.pushCommand([&] {
+        for (auto i = 0; i < 10; ++i)
+            queue.pushCommand([&, i] {
+                std::lock_guard<std::mutex> lock{mutex};
+                order.emplace_back(i);
+                condition.notify_one();
+            });
+    });
+
+    std::unique_lock<std::mutex> lock{mutex};
+    condition.wait_for(lock, std::chrono::seconds{1}, [&] { return order.size() == 10; });
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+}
+
+TEST(RingCommandQueueTests, CommandsCanStopTimersThatFillTheRing)
+{
+    std::mutex mutex;
+    std::condition_variable condition;
+    auto order = std::vector<int>{};
+    std::atomic_bool pushing{false};
+
+    // The timer fills the ring while the worker executes the command, and stopping the timer waits for its thread
+    RingCommandQueue queue{2};
+    Timer timer;
+    queue.pushCommand([&] {
+        timer.start(std::chrono::milliseconds{1}, [&] {
+            pushing = true;
+            for (auto i = 0; i < 10; ++i)
+                queue.pushCommand([&, i] {
+                    std::lock_guard<std::mutex> lock{mutex};
+                    order.emplace_back(i);
+                    condition.notify_one();
+                });
+        });
+        while (!pushing)
+            std::this_thread::yield();
+        timer.stop();
+    });
+
+    std::unique_lock<std::mutex> lock{mutex};
+    condition.wait_for(lock, std::chrono::seconds{1}, [&] { return order.size() == 10; });
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+}
+
+TEST(RingCommandQueueTests, ManyProducers)
+{
+    const auto producers = 4;
+    const auto commands = 10000;
+    std::mutex mutex;
+    std::condition_variable condition;
+    auto executed = 0;
+    auto lastOfProducer = std::vector<int>(producers, -1);
+    auto inOrder = true;
+
+    RingCommandQueue queue{64};
+    auto threads = std::vector<std::thread>{};
+    for (auto producer = 0; producer < producers; ++producer)
+        threads.emplace_back([&, producer] {
+            for (auto i = 0; i < commands; ++i)
+                queue.pushCommand([&, producer, i] {
+                    // Only the worker touches these, so only the count needs the lock
+                    inOrder = inOrder && lastOfProducer[static_cast<std::size_t>(producer)] == i - 1;
+                    lastOfProducer[static_cast<std::size_t>(producer)] = i;
+                    std::lock_guard<std::mutex> lock{mutex};
+                    ++executed;
+                    condition.notify_one();
+                });
+        });
+    for (auto& thread : threads)
+        thread.join();
+
+    std::unique_lock<std::mutex> lock{mutex};
+    condition.wait_for(lock, std::chrono::seconds{5}, [&] { return executed == producers * commands; });
+    EXPECT_EQ(executed, producers * commands);
+    EXPECT_TRUE(inOrder);
+}
+
+TEST(RingCommandQueueTests, IgnoresEmptyTasks)
+{
+    RingCommandQueue queue;
+    ASSERT_NO_FATAL_FAILURE(queue.pushCommand(Task{}));
+}
@@ -0,0 +1,265 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/utilities/SharedExecutor.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace wolkabout::connect;
+using namespace ::testing;
+
+TEST(SharedExecutorTests, StartsAtLeastOneWorker)
+{
+    SharedExecutor executor{0};
+    EXPECT_EQ(executor.getWorkerCount(), 1);
+}
+
+TEST(SharedExecutorTests, StrandExecutesCommandsInOrderOneByOne)
+{
+    std::mutex mutex;
+    std::condition_variable condition;
+    auto order = std::vector<int>{};
+    std::atomic_int active{0};
+    std::atomic_bool overlapped{false};
+
+    SharedExecutor executor{4};
+    auto strand = executor.makeStrand();
+    for (auto i = 0; i < 1000; ++i)
+        strand->pushCommand([&, i] {
+            if (++active > 1)
+                overlapped = true;
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                order.emplace_back(i);
+            }
+            --active;
+            condition.notify_one();
+        });
+
+    std::unique_lock<std::mutex> lock{mutex};
+    condition.wait_for(lock, std::chrono::seconds{5}, [&] { return order.size() == 1000; });
+    ASSERT_EQ(order.size(), 1000);
+    for (auto i = 0; i < 1000; ++i)
+        EXPECT_EQ(order[static_cast<std::size_t>(i)], i);
+    EXPECT_FALSE(overlapped);
+}
+
+TEST(SharedExecutorTests, StrandsShareTheWorker)
+{
+    std::mutex mutex;
+    std::condition_variable condition;
+    auto threads = std::vector<std::thread::id>{};
+
+    SharedExecutor executor{1};
+    auto first = executor.makeStrand();
+    auto second = executor.makeStrand();
+    const auto record = [&] {
+        std::lock_guard<std::mutex> lock{mutex};
+        threads.emplace_back(std::this_thread::get_id());
+        condition.notify_one();
+    };
+    first->pushCommand(record);
+    second->pushCommand(record);
+
+    std::unique_lock<std::mutex> lock{mutex};
+    condition.wait_for(lock, std::chrono::seconds{1}, [&] { return threads.size() == 2; });
+    ASSERT_EQ(threads.size(), 2);
+    EXPECT_EQ(threads.front(), threads.back());
+    EXPECT_NE(threads.front(), std::this_thread::get_id());
+}
+
+TEST(SharedExecutorTests, DestroyedStrandDiscardsItsCommands)
+{
+    std::mutex mutex;
+    std::condition_variable condition;
+    auto started = false;
+    auto released = false;
+    std::atomic_bool discardedExecuted{false};
+    std::atomic_bool afterExecuted{false};
+
+    SharedExecutor executor{1};
+    auto blocking = executor.makeStrand();
+    auto discarded = executor.makeStrand();
+
+    // Keep the only worker busy, so the command of the other strand waits
+    blocking->pushCommand([&] {
+        std::unique_lock<std::mutex> lock{mutex};
+        started = true;
+        condition.notify_all();
+        condition.wait(lock, [&] { return released; });
+    });
+    {
+        std::unique_lock<std::mutex> lock{mutex};
+        condition.wait_for(lock, std::chrono::seconds{1}, [&] { return started; });
+    }
+    discarded->pushCommand([&] { discardedExecuted = true; });
+    discarded.reset();
+    blocking->pushCommand([&] { afterExecuted = true; });
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        released = true;
+    }
+    condition.notify_all();
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{1};
+    while (!afterExecuted && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    EXPECT_TRUE(afterExecuted);
+    EXPECT_FALSE(discardedExecuted);
+}
+
+TEST(SharedExecutorTests, CommandCanDestroyItsOwnStrand)
+{
+    std::mutex mutex;
+    std::condition_variable condition;
+    auto destroyed = false;
+
+    SharedExecutor executor{2};
+    auto strand = executor.makeStrand();
+    strand->pushCommand([&] {
+        strand.reset();
+        std::lock_guard<std::mutex> lock{mutex};
+        destroyed = true;
+        condition.notify_one();
+    });
+
+    std::unique_lock<std::mutex> lock{mutex};
+    EXPECT_TRUE(condition.wait_for(lock, std::chrono::seconds{1}, [&] { return destroyed; }));
+}
+
+TEST(SharedExecutorTests, IgnoresEmptyTasks)
+{
+    SharedExecutor executor;
+    auto strand = executor.makeStrand();
+    ASSERT_NO_FATAL_FAILURE(strand->pushCommand(Task{}));
+}
+
+TEST(SharedExecutorTests, TimerInvokesCallbackOnceAfterDelay)
+{
+    std::atomic_int invoked{0};
+
+    SharedExecutor executor{1};
+    auto timer = executor.makeTimer();
+    const auto started = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::steady_clock::duration{};
+    timer->start(std::chrono::milliseconds{20}, [&] {
+        elapsed = std::chrono::steady_clock::now() - started;
+        ++invoked;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{100});
+    EXPECT_EQ(invoked, 1);
+    EXPECT_GE(elapsed, std::chrono::milliseconds{20});
+}
+
+TEST(SharedExecutorTests, TimerRunsPeriodicallyUntilStopped)
+{
+    std::atomic_int invoked{0};
+
+    SharedExecutor executor{1};
+    auto timer = executor.makeTimer();
+    timer->run(std::chrono::milliseconds{5}, [&] { ++invoked; });
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{1};
+    while (invoked < 3 && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    timer->stop();
+    const auto stopped = invoked.load();
+    EXPECT_GE(stopped, 3);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{30});
+    EXPECT_EQ(invoked, stopped);
+}
+
+TEST(SharedExecutorTests, RestartedTimerDropsThePreviousRun)
+{
+    std::atomic_int first{0};
+    std::atomic_int second{0};
+
+    SharedExecutor executor{1};
+    auto timer = executor.makeTimer();
+    timer->start(std::chrono::milliseconds{10}, [&] { ++first; });
+    timer->start(std::chrono::milliseconds{20}, [&] { ++second; });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{100});
+    EXPECT_EQ(first, 0);
+    EXPECT_EQ(second, 1);
+}
+
+TEST(SharedExecutorTests, TimersAndStrandsShareTheWorker)
+{
+    std::mutex mutex;
+    std::condition_variable condition;
+    auto threads = std::vector<std::thread::id>{};
+
+    SharedExecutor executor{1};
+    auto strand = executor.makeStrand();
+    auto timer = executor.makeTimer();
+    timer->start(std::chrono::milliseconds{5}, [&] {
+        strand->pushCommand([&] {
+            std::lock_guard<std::mutex> lock{mutex};
+            threads.emplace_back(std::this_thread::get_id());
+            condition.notify_one();
+        });
+        std::lock_guard<std::mutex> lock{mutex};
+        threads.emplace_back(std::this_thread::get_id());
+    });
+
+    std::unique_lock<std::mutex> lock{mutex};
+    condition.wait_for(lock, std::chrono::seconds{1}, [&] { return threads.size() == 2; });
+    ASSERT_EQ(threads.size(), 2);
+    EXPECT_EQ(threads.front(), threads.back());
+}
+
+TEST(SharedExecutorTests, CallbackCanStopItsOwnTimer)
+{
+    std::atomic_int invoked{0};
+
+    SharedExecutor executor{1};
+    auto timer = executor.makeTimer();
+    timer->run(std::chrono::milliseconds{1}, [&] {
+        ++invoked;
+        timer->stop();
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{30});
+    EXPECT_EQ(invoked, 1);
+}
+
+TEST(SharedExecutorTests, TimerOutlivingTheExecutorDoesNothing)
+{
+    std::atomic_int invoked{0};
+
+    auto timer = std::unique_ptr<CommandTimer>{};
+    {
+        SharedExecutor executor{1};
+        timer = executor.makeTimer();
+        timer->start(std::chrono::milliseconds{5}, [&] { ++invoked; });
+    }
+    timer->start(std::chrono::milliseconds{1}, [&] { ++invoked; });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{20});
+    EXPECT_EQ(invoked, 0);
+}
@@ -0,0 +1,100 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/utilities/Task.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <memory>
+#include <string>
+#include <utility>
+
+using namespace wolkabout::connect;
+using namespace ::testing;
+
+namespace
+{
+struct MoveOnlyCallable
+{
+    std::unique_ptr<int> value;
+    int* result;
+
+    void operator()() { *result = *value; }
+};
+
+struct LargeCallable
+{
+    std::array<char, 512> data;
+    int* calls;
+
+    void operator()() { ++(*calls); }
+};
+}    // namespace
+
+TEST(TaskTests, EmptyTask)
+{
+    auto task = Task{};
+    EXPECT_FALSE(task);
+    ASSERT_NO_FATAL_FAILURE(task());
+}
+
+TEST(TaskTests, InvokesLambda)
+{
+    auto called = false;
+    auto task = Task{[&called] { called = true; }};
+    EXPECT_TRUE(task);
+    task();
+    EXPECT_TRUE(called);
+}
+
+TEST(TaskTests, HoldsMoveOnlyCallable)
+{
+    auto result = 0;
+    auto task = Task{MoveOnlyCallable{std::unique_ptr<int>{new int{42}}, &result}};
+    auto moved = std::move(task);
+    EXPECT_FALSE(task);
+    moved();
+    EXPECT_EQ(result, 42);
+}
+
+TEST(TaskTests, SmallCallablesAreStoredInPlace)
+{
+    EXPECT_TRUE(Task::fitsInPlace<MoveOnlyCallable>());
+    EXPECT_FALSE(Task::fitsInPlace<LargeCallable>());
+}
+
+TEST(TaskTests, LargeCallablesAreStoredOnHeap)
+{
+    auto calls = 0;
+    auto task = Task{LargeCallable{{}, &calls}};
+    auto moved = Task{};
+    moved = std::move(task);
+    moved();
+    EXPECT_FALSE(task);
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(TaskTests, DestroysCapturedState)
+{
+    auto state = std::make_shared<std::string>("TestValue");
+    {
+        auto task = Task{[state] {}};
+        EXPECT_EQ(state.use_count(), 2);
+    }
+    EXPECT_EQ(state.use_count(), 1);
+}
@@ -0,0 +1,178 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#define private public
+#define protected public
+#include "wolk/persistence/TieredPersistence.h"
+#undef private
+#undef protected
+
+#include "wolk/persistence/BoundedInMemoryPersistence.h"
+#include "wolk/persistence/MemoryMappedPersistence.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+
+using namespace wolkabout;
+using namespace wolkabout::connect;
+using namespace ::testing;
+
+class TieredPersistenceTests : public ::testing::Test
+{
+public:
+    void SetUp() override
+    {
+        std::remove(PATH.c_str());
+        diskTier = new BoundedInMemoryPersistence{0, 0};
+        persistence = std::unique_ptr<TieredPersistence>{
+          new TieredPersistence{std::unique_ptr<Persistence>{diskTier}, READING_SIZE * 4}};
+    }
+
+    void TearDown() override { std::remove(PATH.c_str()); }
+
+    static Reading makeReading(std::uint64_t timestamp) { return Reading{"T", "12.5", timestamp}; }
+
+    static std::vector<std::uint64_t> timestamps(Persistence& persistence, const std::string& key,
+                                                 std::uint_fast64_t count = 1000)
+    {
+        auto result = std::vector<std::uint64_t>{};
+        for (const auto& reading : persistence.getReadings(key, count))
+            result.emplace_back(reading->getTimestamp());
+        return result;
+    }
+
+    static const std::string PATH;
+    static const std::uint64_t READING_SIZE;
+
+    BoundedInMemoryPersistence* diskTier;
+    std::unique_ptr<TieredPersistence> persistence;
+};
+
+const std::string TieredPersistenceTests::PATH = "./TieredPersistenceTests.bin";
+const std::uint64_t TieredPersistenceTests::READING_SIZE =
+  BoundedInMemoryPersistence::estimateSize(makeReading(0)) + std::string{"Device+T"}.size();
+
+TEST_F(TieredPersistenceTests, MissingDiskTier)
+{
+    EXPECT_THROW(TieredPersistence(nullptr), std::runtime_error);
+}
+
+TEST_F(TieredPersistenceTests, KeepsReadingsInMemoryUnderTheCap)
+{
+    for (auto i = std::uint64_t{1}; i <= 4; ++i)
+        EXPECT_TRUE(persistence->putReading("Device+T", makeReading(i)));
+    EXPECT_EQ(persistence->getSpilledReadingsCount(), 0u);
+    EXPECT_TRUE(diskTier->getReadingsKeys().empty());
+    EXPECT_EQ(persistence->getMemoryTierSize(), READING_SIZE * 4);
+    EXPECT_EQ(timestamps(*persistence, "Device+T"), (std::vector<std::uint64_t>{1, 2, 3, 4}));
+}
+
+TEST_F(TieredPersistenceTests, SpillsTheOldestReadings)
+{
+    EXPECT_TRUE(persistence->putReading("Device+T", makeReading(1)));
+    EXPECT_TRUE(persistence->putReading("Device+H", Reading{"T", "12.5", 2}));
+    for (auto i = std::uint64_t{3}; i <= 5; ++i)
+        EXPECT_TRUE(persistence->putReading("Device+T", makeReading(i)));
+
+    // Going over the cap spills down to three quarters of it
+    EXPECT_EQ(persistence->getSpilledReadingsCount(), 2u);
+    EXPECT_EQ(persistence->getMemoryTierSize(), READING_SIZE * 3);
+    EXPECT_EQ(timestamps(*diskTier, "Device+T"), (std::vector<std::uint64_t>{1}));
+    EXPECT_EQ(timestamps(*diskTier, "Device+H"), (std::vector<std::uint64_t>{2}));
+    EXPECT_EQ(persistence->getReadingsKeys().size(), 2u);
+
+    // Readings are returned and removed from the oldest one, across both tiers
+    EXPECT_EQ(timestamps(*persistence, "Device+T", 2), (std::vector<std::uint64_t>{1, 3}));
+    persistence->removeReadings("Device+T", 2);
+    EXPECT_TRUE(diskTier->getReadings("Device+T", 5).empty());
+    EXPECT_EQ(timestamps(*persistence, "Device+T"), (std::vector<std::uint64_t>{4, 5}));
+
+    persistence->removeReadings("Device+H", 1);
+    persistence->removeReadings("Device+T", 5);
+    EXPECT_TRUE(persistence->getReadingsKeys().empty());
+    EXPECT_TRUE(persistence->isEmpty());
+}
+
+TEST_F(TieredPersistenceTests, ReadingsDroppedByTheDiskTier)
+{
+    for (auto i = std::uint64_t{1}; i <= 6; ++i)
+        EXPECT_TRUE(persistence->putReading("Device+T", makeReading(i)));
+    ASSERT_EQ(persistence->m_feeds["Device+T"].spilled, 2u);
+
+    diskTier->removeReadings("Device+T", 1);
+    EXPECT_EQ(timestamps(*persistence, "Device+T", 3), (std::vector<std::uint64_t>{2, 3, 4}));
+    EXPECT_EQ(persistence->m_feeds["Device+T"].spilled, 1u);
+    persistence->removeReadings("Device+T", 3);
+    EXPECT_EQ(timestamps(*persistence, "Device+T"), (std::vector<std::uint64_t>{5, 6}));
+}
+
+TEST_F(TieredPersistenceTests, RecoversReadingsFromTheDisk)
+{
+    {
+        TieredPersistence tiered{std::unique_ptr<Persistence>{new MemoryMappedPersistence{PATH, 4, 4096}},
+                                 READING_SIZE * 4};
+        for (auto i = std::uint64_t{1}; i <= 6; ++i)
+            EXPECT_TRUE(tiered.putReading("Device+T", makeReading(i)));
+        EXPECT_EQ(tiered.getSpilledReadingsCount(), 2u);
+    }
+
+    TieredPersistence tiered{std::unique_ptr<Persistence>{new MemoryMappedPersistence{PATH, 4, 4096}},
+                             READING_SIZE * 4};
+    EXPECT_TRUE(tiered.putReading("Device+T", makeReading(7)));
+    EXPECT_EQ(timestamps(tiered, "Device+T"), (std::vector<std::uint64_t>{1, 2, 7}));
+}
+
+TEST_F(TieredPersistenceTests, LeftoverReadingsAreCountedAsTheyAreRead)
+{
+    auto leftover = std::unique_ptr<BoundedInMemoryPersistence>{new BoundedInMemoryPersistence{0, 0}};
+    for (auto i = std::uint64_t{1}; i <= 5; ++i)
+        EXPECT_TRUE(leftover->putReading("Device+T", makeReading(i)));
+    EXPECT_TRUE(leftover->putReading("Device+H", makeReading(1)));
+    TieredPersistence tiered{std::move(leftover), READING_SIZE * 4};
+
+    // Nothing is read until the readings are asked for
+    EXPECT_TRUE(tiered.m_feeds["Device+T"].uncounted);
+    EXPECT_EQ(tiered.m_feeds["Device+T"].spilled, 0u);
+    EXPECT_EQ(tiered.getReadingsKeys().size(), 2u);
+
+    EXPECT_EQ(timestamps(tiered, "Device+T", 2), (std::vector<std::uint64_t>{1, 2}));
+    EXPECT_TRUE(tiered.m_feeds["Device+T"].uncounted);
+    tiered.removeReadings("Device+T", 2);
+    EXPECT_TRUE(tiered.putReading("Device+T", makeReading(10)));
+    EXPECT_EQ(timestamps(tiered, "Device+T"), (std::vector<std::uint64_t>{3, 4, 5, 10}));
+    EXPECT_FALSE(tiered.m_feeds["Device+T"].uncounted);
+    EXPECT_EQ(tiered.m_feeds["Device+T"].spilled, 3u);
+
+    // Removing readings that were not read yet reads them first, so the ones in memory are not taken instead
+    tiered.removeReadings("Device+H", 1);
+    tiered.removeReadings("Device+T", 4);
+    EXPECT_TRUE(tiered.getReadingsKeys().empty());
+    EXPECT_TRUE(tiered.isEmpty());
+}
+
+TEST_F(TieredPersistenceTests, AttributesAndParametersAreKeptByTheDiskTier)
+{
+    EXPECT_TRUE(persistence->putAttribute("Device+A", std::make_shared<Attribute>("A", DataType::STRING, "Value")));
+    EXPECT_TRUE(persistence->putParameter("Device+P", Parameter{ParameterName::EXTERNAL_ID, "Value"}));
+    EXPECT_EQ(diskTier->getAttributeKeys(), std::vector<std::string>{"Device+A"});
+    EXPECT_EQ(persistence->getParameterForKey("Device+P").second, "Value");
+    EXPECT_FALSE(persistence->isEmpty());
+    persistence->removeAttributes("Device+A");
+    persistence->removeParameters();
+    EXPECT_TRUE(persistence->isEmpty());
+}
@@ -37,6 +37,7 @@
 #include "tests/mocks/PersistenceMock.h"
 #include "tests/mocks/PlatformStatusListenerMock.h"
 #include "tests/mocks/RegistrationProtocolMock.h"
+#include "wolk/utilities/ThreadTimer.h"
 
 #include <gmock/gmock.h>
 
@@ -147,6 +148,17 @@ TEST_F(WolkBuilderTests, FullSingleExample)
                  .parameterHandler(parameterHandlerMock)
                  .withPersistence(std::move(persistenceMock))
                  .withDataProtocol(std::move(dataProtocolMock))
+                 .withReadingsBatching(1024)
+                 .withFlushPolicy(100, std::chrono::milliseconds{500})
+                 .withReportingPolicy("T", ReportingPolicy::absoluteDeadband(0.5))
+                 .withRateLimit(100, 65536)
+                 .withReorderBuffer(std::chrono::seconds{5})
+                 .withLockFreeCommandQueue(256)
+                 .withCommandQueueLimit(128, BackpressureMode::CoalesceByFeed)
+                 .withReconnectPolicy(std::chrono::milliseconds{500}, std::chrono::minutes{5}, 3.0, 1.0)
+                 .withCatchUpAggregation(std::chrono::hours{1}, std::chrono::minutes{1})
+                 .withFeedPriority("LL", FeedPriority::Critical)
+                 .withPriorityPolicy(PriorityPolicy::weighted())
                  .withErrorProtocol(errorRetainTime, std::move(errorProtocolMock))
                  .withFileTransfer(fileDownloadLocation, maxPacketSize)
                  .withFileURLDownload(fileDownloadLocation, std::move(fileDownloaderMock), true, maxPacketSize)
@@ -155,6 +167,16 @@ TEST_F(WolkBuilderTests, FullSingleExample)
                  .buildWolkSingle();
     }());
     ASSERT_NE(wolk, nullptr);
+    EXPECT_NE(wolk->m_flushScheduler, nullptr);
+    EXPECT_EQ(wolk->m_dataService->getReportingPolicy("T").getMode(), ReportingMode::AbsoluteDeadband);
+    EXPECT_TRUE(wolk->m_dataService->getCatchUpPolicy().isEnabled());
+    EXPECT_EQ(wolk->m_dataService->getReorderLateness(), std::chrono::seconds{5});
+    EXPECT_EQ(wolk->m_dataService->getFeedPriority("LL"), FeedPriority::Critical);
+    EXPECT_EQ(wolk->m_dataService->getPriorityPolicy().getMode(), PriorityMode::Weighted);
+    EXPECT_EQ(wolk->m_commandBuffer->getCapacity(), 128u);
+    EXPECT_EQ(wolk->m_commandBuffer->getMode(), BackpressureMode::CoalesceByFeed);
+    EXPECT_EQ(wolk->m_reconnectPolicy.getMaxDelay(), std::chrono::minutes{5});
+    EXPECT_EQ(wolk->m_reconnectPolicy.getJitter(), 1.0);
 
     // Call some methods
     ASSERT_NO_FATAL_FAILURE(wolk->m_connectivityService->m_onConnectionLost());
@@ -165,6 +187,7 @@ TEST_F(WolkBuilderTests, FullSingleExample)
 
 TEST_F(WolkBuilderTests, FullMultiExample)
 {
+    auto executor = std::make_shared<SharedExecutor>(2);
     auto wolk = std::unique_ptr<WolkMulti>{};
     ASSERT_NO_FATAL_FAILURE([&] {
         wolk = WolkBuilder{devices}
@@ -183,9 +206,13 @@ TEST_F(WolkBuilderTests, FullMultiExample)
                  .withFirmwareUpdate(std::move(firmwareParameterListenerMock), fileDownloadLocation)
                  .withPlatformStatus(std::move(platformStatusListenerMock))
                  .withRegistration()
+                 .withSharedExecutor(executor)
                  .buildWolkMulti();
     }());
     ASSERT_NE(wolk, nullptr);
+    EXPECT_EQ(wolk->m_sharedExecutor, executor);
+    EXPECT_EQ(dynamic_cast<ThreadTimer*>(wolk->m_reconnectTimer.get()), nullptr);
+    EXPECT_EQ(dynamic_cast<ThreadTimer*>(wolk->m_errorService->m_timer.get()), nullptr);
 
     // Call some methods
     ASSERT_NO_FATAL_FAILURE(wolk->m_connectivityService->m_onConnectionLost());
@@ -252,6 +252,7 @@ TEST_F(WolkMultiTests, AddFeed)
       .WillOnce([&](const std::string&, const Feed&) {
           called = true;
           Notify();
+          return true;
       });
 
     // Call the service
@@ -277,6 +278,7 @@ TEST_F(WolkMultiTests, AddFeeds)
       .WillOnce([&](const std::string&, const std::vector<Feed>&) {
           called = true;
           Notify();
+          return true;
       });
 
     // Call the service
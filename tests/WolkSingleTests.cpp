@@ -15,7 +15,9 @@
  */
 
 #include <any>
+#include <future>
 #include <sstream>
+#include <thread>
 
 #define private public
 #define protected public
@@ -143,6 +145,25 @@ TEST_F(WolkSingleTests, AddReadingStringValue)
     EXPECT_TRUE(called);
 }
 
+TEST_F(WolkSingleTests, AddReadingNumericValue)
+{
+    // Set up the DataService to be called
+    std::atomic_bool called{false};
+    EXPECT_CALL(GetDataServiceReference(), addReading(device.getKey(), _, A<const ReadingValue&>(), _))
+      .WillOnce([&](const std::string&, const std::string&, const ReadingValue& value, std::uint64_t) {
+          EXPECT_EQ(value.getType(), ReadingValue::Type::Signed);
+          EXPECT_EQ(value.getSigned(), 42);
+          called = true;
+          Notify();
+      });
+
+    // Call the service
+    ASSERT_NO_FATAL_FAILURE(service->addReading("T", 42));
+    if (!called)
+        Await();
+    EXPECT_TRUE(called);
+}
+
 TEST_F(WolkSingleTests, AddReadingStringValues)
 {
     // Set up the DataService to be called
@@ -194,6 +215,33 @@ TEST_F(WolkSingleTests, AddReadingMultipleReadings)
     EXPECT_TRUE(called);
 }
 
+TEST_F(WolkSingleTests, AddReadingsBatch)
+{
+    // Set up the DataService to be called
+    std::atomic_bool called{false};
+    EXPECT_CALL(GetDataServiceReference(), addReadings(device.getKey(), A<const ReadingBatch&>()))
+      .WillOnce([&](const std::string&, const ReadingBatch& batch) {
+          EXPECT_EQ(batch.getReference(), "T");
+          EXPECT_EQ(batch.size(), 3u);
+          EXPECT_TRUE(batch.isValid());
+          called = true;
+          Notify();
+      });
+
+    // Call the service
+    ASSERT_NO_FATAL_FAILURE(service->addReadings(ReadingBatch{"T", std::vector<double>{1.0, 2.0, 3.0}}));
+    if (!called)
+        Await();
+    EXPECT_TRUE(called);
+}
+
+TEST_F(WolkSingleTests, AddReadingsBatchMismatchedColumns)
+{
+    EXPECT_CALL(GetDataServiceReference(), addReadings(device.getKey(), A<const ReadingBatch&>())).Times(0);
+    ASSERT_NO_FATAL_FAILURE(
+      service->addReadings(ReadingBatch{"T", std::vector<int>{1, 2, 3}, std::vector<std::uint64_t>{1, 2}}));
+}
+
 TEST_F(WolkSingleTests, AddFeed)
 {
     // Set up the DataService to be called
@@ -202,6 +250,7 @@ TEST_F(WolkSingleTests, AddFeed)
       .WillOnce([&](const std::string&, const Feed&) {
           called = true;
           Notify();
+          return true;
       });
 
     // Call the service
@@ -219,6 +268,7 @@ TEST_F(WolkSingleTests, AddFeeds)
       .WillOnce([&](const std::string&, const std::vector<Feed>&) {
           called = true;
           Notify();
+          return true;
       });
 
     // Call the service
@@ -298,13 +348,13 @@ TEST_F(WolkSingleTests, SynchronizeParameters)
 {
     // Set up the DataService to be called
     std::atomic_bool called{false};
-    EXPECT_CALL(GetDataServiceReference(), synchronizeParameters(device.getKey(), _, _))
-      .WillOnce(
-        [&](const std::string&, const std::vector<ParameterName>&, std::function<void(std::vector<Parameter>)>) {
-            called = true;
-            Notify();
-            return true;
-        });
+    EXPECT_CALL(GetDataServiceReference(), synchronizeParameters(device.getKey(), _, _, _))
+      .WillOnce([&](const std::string&, const std::vector<ParameterName>&,
+                    std::function<void(std::vector<Parameter>)>, std::function<void()>) {
+          called = true;
+          Notify();
+          return true;
+      });
 
     // Call the service
     ASSERT_NO_FATAL_FAILURE(service->synchronizeParameters({}, {}));
@@ -459,3 +509,211 @@ TEST_F(WolkSingleTests, ParameterUpdateHandlerLambda)
         Await();
     EXPECT_TRUE(called);
 }
+
+TEST_F(WolkSingleTests, FlushReadingsContinuesLeftoverBacklog)
+{
+    std::atomic_bool called{false};
+    EXPECT_CALL(GetDataServiceReference(), publishReadings(A<PublishBudget&>()))
+      .WillOnce(Return(true))
+      .WillOnce([&](PublishBudget&) {
+          called = true;
+          Notify();
+          return false;
+      });
+
+    ASSERT_NO_FATAL_FAILURE(service->flushReadings());
+    if (!called)
+        Await();
+    EXPECT_TRUE(called);
+}
+
+TEST_F(WolkSingleTests, PublishDuringLeftoverBacklogJoinsIt)
+{
+    std::atomic_bool called{false};
+    EXPECT_CALL(GetDataServiceReference(), publishReadings(A<PublishBudget&>()))
+      .WillOnce([&](PublishBudget&) {
+          // The request made while the first slice is published waits for the next slice, instead of starting another
+          service->publish([&](bool published) {
+              called = published;
+              Notify();
+          });
+          return true;
+      })
+      .WillOnce(Return(false));
+
+    ASSERT_NO_FATAL_FAILURE(service->publish());
+    if (!called)
+        Await();
+    EXPECT_TRUE(called);
+}
+
+TEST_F(WolkSingleTests, PublishCallsAreCoalesced)
+{
+    // Hold the command queue, so the publish calls pile up behind it
+    std::atomic_bool release{false};
+    service->addToCommandBuffer([&] {
+        while (!release)
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    });
+
+    // Set up the DataService to be flushed only once
+    EXPECT_CALL(GetDataServiceReference(), publishAttributes()).Times(1);
+    EXPECT_CALL(GetDataServiceReference(), publishReadings(A<PublishBudget&>())).WillOnce(Return(false));
+    EXPECT_CALL(GetDataServiceReference(), publishParameters()).Times(1);
+
+    // Call the service a couple of times
+    std::atomic<int> published{0};
+    for (auto i = 0; i < 3; ++i)
+        ASSERT_NO_FATAL_FAILURE(service->publish([&](bool) {
+            if (++published == 3)
+                Notify();
+        }));
+    ASSERT_NO_FATAL_FAILURE(service->publish());
+    release = true;
+
+    if (published < 3)
+        Await();
+    EXPECT_EQ(published, 3);
+}
+
+TEST_F(WolkSingleTests, ReconnectDoesNotBlockTheCommandQueue)
+{
+    // Set up the connection to fail, with a long wait for the next attempt
+    service->m_reconnectPolicy = ReconnectPolicy{std::chrono::seconds{10}, std::chrono::seconds{10}};
+    EXPECT_CALL(GetConnectivityServiceReference(), connect).WillOnce(Return(false));
+    ASSERT_NO_FATAL_FAILURE(service->connect());
+
+    // The commands queued after it still run while it waits
+    std::atomic_bool called{false};
+    service->addToCommandBuffer([&] {
+        called = true;
+        Notify();
+    });
+    if (!called)
+        Await();
+    EXPECT_TRUE(called);
+    EXPECT_EQ(service->m_reconnectAttempt, 1u);
+    EXPECT_FALSE(service->isConnected());
+}
+
+TEST_F(WolkSingleTests, ReconnectRetriesAfterTheDelay)
+{
+    std::atomic_bool called{false};
+    ASSERT_NO_FATAL_FAILURE(service->setConnectionStatusListener([&](bool status) {
+        called = status;
+        Notify();
+    }));
+    service->m_reconnectPolicy = ReconnectPolicy{std::chrono::milliseconds{10}, std::chrono::milliseconds{10}};
+    EXPECT_CALL(GetConnectivityServiceReference(), connect).WillOnce(Return(false)).WillOnce(Return(true));
+    ASSERT_NO_FATAL_FAILURE(service->connect());
+    if (!called)
+        Await();
+    EXPECT_TRUE(called);
+    EXPECT_EQ(service->m_reconnectAttempt, 0u);
+}
+
+TEST_F(WolkSingleTests, ConnectDoesNothingWhenConnected)
+{
+    std::atomic<int> called{0};
+    ASSERT_NO_FATAL_FAILURE(service->setConnectionStatusListener([&](bool) {
+        ++called;
+        Notify();
+    }));
+    EXPECT_CALL(GetConnectivityServiceReference(), connect).WillOnce(Return(true));
+    ASSERT_NO_FATAL_FAILURE(service->connect());
+    if (called == 0)
+        Await();
+
+    // The second attempt finds the connection established, and neither connects nor notifies again
+    ASSERT_NO_FATAL_FAILURE(service->connect());
+    std::atomic_bool executed{false};
+    service->addToCommandBuffer([&] {
+        executed = true;
+        Notify();
+    });
+    if (!executed)
+        Await();
+    EXPECT_EQ(called, 1);
+    EXPECT_TRUE(service->isConnected());
+}
+
+TEST_F(WolkSingleTests, PublishAsync)
+{
+    EXPECT_CALL(GetDataServiceReference(), publishReadings(A<PublishBudget&>())).WillOnce(Return(false));
+
+    auto future = service->publishAsync();
+    ASSERT_EQ(future.wait_for(std::chrono::seconds{1}), std::future_status::ready);
+    EXPECT_NO_THROW(future.get());
+}
+
+TEST_F(WolkSingleTests, PublishAsyncFailsToPublish)
+{
+    EXPECT_CALL(GetDataServiceReference(), publishReadings(A<PublishBudget&>()))
+      .WillOnce([](PublishBudget& budget) {
+          budget.fail();
+          return false;
+      });
+
+    auto future = service->publishAsync();
+    ASSERT_EQ(future.wait_for(std::chrono::seconds{1}), std::future_status::ready);
+    EXPECT_THROW(future.get(), std::runtime_error);
+}
+
+TEST_F(WolkSingleTests, RegisterFeedsAsync)
+{
+    EXPECT_CALL(GetDataServiceReference(), registerFeeds(device.getKey(), _)).WillOnce(Return(true));
+
+    auto future = service->registerFeedsAsync({Feed{"TestFeed", "TF", FeedType::IN_OUT, "NUMERIC"}});
+    ASSERT_EQ(future.wait_for(std::chrono::seconds{1}), std::future_status::ready);
+    EXPECT_NO_THROW(future.get());
+}
+
+TEST_F(WolkSingleTests, RegisterFeedsAsyncFailsToPublish)
+{
+    EXPECT_CALL(GetDataServiceReference(), registerFeeds(device.getKey(), _)).WillOnce(Return(false));
+
+    auto future = service->registerFeedsAsync({Feed{"TestFeed", "TF", FeedType::IN_OUT, "NUMERIC"}});
+    ASSERT_EQ(future.wait_for(std::chrono::seconds{1}), std::future_status::ready);
+    EXPECT_THROW(future.get(), std::runtime_error);
+}
+
+TEST_F(WolkSingleTests, SynchronizeParametersAsync)
+{
+    // Set up the DataService to respond right away
+    EXPECT_CALL(GetDataServiceReference(), synchronizeParameters(device.getKey(), _, _, _))
+      .WillOnce([&](const std::string&, const std::vector<ParameterName>&,
+                    std::function<void(std::vector<Parameter>)> callback, std::function<void()>) {
+          callback({Parameter{ParameterName::EXTERNAL_ID, "TestValue"}});
+          return true;
+      });
+
+    auto future = service->synchronizeParametersAsync({ParameterName::EXTERNAL_ID});
+    ASSERT_EQ(future.wait_for(std::chrono::seconds{1}), std::future_status::ready);
+    const auto parameters = future.get();
+    ASSERT_EQ(parameters.size(), 1u);
+    EXPECT_EQ(parameters.front().second, "TestValue");
+}
+
+TEST_F(WolkSingleTests, SynchronizeParametersAsyncFailsToSend)
+{
+    EXPECT_CALL(GetDataServiceReference(), synchronizeParameters(device.getKey(), _, _, _)).WillOnce(Return(false));
+
+    auto future = service->synchronizeParametersAsync({ParameterName::EXTERNAL_ID});
+    ASSERT_EQ(future.wait_for(std::chrono::seconds{1}), std::future_status::ready);
+    EXPECT_THROW(future.get(), std::runtime_error);
+}
+
+TEST_F(WolkSingleTests, SynchronizeParametersAsyncTimesOut)
+{
+    // Set up the DataService as if the platform never responded
+    EXPECT_CALL(GetDataServiceReference(), synchronizeParameters(device.getKey(), _, _, _))
+      .WillOnce([&](const std::string&, const std::vector<ParameterName>&,
+                    std::function<void(std::vector<Parameter>)>, std::function<void()> timeoutCallback) {
+          timeoutCallback();
+          return true;
+      });
+
+    auto future = service->synchronizeParametersAsync({ParameterName::EXTERNAL_ID});
+    ASSERT_EQ(future.wait_for(std::chrono::seconds{1}), std::future_status::ready);
+    EXPECT_THROW(future.get(), std::runtime_error);
+}
@@ -38,26 +38,32 @@ public:
     MOCK_METHOD(void, addReading, (const std::string&, const std::string&, const std::string&, std::uint64_t));
     MOCK_METHOD(void, addReading,
                 (const std::string&, const std::string&, const std::vector<std::string>&, std::uint64_t));
+    MOCK_METHOD(void, addReading, (const std::string&, const std::string&, const ReadingValue&, std::uint64_t));
     MOCK_METHOD(void, addReading, (const std::string&, const Reading&));
     MOCK_METHOD(void, addReadings, (const std::string&, const std::vector<Reading>&));
+    MOCK_METHOD(void, addReadings, (const std::string&, const ReadingBatch&));
     MOCK_METHOD(void, addAttribute, (const std::string&, const Attribute&));
     MOCK_METHOD(void, updateParameter, (const std::string&, const Parameter&));
-    MOCK_METHOD(void, registerFeed, (const std::string&, Feed));
-    MOCK_METHOD(void, registerFeeds, (const std::string&, std::vector<Feed>));
+    MOCK_METHOD(bool, registerFeed, (const std::string&, Feed));
+    MOCK_METHOD(bool, registerFeeds, (const std::string&, std::vector<Feed>));
     MOCK_METHOD(void, removeFeed, (const std::string&, std::string));
     MOCK_METHOD(void, removeFeeds, (const std::string&, std::vector<std::string>));
     MOCK_METHOD(void, pullFeedValues, (const std::string&));
     MOCK_METHOD(void, pullParameters, (const std::string&));
     MOCK_METHOD(bool, synchronizeParameters,
-                (const std::string&, const std::vector<ParameterName>&, std::function<void(std::vector<Parameter>)>));
+                (const std::string&, const std::vector<ParameterName>&, std::function<void(std::vector<Parameter>)>,
+                 std::function<void()>));
     MOCK_METHOD(bool, detailsSynchronizationAsync,
                 (const std::string&, std::function<void(std::vector<std::string>, std::vector<std::string>)>));
     MOCK_METHOD(void, publishReadings, ());
     MOCK_METHOD(void, publishReadings, (const std::string&));
+    MOCK_METHOD(bool, publishReadings, (PublishBudget&));
     MOCK_METHOD(void, publishAttributes, ());
     MOCK_METHOD(void, publishAttributes, (const std::string&));
     MOCK_METHOD(void, publishParameters, ());
     MOCK_METHOD(void, publishParameters, (const std::string&));
+    MOCK_METHOD(void, setReportingPolicy, (const std::string&, const ReportingPolicy&));
+    MOCK_METHOD(void, setFeedPriority, (const std::string&, FeedPriority));
 };
 
 #endif    // WOLKABOUTCONNECTOR_DATASERVICEMOCK_H
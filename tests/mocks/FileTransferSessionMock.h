@@ -21,6 +21,7 @@
 #include "core/model/messages/FileBinaryResponseMessage.h"
 #include "core/model/messages/FileUploadInitiateMessage.h"
 #include "wolk/service/file_management/FileTransferSession.h"
+#include "wolk/utilities/CommandQueue.h"
 
 #include <gmock/gmock.h>
 
@@ -52,7 +53,7 @@ public:
     MOCK_METHOD(const std::vector<FileChunk>&, getChunks, (), (const));
 
 private:
-    CommandBuffer buffer;
+    CommandQueue buffer;
 };
 
 #endif    // WOLKABOUTCONNECTOR_FILETRANSFERSESSIONMOCK_H
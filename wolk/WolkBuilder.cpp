@@ -34,6 +34,8 @@
 #include "wolk/service/data/DataService.h"
 #include "wolk/service/file_management/FileManagementService.h"
 #include "wolk/service/firmware_update/FirmwareUpdateService.h"
+#include "wolk/utilities/CommandQueue.h"
+#include "wolk/utilities/RingCommandQueue.h"
 
 #include <stdexcept>
 #include <utility>
@@ -47,6 +49,13 @@ WolkBuilder::WolkBuilder(std::vector<Device> devices)
 , m_host(WOLK_DEMO_HOST)
 , m_caCertPath(TRUST_STORE)
 , m_persistence{new InMemoryPersistence}
+, m_readingsBatching(false)
+, m_readingsBatchPayloadSize{0}
+, m_reorderLateness{0}
+, m_lockFreeCommandQueue(false)
+, m_commandQueueCapacity{0}
+, m_commandQueueLimit{0}
+, m_backpressureMode(BackpressureMode::Block)
 , m_dataProtocol{new WolkaboutDataProtocol}
 , m_errorProtocol{new WolkaboutErrorProtocol}
 , m_errorRetainTime{1000}
@@ -61,6 +70,13 @@ WolkBuilder::WolkBuilder(Device device)
 , m_host{WOLK_DEMO_HOST}
 , m_caCertPath{TRUST_STORE}
 , m_persistence{new InMemoryPersistence}
+, m_readingsBatching(false)
+, m_readingsBatchPayloadSize{0}
+, m_reorderLateness{0}
+, m_lockFreeCommandQueue(false)
+, m_commandQueueCapacity{0}
+, m_commandQueueLimit{0}
+, m_backpressureMode(BackpressureMode::Block)
 , m_dataProtocol{new WolkaboutDataProtocol}
 , m_errorProtocol{new WolkaboutErrorProtocol}
 , m_errorRetainTime{1000}
@@ -129,6 +145,91 @@ WolkBuilder& WolkBuilder::withDataProtocol(std::unique_ptr<DataProtocol> protoco
     return *this;
 }
 
+WolkBuilder& WolkBuilder::withReadingsBatching(std::uint64_t maxPayloadSize)
+{
+    m_readingsBatching = true;
+    m_readingsBatchPayloadSize = maxPayloadSize;
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withPublishBudget(std::uint64_t messages, std::uint64_t bytes, std::chrono::milliseconds time)
+{
+    m_publishBudget = PublishBudget{messages, bytes, time};
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withFlushPolicy(std::uint64_t bufferedCount, std::chrono::milliseconds maxAge,
+                                          std::chrono::milliseconds minInterval)
+{
+    m_flushPolicy = FlushPolicy{bufferedCount, maxAge, minInterval};
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withReportingPolicy(const std::string& reference, const ReportingPolicy& policy)
+{
+    m_reportingPolicies[reference] = policy;
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withRateLimit(std::uint64_t messagesPerSecond, std::uint64_t bytesPerSecond,
+                                        std::uint64_t messageBurst, std::uint64_t byteBurst)
+{
+    m_rateLimiter = RateLimiter{messagesPerSecond, bytesPerSecond, messageBurst, byteBurst};
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withReorderBuffer(std::chrono::milliseconds lateness)
+{
+    m_reorderLateness = lateness;
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withLockFreeCommandQueue(std::size_t capacity)
+{
+    m_lockFreeCommandQueue = true;
+    m_commandQueueCapacity = capacity;
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withSharedExecutor(std::shared_ptr<SharedExecutor> executor)
+{
+    m_sharedExecutor = std::move(executor);
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withCommandQueueLimit(std::size_t capacity, BackpressureMode mode)
+{
+    m_commandQueueLimit = capacity;
+    m_backpressureMode = mode;
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withReconnectPolicy(std::chrono::milliseconds initialDelay,
+                                              std::chrono::milliseconds maxDelay, double multiplier, double jitter)
+{
+    m_reconnectPolicy = ReconnectPolicy{initialDelay, maxDelay, multiplier, jitter};
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withCatchUpAggregation(std::chrono::milliseconds maxAge, std::chrono::milliseconds window,
+                                                 AggregateFunction numericFunction, AggregateFunction textFunction)
+{
+    m_catchUpPolicy = CatchUpPolicy{maxAge, window, numericFunction, textFunction};
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withFeedPriority(const std::string& reference, FeedPriority priority)
+{
+    m_feedPriorities[reference] = priority;
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withPriorityPolicy(const PriorityPolicy& policy)
+{
+    m_priorityPolicy = policy;
+    return *this;
+}
+
 WolkBuilder& WolkBuilder::withErrorProtocol(std::chrono::milliseconds errorRetainTime,
                                             std::unique_ptr<ErrorProtocol> protocol)
 {
@@ -238,6 +339,25 @@ std::unique_ptr<WolkInterface> WolkBuilder::build(WolkInterfaceType type)
     default:
         throw std::runtime_error("Unsupported type of `WolkInterface` for this builder.");
     }
+    // Set up the command queue the calls of the Wolk module go through
+    wolk->m_sharedExecutor = m_sharedExecutor;
+    auto executor = std::unique_ptr<CommandExecutor>{};
+    if (m_lockFreeCommandQueue)
+        executor.reset(new RingCommandQueue{m_commandQueueCapacity});
+    else if (m_sharedExecutor != nullptr)
+        executor = m_sharedExecutor->makeStrand();
+    if (executor != nullptr || m_commandQueueLimit > 0)
+    {
+        if (executor == nullptr)
+            executor.reset(new CommandQueue);
+        wolk->m_commandBuffer.reset(
+          new BoundedCommandQueue{std::move(executor), m_commandQueueLimit, m_backpressureMode});
+    }
+    if (m_sharedExecutor != nullptr)
+    {
+        wolk->m_throttleTimer = m_sharedExecutor->makeTimer();
+        wolk->m_reconnectTimer = m_sharedExecutor->makeTimer();
+    }
 
     // Create the inbound message handler that will route all the messages by topic to their right destination
     for (const auto& device : m_devices)
@@ -273,7 +393,7 @@ std::unique_ptr<WolkInterface> WolkBuilder::build(WolkInterfaceType type)
     auto wolkRaw = wolk.get();
     wolk->m_connectivityService->onConnectionLost([wolkRaw] {
         wolkRaw->notifyDisconnected();
-        wolkRaw->tryConnect(true);
+        wolkRaw->reconnect();
     });
     wolk->m_connectivityService->setListner(wolk->m_inboundMessageHandler);
 
@@ -285,6 +405,11 @@ std::unique_ptr<WolkInterface> WolkBuilder::build(WolkInterfaceType type)
     wolk->m_feedUpdateHandler = m_feedUpdateHandler;
     wolk->m_parameterLambda = m_parameterHandlerLambda;
     wolk->m_parameterHandler = m_parameterHandler;
+    wolk->m_publishBudget = m_publishBudget;
+    wolk->m_reconnectPolicy = m_reconnectPolicy;
+    if (m_flushPolicy.isEnabled())
+        wolk->m_flushScheduler.reset(
+          new FlushScheduler{m_flushPolicy, [wolkRaw] { wolkRaw->scheduledFlush(); }, makeTimer()});
     wolk->m_dataService = std::make_shared<DataService>(
       *wolk->m_dataProtocol, *wolk->m_persistence, *wolk->m_connectivityService, *wolk->m_outboundRetryMessageHandler,
       [wolkRaw](const std::string& deviceKey, const std::map<std::uint64_t, std::vector<Reading>>& readings) {
@@ -302,8 +427,22 @@ std::unique_ptr<WolkInterface> WolkBuilder::build(WolkInterfaceType type)
           LOG(INFO) << "\tParameters:";
           for (const auto& parameter : parameters)
               LOG(INFO) << "\t\t" << parameter;
-      });
-    wolk->m_errorService = std::make_shared<ErrorService>(*wolk->m_errorProtocol, m_errorRetainTime);
+      },
+      makeStrand());
+    if (m_readingsBatching)
+        wolk->m_dataService->setReadingsBatching(true, m_readingsBatchPayloadSize);
+    for (const auto& policy : m_reportingPolicies)
+        wolk->m_dataService->setReportingPolicy(policy.first, policy.second);
+    if (m_catchUpPolicy.isEnabled())
+        wolk->m_dataService->setCatchUpPolicy(m_catchUpPolicy);
+    if (m_rateLimiter.isEnabled())
+        wolk->m_dataService->setRateLimiter(m_rateLimiter);
+    if (m_reorderLateness.count() > 0)
+        wolk->m_dataService->setReorderLateness(m_reorderLateness);
+    for (const auto& priority : m_feedPriorities)
+        wolk->m_dataService->setFeedPriority(priority.first, priority.second);
+    wolk->m_dataService->setPriorityPolicy(m_priorityPolicy);
+    wolk->m_errorService = std::make_shared<ErrorService>(*wolk->m_errorProtocol, m_errorRetainTime, makeTimer());
     wolk->m_inboundMessageHandler->addListener(wolk->m_dataService);
     wolk->m_inboundMessageHandler->addListener(wolk->m_errorService);
     wolk->m_errorService->start();
@@ -315,7 +454,8 @@ std::unique_ptr<WolkInterface> WolkBuilder::build(WolkInterfaceType type)
         wolk->m_fileManagementProtocol = std::move(m_fileManagementProtocol);
         wolk->m_fileManagementService = std::make_shared<FileManagementService>(
           *wolk->m_connectivityService, *wolk->m_dataService, *wolk->m_fileManagementProtocol, m_fileDownloadDirectory,
-          m_fileTransferEnabled, m_fileTransferUrlEnabled, std::move(m_fileDownloader), std::move(m_fileListener));
+          m_fileTransferEnabled, m_fileTransferUrlEnabled, std::move(m_fileDownloader), std::move(m_fileListener),
+          makeStrand());
 
         // Trigger the on build and add the listener for MQTT messages
         wolk->m_fileManagementService->createFolder();
@@ -376,7 +516,8 @@ std::unique_ptr<WolkInterface> WolkBuilder::build(WolkInterfaceType type)
         // Create the service
         wolk->m_platformStatusProtocol = std::move(m_platformStatusProtocol);
         wolk->m_platformStatusService =
-          std::make_shared<PlatformStatusService>(*wolk->m_platformStatusProtocol, std::move(m_platformStatusListener));
+          std::make_shared<PlatformStatusService>(*wolk->m_platformStatusProtocol, std::move(m_platformStatusListener),
+                                                  makeStrand());
         wolk->m_inboundMessageHandler->addListener(wolk->m_platformStatusService);
     }
 
@@ -386,7 +527,8 @@ std::unique_ptr<WolkInterface> WolkBuilder::build(WolkInterfaceType type)
         // Create the service
         wolk->m_registrationProtocol = std::move(m_registrationProtocol);
         wolk->m_registrationService =
-          std::make_shared<RegistrationService>(*wolk->m_registrationProtocol, *wolk->m_connectivityService);
+          std::make_shared<RegistrationService>(*wolk->m_registrationProtocol, *wolk->m_connectivityService,
+                                                makeStrand());
         wolk->m_inboundMessageHandler->addListener(wolk->m_registrationService);
     }
 
@@ -425,5 +567,19 @@ std::unique_ptr<WolkMulti> WolkBuilder::buildWolkMulti()
     // Cast the build pointer into the right type of unique_ptr.
     return std::unique_ptr<WolkMulti>(dynamic_cast<WolkMulti*>(build(WolkInterfaceType::MultiDevice).release()));
 }
+
+std::unique_ptr<CommandExecutor> WolkBuilder::makeStrand() const
+{
+    if (m_sharedExecutor == nullptr)
+        return nullptr;
+    return m_sharedExecutor->makeStrand();
+}
+
+std::unique_ptr<CommandTimer> WolkBuilder::makeTimer() const
+{
+    if (m_sharedExecutor == nullptr)
+        return nullptr;
+    return m_sharedExecutor->makeTimer();
+}
 }    // namespace connect
 }    // namespace wolkabout
@@ -32,10 +32,20 @@
 #include "wolk/api/FirmwareParametersListener.h"
 #include "wolk/api/ParameterHandler.h"
 #include "wolk/api/PlatformStatusListener.h"
+#include "wolk/service/data/CatchUpPolicy.h"
+#include "wolk/service/data/FlushPolicy.h"
+#include "wolk/service/data/PriorityPolicy.h"
+#include "wolk/service/data/PublishBudget.h"
+#include "wolk/service/data/RateLimiter.h"
+#include "wolk/service/data/ReportingPolicy.h"
 #include "wolk/service/file_management/FileDownloader.h"
+#include "wolk/utilities/BoundedCommandQueue.h"
+#include "wolk/utilities/ReconnectPolicy.h"
+#include "wolk/utilities/SharedExecutor.h"
 
 #include <cstdint>
 #include <functional>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -128,6 +138,11 @@ public:
     /**
      * @brief Sets underlying persistence mechanism to be used<br>
      *        Sample in-memory persistence is used as default
+     * @details To keep the readings through outages and restarts with a bounded footprint, use the file backed
+     * wolkabout::connect::MemoryMappedPersistence. To only cap the memory used by the readings, use the
+     * wolkabout::connect::BoundedInMemoryPersistence. To keep the newest readings in memory and spill the older ones to
+     * the disk, wrap the file backed persistence in the wolkabout::connect::TieredPersistence. To fit longer backlogs
+     * in memory, use the wolkabout::connect::CompressedPersistence.
      * @param persistence std::shared_ptr to wolkabout::Persistence implementation
      * @return Reference to current wolkabout::WolkBuilder instance (Provides fluent interface)
      */
@@ -140,6 +155,156 @@ public:
      */
     WolkBuilder& withDataProtocol(std::unique_ptr<DataProtocol> protocol);
 
+    /**
+     * @brief Sets the Wolk module to batch the readings of a device across all of its feeds when publishing.
+     * @details Instead of sending a message for every feed, all the pending readings of a device will be grouped into
+     * as few messages as possible, while keeping every message under the given payload size.
+     * @param maxPayloadSize The maximum size of a single message payload (in bytes). Zero keeps the default size of the
+     * `DataService`.
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides fluent interface)
+     */
+    WolkBuilder& withReadingsBatching(std::uint64_t maxPayloadSize = 0);
+
+    /**
+     * @brief Sets the limits for a single pass of publishing readings.
+     * @details When a backlog of readings is being published, once any of the limits is reached the rest of the
+     * backlog will be published after the other waiting commands are executed. A limit of zero is not enforced.
+     * @param messages The maximum count of messages sent in a single pass.
+     * @param bytes The maximum count of payload bytes sent in a single pass.
+     * @param time The maximum time spent publishing in a single pass.
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides fluent interface)
+     */
+    WolkBuilder& withPublishBudget(std::uint64_t messages, std::uint64_t bytes = 0,
+                                   std::chrono::milliseconds time = std::chrono::milliseconds{0});
+
+    /**
+     * @brief Sets the Wolk module to publish the buffered data automatically, without the need to call `publish`.
+     * @details A flush is triggered once enough readings, attributes and parameters are buffered, once the oldest of
+     * them is old enough, or once the interval passes while anything is buffered. The interval is also the minimum time
+     * between two automatic flushes. Triggers set to zero are not used.
+     * @param bufferedCount The count of buffered items that triggers a flush.
+     * @param maxAge The age of the oldest buffered item that triggers a flush.
+     * @param minInterval The interval of flushes, and the minimum time between two flushes.
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides fluent interface)
+     */
+    WolkBuilder& withFlushPolicy(std::uint64_t bufferedCount,
+                                 std::chrono::milliseconds maxAge = std::chrono::milliseconds{0},
+                                 std::chrono::milliseconds minInterval = std::chrono::milliseconds{0});
+
+    /**
+     * @brief Sets the policy deciding which readings of feeds with the reference are worth publishing.
+     * @details Readings are checked against the last reported reading of the same feed before they are stored, and
+     * the ones the policy filters out are dropped. The policy applies to feeds with the reference on all devices, and
+     * can be changed later using `setReportingPolicy`.
+     * @param reference The feed reference.
+     * @param policy The policy, for example `ReportingPolicy::absoluteDeadband(0.5, std::chrono::minutes{5})`.
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides fluent interface)
+     */
+    WolkBuilder& withReportingPolicy(const std::string& reference, const ReportingPolicy& policy);
+
+    /**
+     * @brief Sets the rate limits for publishing readings, so a backlog trickles out instead of flooding the broker.
+     * @details Messages go out as long as the token buckets are not empty, which refill at the set rates up to their
+     * burst size. Once they run dry, publishing continues after they refill. A rate of zero is not enforced.
+     * @param messagesPerSecond The maximum count of messages per second.
+     * @param bytesPerSecond The maximum count of payload bytes per second.
+     * @param messageBurst The count of messages that can go out at once. Zero means one second of messages.
+     * @param byteBurst The count of payload bytes that can go out at once. Zero means one second of bytes.
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides fluent interface)
+     */
+    WolkBuilder& withRateLimit(std::uint64_t messagesPerSecond, std::uint64_t bytesPerSecond = 0,
+                               std::uint64_t messageBurst = 0, std::uint64_t byteBurst = 0);
+
+    /**
+     * @brief Sets the Wolk module to hold back readings for a lateness window, to put them in order.
+     * @details Readings that arrive out of order, for example when a subdevice replays its buffer, are stored in the
+     * order of their timestamps, and readings of a feed repeating both the timestamp and the value are collapsed.
+     * Readings are published once they have waited for the window.
+     * @param lateness The time readings are held back for.
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides fluent interface)
+     */
+    WolkBuilder& withReorderBuffer(std::chrono::milliseconds lateness);
+
+    /**
+     * @brief Sets the Wolk module to execute its commands on a lock-free ring of commands.
+     * @details Calls made from many threads at once then no longer contend on a lock. When the ring is full, the
+     * commands are kept aside in a list, behind a lock, until the ring has room again.
+     * @param capacity The number of commands the ring can hold. It is rounded up to a power of two.
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides fluent interface)
+     */
+    WolkBuilder& withLockFreeCommandQueue(std::size_t capacity = 1024);
+
+    /**
+     * @brief Sets the Wolk module to run the commands of all its services on a shared pool of worker threads.
+     * @details Every service gets its own strand on the executor, so its commands still execute one by one and in
+     * order. The timers of the Wolk module and its services are serviced by the same workers. The same executor can be
+     * shared by several Wolk modules. A lock-free command queue, if set, still runs the commands of the Wolk module on
+     * its own thread.
+     * @param executor The executor that will run the commands.
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides fluent interface)
+     */
+    WolkBuilder& withSharedExecutor(std::shared_ptr<SharedExecutor> executor);
+
+    /**
+     * @brief Sets the Wolk module to limit the count of added readings that wait in its command queue to be stored.
+     * @details Once the limit is reached, the `addReading` calls wait for room, are refused and return false, or keep
+     * only the latest reading of every feed aside until there is room, depending on the mode. The depth of the queue
+     * is available through `getCommandQueueDepth`.
+     * @param capacity The count of calls that may wait at once.
+     * @param mode The way the calls are held back once the queue is full.
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides fluent interface)
+     */
+    WolkBuilder& withCommandQueueLimit(std::size_t capacity, BackpressureMode mode = BackpressureMode::Block);
+
+    /**
+     * @brief Sets how long the Wolk module waits before each attempt to reconnect to the platform.
+     * @details The delay starts at the initial delay after the connection is lost or an attempt fails, and grows by
+     * the multiplier with every failed attempt up to the maximum delay. A random part of every delay, up to the jitter
+     * fraction of it, is left out, so a fleet of devices does not reconnect all at once. Attempts are driven by a
+     * timer, so the command queue keeps running while the module waits.
+     * @param initialDelay The delay before the first attempt.
+     * @param maxDelay The longest delay between two attempts.
+     * @param multiplier The factor the delay grows by after a failed attempt.
+     * @param jitter The fraction of the delay that is randomized, between zero and one.
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides fluent interface)
+     */
+    WolkBuilder& withReconnectPolicy(std::chrono::milliseconds initialDelay, std::chrono::milliseconds maxDelay,
+                                     double multiplier = 2.0, double jitter = 0.5);
+
+    /**
+     * @brief Sets the Wolk module to fold old readings when publishing a backlog, for example after an outage.
+     * @details Stored readings older than the maximum age are folded into one reading per window of every feed before
+     * they are published, while the newer readings are published as they are. Numeric readings are folded with the
+     * numeric function, and other readings keep the first or the last reading of the window.
+     * @param maxAge The age after which readings are folded.
+     * @param window The length of the window readings are folded in.
+     * @param numericFunction The function folding numeric readings.
+     * @param textFunction The function folding other readings, either `AggregateFunction::First` or `Last`.
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides fluent interface)
+     */
+    WolkBuilder& withCatchUpAggregation(std::chrono::milliseconds maxAge, std::chrono::milliseconds window,
+                                        AggregateFunction numericFunction = AggregateFunction::Average,
+                                        AggregateFunction textFunction = AggregateFunction::Last);
+
+    /**
+     * @brief Sets the priority class readings of feeds with the reference are published in.
+     * @details Readings of feeds in a higher class are published before the others, so control-plane and alarm feeds
+     * reach the platform first after a reconnect. The priority can be changed later using `setFeedPriority`.
+     * @param reference The feed reference.
+     * @param priority The priority class of the feed.
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides fluent interface)
+     */
+    WolkBuilder& withFeedPriority(const std::string& reference, FeedPriority priority);
+
+    /**
+     * @brief Sets the order in which the priority classes are drained when publishing readings.
+     * @details The classes are drained in strict order by default. A weighted policy lets every class send its weight
+     * of messages in turn, so the lower classes are not starved by a busy higher class.
+     * @param policy The policy, for example `PriorityPolicy::weighted({{8, 4, 2, 1}})`.
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides fluent interface)
+     */
+    WolkBuilder& withPriorityPolicy(const PriorityPolicy& policy);
+
     /**
      * @brief withErrorProtocol Defines which error protocol to use
      * @param errorRetainTime The time defining how long will the error messages be retained. The default retain time is
@@ -243,6 +408,12 @@ public:
     std::unique_ptr<WolkMulti> buildWolkMulti();
 
 private:
+    // Makes a strand of the shared executor for a service, or nothing when the service should run its own thread
+    std::unique_ptr<CommandExecutor> makeStrand() const;
+
+    // Makes a timer of the shared executor for a service, or nothing when the service should run its own thread
+    std::unique_ptr<CommandTimer> makeTimer() const;
+
     // Here we store the list of devices that the Wolk instance will handle
     std::vector<Device> m_devices;
 
@@ -261,6 +432,24 @@ private:
     // Here is the place for the persistence pointer
     std::unique_ptr<Persistence> m_persistence;
 
+    // Here is the place for the reading batching parameters
+    bool m_readingsBatching;
+    std::uint64_t m_readingsBatchPayloadSize;
+    PublishBudget m_publishBudget;
+    RateLimiter m_rateLimiter;
+    std::chrono::milliseconds m_reorderLateness;
+    bool m_lockFreeCommandQueue;
+    std::size_t m_commandQueueCapacity;
+    std::shared_ptr<SharedExecutor> m_sharedExecutor;
+    std::size_t m_commandQueueLimit;
+    BackpressureMode m_backpressureMode;
+    ReconnectPolicy m_reconnectPolicy;
+    FlushPolicy m_flushPolicy;
+    std::map<std::string, ReportingPolicy> m_reportingPolicies;
+    CatchUpPolicy m_catchUpPolicy;
+    std::map<std::string, FeedPriority> m_feedPriorities;
+    PriorityPolicy m_priorityPolicy;
+
     // Here is the place for all the protocols that are being held
     std::unique_ptr<DataProtocol> m_dataProtocol;
     std::unique_ptr<ErrorProtocol> m_errorProtocol;
@@ -28,6 +28,12 @@
 #include "wolk/service/firmware_update/FirmwareUpdateService.h"
 #include "wolk/service/platform_status/PlatformStatusService.h"
 #include "wolk/service/registration_service/RegistrationService.h"
+#include "wolk/utilities/ThreadTimer.h"
+
+#include <exception>
+#include <functional>
+#include <stdexcept>
+#include <utility>
 
 namespace wolkabout
 {
@@ -43,6 +49,7 @@ void WolkInterface::connect()
 void WolkInterface::disconnect()
 {
     addToCommandBuffer([=]() -> void {
+        m_reconnectTimer->stop();
         m_connectivityService->disconnect();
         notifyDisconnected();
     });
@@ -58,37 +65,113 @@ void WolkInterface::setConnectionStatusListener(ConnectionStatusListener listene
     m_connectionStatusListener = listener;
 }
 
-void WolkInterface::publish()
+void WolkInterface::publish(PublishCallback callback)
 {
-    addToCommandBuffer([=]() -> void {
-        flushAttributes();
-        flushReadings();
-        flushParameters();
+    requestFlush(std::move(callback));
+}
+
+std::future<void> WolkInterface::publishAsync()
+{
+    auto promise = std::make_shared<std::promise<void>>();
+    auto future = promise->get_future();
+    publish([promise](bool published) {
+        if (published)
+            promise->set_value();
+        else
+            promise->set_exception(std::make_exception_ptr(std::runtime_error{"Failed to publish the readings."}));
     });
+    return future;
 }
 
-WolkInterface::WolkInterface() : m_connected(false), m_commandBuffer(new CommandBuffer) {}
+void WolkInterface::setReportingPolicy(const std::string& reference, const ReportingPolicy& policy)
+{
+    addToCommandBuffer([=] { m_dataService->setReportingPolicy(reference, policy); });
+}
+
+void WolkInterface::setFeedPriority(const std::string& reference, FeedPriority priority)
+{
+    addToCommandBuffer([=] { m_dataService->setFeedPriority(reference, priority); });
+}
+
+RateLimiterMetrics WolkInterface::getRateLimiterMetrics() const
+{
+    return m_dataService->getRateLimiterMetrics();
+}
+
+std::size_t WolkInterface::getCommandQueueDepth() const
+{
+    return m_commandBuffer->getDepth();
+}
+
+void WolkInterface::notifyDelivered(std::shared_ptr<Message> message)
+{
+    addToCommandBuffer([=] {
+        m_dataService->notifyDelivered(message);
+        if (m_flushStalled.exchange(false))
+            continueFlush();
+    });
+}
+
+WolkInterface::WolkInterface()
+: m_connected(false)
+, m_commandBuffer(new BoundedCommandQueue{std::unique_ptr<CommandExecutor>{new CommandQueue}})
+, m_throttledFlushScheduled(false)
+, m_throttleTimer(new ThreadTimer)
+, m_flushStalled(false)
+, m_flushContinuing(false)
+, m_flushPending(false)
+, m_reconnectAttempt{0}
+, m_reconnectRandom(std::random_device{}())
+, m_reconnectTimer(new ThreadTimer)
+{
+}
 
 void WolkInterface::tryConnect(bool firstTime)
 {
     addToCommandBuffer([=]() -> void {
+        // An attempt scheduled before the connection was established has nothing left to do
+        if (m_connected)
+            return;
+
         if (firstTime)
+        {
             LOG(INFO) << "Connecting...";
+            m_reconnectAttempt = 0;
+        }
 
         if (!m_connectivityService->connect())
         {
             if (firstTime)
                 LOG(INFO) << "Failed to connect";
 
-            std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-            tryConnect(false);
+            scheduleReconnect();
             return;
         }
 
+        m_reconnectTimer->stop();
+        m_reconnectAttempt = 0;
         notifyConnected();
     });
 }
 
+void WolkInterface::reconnect()
+{
+    addToCommandBuffer([=]() -> void {
+        m_reconnectAttempt = 0;
+        scheduleReconnect();
+    });
+}
+
+void WolkInterface::scheduleReconnect()
+{
+    // Wait for the next attempt on the timer, so the commands keep running in the meantime
+    auto random = std::uniform_real_distribution<double>{0.0, 1.0};
+    const auto delay = m_reconnectPolicy.getDelay(m_reconnectAttempt++, random(m_reconnectRandom));
+    LOG(DEBUG) << "Reconnecting in " << delay.count() << "ms";
+    m_reconnectTimer->stop();
+    m_reconnectTimer->start(delay, [this] { tryConnect(false); });
+}
+
 void WolkInterface::notifyConnected()
 {
     LOG(INFO) << "Connection established";
@@ -97,6 +180,8 @@ void WolkInterface::notifyConnected()
 
     if (m_registrationService != nullptr)
         m_registrationService->start();
+    if (m_flushScheduler != nullptr)
+        m_flushScheduler->start();
 
     notifyConnectionStatusListener();
     publish();
@@ -107,6 +192,11 @@ void WolkInterface::notifyDisconnected()
     LOG(INFO) << "Connection lost";
 
     m_connected = false;
+    if (m_flushScheduler != nullptr)
+        m_flushScheduler->stop();
+    m_dataService->requeueInFlight();
+    if (m_flushStalled.exchange(false))
+        addToCommandBuffer([this] { continueFlush(); });
     notifyConnectionStatusListener();
 }
 
@@ -114,10 +204,10 @@ void WolkInterface::notifyConnectionStatusListener()
 {
     if (m_connectionStatusListener)
     {
-        m_commandBuffer->pushCommand(std::make_shared<std::function<void()>>([this]() {
+        addToCommandBuffer([this]() {
             if (m_connectionStatusListener)
                 m_connectionStatusListener(m_connected);
-        }));
+        });
     }
 }
 
@@ -126,9 +216,41 @@ void WolkInterface::flushAttributes()
     m_dataService->publishAttributes();
 }
 
-void WolkInterface::flushReadings()
+bool WolkInterface::flushReadings()
 {
-    m_dataService->publishReadings();
+    // Publish a slice of the readings, and if some are left over, yield to the other commands before continuing
+    auto budget = m_publishBudget;
+    budget.restart();
+    if (!m_dataService->publishReadings(budget))
+    {
+        m_flushContinuing = false;
+        return !budget.hasFailed();
+    }
+    m_flushContinuing = true;
+
+    // If the in-flight window is full, continue once a delivery is confirmed
+    if (m_dataService->isInFlightWindowFull())
+    {
+        m_flushStalled = true;
+        return !budget.hasFailed();
+    }
+
+    // If the rate limiter ran dry, continue once it refills instead of retrying right away
+    const auto delay = m_dataService->getRateLimitDelay();
+    if (delay.count() == 0)
+        addToCommandBuffer([=] { continueFlush(); });
+    else if (!m_throttledFlushScheduled.exchange(true))
+    {
+        // The flag is only cleared by the queued command, so the previous run of the timer is over by now
+        m_throttleTimer->stop();
+        m_throttleTimer->start(delay, [this] {
+            addToCommandBuffer([=] {
+                m_throttledFlushScheduled = false;
+                continueFlush();
+            });
+        });
+    }
+    return !budget.hasFailed();
 }
 
 void WolkInterface::flushParameters()
@@ -136,6 +258,62 @@ void WolkInterface::flushParameters()
     m_dataService->publishParameters();
 }
 
+void WolkInterface::scheduledFlush()
+{
+    requestFlush(nullptr);
+}
+
+void WolkInterface::requestFlush(PublishCallback callback)
+{
+    // Merge the request into the pending flush, and only enqueue a flush if none is pending
+    {
+        std::lock_guard<std::mutex> lock{m_flushMutex};
+        if (callback)
+            m_flushCallbacks.emplace_back(std::move(callback));
+        if (m_flushPending)
+            return;
+        m_flushPending = true;
+    }
+    addToCommandBuffer([this] { runRequestedFlush(); });
+}
+
+void WolkInterface::runRequestedFlush()
+{
+    // Requests arriving from now on are not covered by this flush, so they need a new one
+    auto callbacks = std::vector<PublishCallback>{};
+    {
+        std::lock_guard<std::mutex> lock{m_flushMutex};
+        m_flushPending = false;
+        std::swap(callbacks, m_flushCallbacks);
+    }
+
+    if (m_flushScheduler != nullptr)
+        m_flushScheduler->notifyFlushStarted();
+    flushAttributes();
+    if (m_flushContinuing)
+    {
+        // The readings are already published in slices, so the requests wait for the next slice instead
+        for (auto& callback : callbacks)
+            m_continuationCallbacks.emplace_back(std::move(callback));
+        flushParameters();
+        return;
+    }
+    const auto published = flushReadings();
+    flushParameters();
+
+    for (const auto& callback : callbacks)
+        callback(published);
+}
+
+void WolkInterface::continueFlush()
+{
+    auto callbacks = std::vector<PublishCallback>{};
+    std::swap(callbacks, m_continuationCallbacks);
+    const auto published = flushReadings();
+    for (const auto& callback : callbacks)
+        callback(published);
+}
+
 void WolkInterface::handleFeedUpdateCommand(const std::string& deviceKey,
                                             const std::map<std::uint64_t, std::vector<Reading>>& readings)
 {
@@ -175,9 +353,33 @@ std::uint64_t WolkInterface::currentRtc()
     return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(duration).count());
 }
 
-void WolkInterface::addToCommandBuffer(std::function<void()> command)
+bool WolkInterface::addReadingsCommand(const std::string& deviceKey, std::vector<Reading> readings)
+{
+    if (m_commandBuffer->getMode() != BackpressureMode::CoalesceByFeed)
+        return m_commandBuffer->offerCommand(std::bind(
+          [this](const std::string& deviceKey, const std::vector<Reading>& readings) {
+              m_dataService->addReadings(deviceKey, readings);
+          },
+          deviceKey, std::move(readings)));
+
+    // Readings of many feeds can only be coalesced one by one
+    auto added = true;
+    for (auto& reading : readings)
+    {
+        const auto reference = reading.getReference();
+        const auto command = [this](const std::string& deviceKey, const Reading& reading) {
+            m_dataService->addReading(deviceKey, reading);
+        };
+        if (!addReadingCommand(deviceKey, reference, std::bind(command, deviceKey, std::move(reading))))
+            added = false;
+    }
+    return added;
+}
+
+void WolkInterface::notifyBuffered(std::uint64_t count)
 {
-    m_commandBuffer->pushCommand(std::make_shared<std::function<void()>>(command));
+    if (m_flushScheduler != nullptr)
+        m_flushScheduler->notifyBuffered(count);
 }
 }    // namespace connect
 }    // namespace wolkabout
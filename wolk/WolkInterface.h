@@ -18,21 +18,30 @@
 #define WOLK_INTERFACE_H
 
 #include "core/model/Reading.h"
-#include "core/utilities/CommandBuffer.h"
 #include "wolk/WolkInterfaceType.h"
 #include "wolk/api/FeedUpdateHandler.h"
 #include "wolk/api/ParameterHandler.h"
 #include "wolk/service/data/DataService.h"
+#include "wolk/service/data/FlushScheduler.h"
 #include "wolk/service/error/ErrorService.h"
 #include "wolk/service/file_management/FileManagementService.h"
 #include "wolk/service/firmware_update/FirmwareUpdateService.h"
 #include "wolk/service/platform_status/PlatformStatusService.h"
 #include "wolk/service/registration_service/RegistrationService.h"
+#include "wolk/utilities/BoundedCommandQueue.h"
+#include "wolk/utilities/CommandQueue.h"
+#include "wolk/utilities/CommandTimer.h"
+#include "wolk/utilities/ReconnectPolicy.h"
+#include "wolk/utilities/SharedExecutor.h"
 
 #include <atomic>
 #include <functional>
+#include <future>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <random>
+#include <vector>
 
 namespace wolkabout
 {
@@ -57,6 +66,7 @@ class FileListener;
 
 // This is an alias for a lambda expression that can listen to the Wolk object's connection status.
 using ConnectionStatusListener = std::function<void(bool)>;
+using PublishCallback = std::function<void(bool)>;
 
 /**
  * This is an interface class that represents a Wolk implementation.
@@ -99,8 +109,56 @@ public:
     /**
      * This method will invoke the Wolk object to publish everything that is held in persistence.
      * This includes readings, parameters and attributes for any devices that are presented via this Wolk object.
+     * Calls made while a publish is still waiting in the command queue are merged into it, so at most one is pending,
+     * and while readings left over by the publish budget are published in slices, they wait for the next slice.
+     *
+     * @param callback The callback invoked once the pending publish finished, with whether all of its readings were
+     * handed over to the connection. Readings left over by the publish budget are published in later slices, after
+     * the callback.
+     */
+    virtual void publish(PublishCallback callback = nullptr);
+
+    /**
+     * This method will invoke the Wolk object to publish everything that is held in persistence, like `publish`.
+     *
+     * @return The future that is ready once the pending publish finished. It holds an exception if some of its readings
+     * could not be handed over to the connection.
+     */
+    std::future<void> publishAsync();
+
+    /**
+     * This method will set the policy deciding which readings of feeds with the reference are worth publishing.
+     * Readings added before this call are still checked against the previous policy.
+     *
+     * @param reference The feed reference. The policy applies to feeds with this reference on all devices.
+     * @param policy The new policy. Setting `ReportingMode::Always` removes the policy.
+     */
+    virtual void setReportingPolicy(const std::string& reference, const ReportingPolicy& policy);
+
+    /**
+     * This method will set the priority class readings of feeds with the reference are published in.
+     * Readings of feeds in a higher class are published before the others, for example after a reconnect.
+     *
+     * @param reference The feed reference. The priority applies to feeds with this reference on all devices.
+     * @param priority The new priority. Feeds have the `FeedPriority::Normal` priority by default.
+     */
+    virtual void setFeedPriority(const std::string& reference, FeedPriority priority);
+
+    /**
+     * This method will return the counts of messages and bytes that went through the outbound rate limiter, and how
+     * many times publishing had to wait for it.
+     *
+     * @return The metrics of the rate limiter.
      */
-    virtual void publish();
+    RateLimiterMetrics getRateLimiterMetrics() const;
+
+    /**
+     * This method will return the count of added readings that wait in the command queue to be stored.
+     * With a command queue limit set, this is the count that is compared to the limit.
+     *
+     * @return The depth of the command queue.
+     */
+    std::size_t getCommandQueueDepth() const;
 
     /**
      * This method will return a value indicating which type of a Wolk instance is this object.
@@ -118,14 +176,25 @@ protected:
 
     // Here are some internal methods regarding the connection
     virtual void tryConnect(bool firstTime);
+    virtual void reconnect();
+    void scheduleReconnect();
     virtual void notifyConnected();
     virtual void notifyDisconnected();
     virtual void notifyConnectionStatusListener();
 
     // Here are some internal methods used to publish data from persistence
-    virtual void flushReadings();
+    // Returns whether all the readings of the slice were handed over to the connection
+    virtual bool flushReadings();
     virtual void flushAttributes();
     virtual void flushParameters();
+    virtual void scheduledFlush();
+    void requestFlush(PublishCallback callback);
+    void runRequestedFlush();
+    void continueFlush();
+
+    // Confirms the delivery of a message published while the data service has an in-flight window. The window is not
+    // exposed on the builder, as the connectivity service it creates does not report deliveries.
+    virtual void notifyDelivered(std::shared_ptr<Message> message);
 
     // Here are internal methods that are used to propagate the data to external handlers
     virtual void handleFeedUpdateCommand(const std::string& deviceKey,
@@ -134,7 +203,11 @@ protected:
 
     // Here are some utility methods to be used
     static std::uint64_t currentRtc();
-    void addToCommandBuffer(std::function<void()> command);
+    template <typename F> void addToCommandBuffer(F&& command);
+    template <typename F>
+    bool addReadingCommand(const std::string& deviceKey, const std::string& reference, F&& command);
+    bool addReadingsCommand(const std::string& deviceKey, std::vector<Reading> readings);
+    void notifyBuffered(std::uint64_t count = 1);
 
     // Here is the place for the connection status and its listener
     std::atomic_bool m_connected;
@@ -164,6 +237,9 @@ protected:
     std::unique_ptr<PlatformStatusProtocol> m_platformStatusProtocol;
     std::unique_ptr<RegistrationProtocol> m_registrationProtocol;
 
+    // Here is the executor shared by the services, if one was set, that must outlive all of them
+    std::shared_ptr<SharedExecutor> m_sharedExecutor;
+
     // List of all services the Wolk object must hold
     std::shared_ptr<DataService> m_dataService;
     std::shared_ptr<ErrorService> m_errorService;
@@ -172,9 +248,49 @@ protected:
     std::shared_ptr<PlatformStatusService> m_platformStatusService;
     std::shared_ptr<RegistrationService> m_registrationService;
 
+    // Here is the budget for a single slice of publishing readings, after which the rest is left for a next command
+    PublishBudget m_publishBudget;
+
     // Here is the command buffer that should be used
-    std::unique_ptr<CommandBuffer> m_commandBuffer;
+    std::unique_ptr<BoundedCommandQueue> m_commandBuffer;
+
+    // Here is the scheduler that triggers flushes automatically, if a flush policy was set
+    std::unique_ptr<FlushScheduler> m_flushScheduler;
+
+    // Here is the timer that continues publishing readings once the rate limiter refills
+    std::atomic_bool m_throttledFlushScheduled;
+    std::unique_ptr<CommandTimer> m_throttleTimer;
+
+    // Here is the flag telling that publishing readings waits for the in-flight window to open
+    std::atomic_bool m_flushStalled;
+
+    // Here is the flag telling that the readings left over are published in further slices, with the callbacks of the
+    // requests merged into it, that only the commands touch
+    bool m_flushContinuing;
+    std::vector<PublishCallback> m_continuationCallbacks;
+
+    // Here is the pending flush the publish calls are merged into, with the callbacks waiting for it
+    std::mutex m_flushMutex;
+    bool m_flushPending;
+    std::vector<PublishCallback> m_flushCallbacks;
+
+    // Here is the policy of reconnecting, with the count of failed attempts and the jitter source used by the commands
+    ReconnectPolicy m_reconnectPolicy;
+    std::uint32_t m_reconnectAttempt;
+    std::mt19937 m_reconnectRandom;
+    std::unique_ptr<CommandTimer> m_reconnectTimer;
 };
+
+template <typename F> void WolkInterface::addToCommandBuffer(F&& command)
+{
+    m_commandBuffer->pushCommand(std::forward<F>(command));
+}
+
+template <typename F>
+bool WolkInterface::addReadingCommand(const std::string& deviceKey, const std::string& reference, F&& command)
+{
+    return m_commandBuffer->offerCommand(deviceKey, reference, std::forward<F>(command));
+}
 }    // namespace connect
 }    // namespace wolkabout
 
@@ -19,6 +19,7 @@
 #include "core/utilities/Logger.h"
 
 #include <algorithm>
+#include <functional>
 #include <utility>
 
 namespace wolkabout
@@ -54,7 +55,7 @@ bool WolkMulti::addDevice(const Device& device)
     return true;
 }
 
-void WolkMulti::addReading(const std::string& deviceKey, const std::string& reference, std::string value,
+bool WolkMulti::addReading(const std::string& deviceKey, const std::string& reference, std::string value,
                            std::uint64_t rtc)
 {
     //    Now, I'd really like to add this check in the `addReading` call, but I think this method is called too often
@@ -66,10 +67,33 @@ void WolkMulti::addReading(const std::string& deviceKey, const std::string& refe
     //    }
     if (rtc == 0)
         rtc = WolkMulti::currentRtc();
-    addToCommandBuffer([=]() -> void { m_dataService->addReading(deviceKey, reference, value, rtc); });
+    if (!addReadingCommand(deviceKey, reference,
+                           std::bind(
+                             [this](const std::string& deviceKey, const std::string& reference,
+                                    const std::string& value, std::uint64_t rtc) {
+                                 m_dataService->addReading(deviceKey, reference, value, rtc);
+                             },
+                             deviceKey, reference, std::move(value), rtc)))
+        return false;
+    notifyBuffered();
+    return true;
 }
 
-void WolkMulti::addReading(const std::string& deviceKey, const std::string& reference,
+bool WolkMulti::addReading(const std::string& deviceKey, const std::string& reference, const ReadingValue& value,
+                           std::uint64_t rtc)
+{
+    if (value.isString())
+        return addReading(deviceKey, reference, value.getString(), rtc);
+    if (rtc == 0)
+        rtc = WolkMulti::currentRtc();
+    if (!addReadingCommand(deviceKey, reference,
+                           [=]() -> void { m_dataService->addReading(deviceKey, reference, value, rtc); }))
+        return false;
+    notifyBuffered();
+    return true;
+}
+
+bool WolkMulti::addReading(const std::string& deviceKey, const std::string& reference,
                            const std::vector<std::string>& values, std::uint64_t rtc)
 {
     //    Now, I'd really like to add this check in the `addReading` call, but I think this method is called too often
@@ -81,17 +105,91 @@ void WolkMulti::addReading(const std::string& deviceKey, const std::string& refe
     //    }
     if (rtc == 0)
         rtc = WolkMulti::currentRtc();
-    addToCommandBuffer([=]() -> void { m_dataService->addReading(deviceKey, reference, values, rtc); });
+    if (!addReadingCommand(deviceKey, reference,
+                           [=]() -> void { m_dataService->addReading(deviceKey, reference, values, rtc); }))
+        return false;
+    notifyBuffered();
+    return true;
+}
+
+bool WolkMulti::addReading(const std::string& deviceKey, const std::string& reference,
+                           std::vector<std::string>&& values, std::uint64_t rtc)
+{
+    if (rtc == 0)
+        rtc = WolkMulti::currentRtc();
+    if (!addReadingCommand(
+          deviceKey, reference,
+          std::bind(
+            [this](const std::string& deviceKey, const std::string& reference, const std::vector<std::string>& values,
+                   std::uint64_t rtc) { m_dataService->addReading(deviceKey, reference, values, rtc); },
+            deviceKey, reference, std::move(values), rtc)))
+        return false;
+    notifyBuffered();
+    return true;
 }
 
-void WolkMulti::addReading(const std::string& deviceKey, const Reading& reading)
+bool WolkMulti::addReading(const std::string& deviceKey, const Reading& reading)
 {
-    addToCommandBuffer([this, deviceKey, reading] { m_dataService->addReading(deviceKey, reading); });
+    if (!addReadingCommand(deviceKey, reading.getReference(),
+                           [this, deviceKey, reading] { m_dataService->addReading(deviceKey, reading); }))
+        return false;
+    notifyBuffered();
+    return true;
 }
 
-void WolkMulti::addReadings(const std::string& deviceKey, const std::vector<Reading>& readings)
+bool WolkMulti::addReading(const std::string& deviceKey, Reading&& reading)
 {
-    addToCommandBuffer([this, deviceKey, readings] { m_dataService->addReadings(deviceKey, readings); });
+    const auto reference = reading.getReference();
+    if (!addReadingCommand(deviceKey, reference,
+                           std::bind([this](const std::string& deviceKey,
+                                            const Reading& reading) { m_dataService->addReading(deviceKey, reading); },
+                                     deviceKey, std::move(reading))))
+        return false;
+    notifyBuffered();
+    return true;
+}
+
+bool WolkMulti::addReadings(const std::string& deviceKey, const std::vector<Reading>& readings)
+{
+    if (!addReadingsCommand(deviceKey, readings))
+        return false;
+    notifyBuffered(readings.size());
+    return true;
+}
+
+bool WolkMulti::addReadings(const std::string& deviceKey, std::vector<Reading>&& readings)
+{
+    const auto count = readings.size();
+    if (!addReadingsCommand(deviceKey, std::move(readings)))
+        return false;
+    notifyBuffered(count);
+    return true;
+}
+
+bool WolkMulti::addReadings(const std::string& deviceKey, ReadingBatch batch)
+{
+    if (batch.empty())
+        return true;
+    batch.stamp(WolkMulti::currentRtc());
+    if (!batch.isValid())
+    {
+        LOG(ERROR) << "Ignoring call of 'addReadings' - The count of values and timestamps in the batch differs.";
+        return false;
+    }
+
+    // A batch holds samples of a single feed, so in the coalescing mode a newer batch replaces the one kept aside
+    const auto count = batch.size();
+    const auto reference = batch.getReference();
+    if (!addReadingCommand(
+          deviceKey, reference,
+          std::bind(
+            [this](const std::string& deviceKey, const ReadingBatch& batch) {
+                m_dataService->addReadings(deviceKey, batch);
+            },
+            deviceKey, std::move(batch))))
+        return false;
+    notifyBuffered(count);
+    return true;
 }
 
 void WolkMulti::registerFeed(const std::string& deviceKey, const Feed& feed)
@@ -105,6 +203,20 @@ void WolkMulti::registerFeed(const std::string& deviceKey, const Feed& feed)
     addToCommandBuffer([=]() -> void { m_dataService->registerFeed(deviceKey, feed); });
 }
 
+void WolkMulti::registerFeed(const std::string& deviceKey, const Feed& feed, FeedPriority priority)
+{
+    if (!isDeviceInList(deviceKey))
+    {
+        LOG(WARN) << "Ignoring call of 'registerFeed' - Device '" << deviceKey << "' has not been added.";
+        return;
+    }
+
+    addToCommandBuffer([=]() -> void {
+        m_dataService->setFeedPriority(feed.getReference(), priority);
+        m_dataService->registerFeed(deviceKey, feed);
+    });
+}
+
 void WolkMulti::registerFeeds(const std::string& deviceKey, const std::vector<Feed>& feeds)
 {
     if (!isDeviceInList(deviceKey))
@@ -169,6 +281,7 @@ void WolkMulti::addAttribute(const std::string& deviceKey, Attribute attribute)
     }
 
     addToCommandBuffer([=]() -> void { m_dataService->addAttribute(deviceKey, attribute); });
+    notifyBuffered();
 }
 
 void WolkMulti::updateParameter(const std::string& deviceKey, Parameter parameter)
@@ -180,6 +293,7 @@ void WolkMulti::updateParameter(const std::string& deviceKey, Parameter paramete
     }
 
     addToCommandBuffer([=]() -> void { m_dataService->updateParameter(deviceKey, parameter); });
+    notifyBuffered();
 }
 
 bool WolkMulti::registerDevice(
@@ -21,8 +21,11 @@
 #include "core/utilities/StringUtils.h"
 #include "wolk/WolkBuilder.h"
 #include "wolk/WolkInterface.h"
+#include "wolk/service/data/ReadingBatch.h"
+#include "wolk/service/data/ReadingValue.h"
 
 #include <algorithm>
+#include <utility>
 
 namespace wolkabout
 {
@@ -42,26 +45,39 @@ public:
     bool addDevice(const Device& device);
 
     template <typename T>
-    void addReading(const std::string& deviceKey, const std::string& reference, T value, std::uint64_t rtc = 0);
+    bool addReading(const std::string& deviceKey, const std::string& reference, T value, std::uint64_t rtc = 0);
 
-    void addReading(const std::string& deviceKey, const std::string& reference, std::string value,
+    bool addReading(const std::string& deviceKey, const std::string& reference, std::string value,
+                    std::uint64_t rtc = 0);
+
+    bool addReading(const std::string& deviceKey, const std::string& reference, const ReadingValue& value,
                     std::uint64_t rtc = 0);
 
     template <typename T>
-    void addReading(const std::string& deviceKey, const std::string& reference, const std::vector<T>& values,
+    bool addReading(const std::string& deviceKey, const std::string& reference, const std::vector<T>& values,
+                    std::uint64_t rtc = 0);
+
+    bool addReading(const std::string& deviceKey, const std::string& reference, const std::vector<std::string>& values,
                     std::uint64_t rtc = 0);
 
-    void addReading(const std::string& deviceKey, const std::string& reference, const std::vector<std::string>& values,
+    bool addReading(const std::string& deviceKey, const std::string& reference, std::vector<std::string>&& values,
                     std::uint64_t rtc = 0);
 
-    void addReading(const std::string& deviceKey, const Reading& reading);
+    bool addReading(const std::string& deviceKey, const Reading& reading);
+
+    bool addReading(const std::string& deviceKey, Reading&& reading);
+
+    bool addReadings(const std::string& deviceKey, const std::vector<Reading>& readings);
+
+    bool addReadings(const std::string& deviceKey, std::vector<Reading>&& readings);
 
-    void addReadings(const std::string& deviceKey, const std::vector<Reading>& readings);
+    bool addReadings(const std::string& deviceKey, ReadingBatch batch);
 
     void pullFeedValues(const std::string& deviceKey);
     void pullParameters(const std::string& deviceKey);
 
     void registerFeed(const std::string& deviceKey, const Feed& feed);
+    void registerFeed(const std::string& deviceKey, const Feed& feed, FeedPriority priority);
     void registerFeeds(const std::string& deviceKey, const std::vector<Feed>& feeds);
 
     void removeFeed(const std::string& deviceKey, const std::string& reference);
@@ -150,23 +166,23 @@ private:
 };
 
 template <typename T>
-void WolkMulti::addReading(const std::string& deviceKey, const std::string& reference, T value, std::uint64_t rtc)
+bool WolkMulti::addReading(const std::string& deviceKey, const std::string& reference, T value, std::uint64_t rtc)
 {
-    addReading(deviceKey, reference, StringUtils::toString(value), rtc);
+    return addReading(deviceKey, reference, ReadingValue{value}, rtc);
 }
 
 template <typename T>
-void WolkMulti::addReading(const std::string& deviceKey, const std::string& reference, const std::vector<T>& values,
+bool WolkMulti::addReading(const std::string& deviceKey, const std::string& reference, const std::vector<T>& values,
                            std::uint64_t rtc)
 {
     if (values.empty())
-        return;
+        return true;
 
     std::vector<std::string> stringifiedValues(values.size());
     std::transform(values.cbegin(), values.cend(), stringifiedValues.begin(),
                    [&](const T& value) -> std::string { return StringUtils::toString(value); });
 
-    addReading(deviceKey, reference, stringifiedValues, rtc);
+    return addReading(deviceKey, reference, std::move(stringifiedValues), rtc);
 }
 }    // namespace connect
 }    // namespace wolkabout
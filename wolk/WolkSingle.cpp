@@ -16,8 +16,15 @@
 
 #include "wolk/WolkSingle.h"
 
+#include "core/utilities/Logger.h"
 #include "wolk/WolkBuilder.h"
 
+#include <exception>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
 namespace wolkabout
 {
 namespace connect
@@ -27,34 +34,133 @@ WolkBuilder WolkSingle::newBuilder(Device device)
     return WolkBuilder(device);
 }
 
-void WolkSingle::addReading(const std::string& reference, std::string value, std::uint64_t rtc)
+bool WolkSingle::addReading(const std::string& reference, std::string value, std::uint64_t rtc)
+{
+    if (rtc == 0)
+    {
+        rtc = WolkSingle::currentRtc();
+    }
+
+    if (!addReadingCommand(m_device.getKey(), reference,
+                           std::bind(
+                             [this](const std::string& reference, const std::string& value, std::uint64_t rtc) {
+                                 m_dataService->addReading(m_device.getKey(), reference, value, rtc);
+                             },
+                             reference, std::move(value), rtc)))
+        return false;
+    notifyBuffered();
+    return true;
+}
+
+bool WolkSingle::addReading(const std::string& reference, const ReadingValue& value, std::uint64_t rtc)
+{
+    if (value.isString())
+        return addReading(reference, value.getString(), rtc);
+
+    if (rtc == 0)
+    {
+        rtc = WolkSingle::currentRtc();
+    }
+
+    if (!addReadingCommand(m_device.getKey(), reference,
+                           [=] { m_dataService->addReading(m_device.getKey(), reference, value, rtc); }))
+        return false;
+    notifyBuffered();
+    return true;
+}
+
+bool WolkSingle::addReading(const std::string& reference, const std::vector<std::string>& values, std::uint64_t rtc)
 {
     if (rtc == 0)
     {
         rtc = WolkSingle::currentRtc();
     }
 
-    addToCommandBuffer([=] { m_dataService->addReading(m_device.getKey(), reference, value, rtc); });
+    if (!addReadingCommand(m_device.getKey(), reference,
+                           [=] { m_dataService->addReading(m_device.getKey(), reference, values, rtc); }))
+        return false;
+    notifyBuffered();
+    return true;
 }
 
-void WolkSingle::addReading(const std::string& reference, const std::vector<std::string>& values, std::uint64_t rtc)
+bool WolkSingle::addReading(const std::string& reference, std::vector<std::string>&& values, std::uint64_t rtc)
 {
     if (rtc == 0)
     {
         rtc = WolkSingle::currentRtc();
     }
 
-    addToCommandBuffer([=] { m_dataService->addReading(m_device.getKey(), reference, values, rtc); });
+    if (!addReadingCommand(
+          m_device.getKey(), reference,
+          std::bind(
+            [this](const std::string& reference, const std::vector<std::string>& values, std::uint64_t rtc) {
+                m_dataService->addReading(m_device.getKey(), reference, values, rtc);
+            },
+            reference, std::move(values), rtc)))
+        return false;
+    notifyBuffered();
+    return true;
 }
 
-void WolkSingle::addReading(const Reading& reading)
+bool WolkSingle::addReading(const Reading& reading)
 {
-    addToCommandBuffer([this, reading] { m_dataService->addReading(m_device.getKey(), reading); });
+    if (!addReadingCommand(m_device.getKey(), reading.getReference(),
+                           [this, reading] { m_dataService->addReading(m_device.getKey(), reading); }))
+        return false;
+    notifyBuffered();
+    return true;
 }
 
-void WolkSingle::addReadings(const std::vector<Reading>& readings)
+bool WolkSingle::addReading(Reading&& reading)
 {
-    addToCommandBuffer([this, readings] { m_dataService->addReadings(m_device.getKey(), readings); });
+    const auto reference = reading.getReference();
+    if (!addReadingCommand(
+          m_device.getKey(), reference,
+          std::bind([this](const Reading& reading) { m_dataService->addReading(m_device.getKey(), reading); },
+                    std::move(reading))))
+        return false;
+    notifyBuffered();
+    return true;
+}
+
+bool WolkSingle::addReadings(const std::vector<Reading>& readings)
+{
+    if (!addReadingsCommand(m_device.getKey(), readings))
+        return false;
+    notifyBuffered(readings.size());
+    return true;
+}
+
+bool WolkSingle::addReadings(std::vector<Reading>&& readings)
+{
+    const auto count = readings.size();
+    if (!addReadingsCommand(m_device.getKey(), std::move(readings)))
+        return false;
+    notifyBuffered(count);
+    return true;
+}
+
+bool WolkSingle::addReadings(ReadingBatch batch)
+{
+    if (batch.empty())
+        return true;
+    batch.stamp(WolkSingle::currentRtc());
+    if (!batch.isValid())
+    {
+        LOG(ERROR) << "Ignoring call of 'addReadings' - The count of values and timestamps in the batch differs.";
+        return false;
+    }
+
+    // A batch holds samples of a single feed, so in the coalescing mode a newer batch replaces the one kept aside
+    const auto count = batch.size();
+    const auto reference = batch.getReference();
+    if (!addReadingCommand(
+          m_device.getKey(), reference,
+          std::bind([this](const ReadingBatch& batch) { m_dataService->addReadings(m_device.getKey(), batch); },
+                    std::move(batch))))
+        return false;
+    notifyBuffered(count);
+    return true;
 }
 
 void WolkSingle::pullFeedValues()
@@ -73,6 +179,23 @@ void WolkSingle::synchronizeParameters(const std::vector<ParameterName>& paramet
     addToCommandBuffer([=] { m_dataService->synchronizeParameters(m_device.getKey(), parameters, callback); });
 }
 
+std::future<std::vector<Parameter>> WolkSingle::synchronizeParametersAsync(const std::vector<ParameterName>& parameters)
+{
+    auto promise = std::make_shared<std::promise<std::vector<Parameter>>>();
+    auto future = promise->get_future();
+    addToCommandBuffer([=] {
+        const auto callback = [promise](std::vector<Parameter> values) { promise->set_value(std::move(values)); };
+        const auto timeoutCallback = [promise] {
+            promise->set_exception(
+              std::make_exception_ptr(std::runtime_error{"The platform did not respond to the parameters request."}));
+        };
+        if (!m_dataService->synchronizeParameters(m_device.getKey(), parameters, callback, timeoutCallback))
+            promise->set_exception(
+              std::make_exception_ptr(std::runtime_error{"Failed to send the request to synchronize parameters."}));
+    });
+    return future;
+}
+
 void WolkSingle::obtainDetails(std::function<void(std::vector<std::string>, std::vector<std::string>)> callback)
 {
     addToCommandBuffer([=] { m_dataService->detailsSynchronizationAsync(m_device.getKey(), callback); });
@@ -83,11 +206,33 @@ void WolkSingle::registerFeed(const Feed& feed)
     addToCommandBuffer([=] { m_dataService->registerFeed(m_device.getKey(), feed); });
 }
 
+void WolkSingle::registerFeed(const Feed& feed, FeedPriority priority)
+{
+    addToCommandBuffer([=] {
+        m_dataService->setFeedPriority(feed.getReference(), priority);
+        m_dataService->registerFeed(m_device.getKey(), feed);
+    });
+}
+
 void WolkSingle::registerFeeds(const std::vector<Feed>& feeds)
 {
     addToCommandBuffer([=] { m_dataService->registerFeeds(m_device.getKey(), feeds); });
 }
 
+std::future<void> WolkSingle::registerFeedsAsync(const std::vector<Feed>& feeds)
+{
+    auto promise = std::make_shared<std::promise<void>>();
+    auto future = promise->get_future();
+    addToCommandBuffer([=] {
+        if (m_dataService->registerFeeds(m_device.getKey(), feeds))
+            promise->set_value();
+        else
+            promise->set_exception(
+              std::make_exception_ptr(std::runtime_error{"Failed to send the request to register feeds."}));
+    });
+    return future;
+}
+
 void WolkSingle::removeFeed(const std::string& reference)
 {
     addToCommandBuffer([=] { m_dataService->removeFeed(m_device.getKey(), reference); });
@@ -101,11 +246,13 @@ void WolkSingle::removeFeeds(const std::vector<std::string>& references)
 void WolkSingle::addAttribute(Attribute attribute)
 {
     addToCommandBuffer([=] { m_dataService->addAttribute(m_device.getKey(), attribute); });
+    notifyBuffered();
 }
 
 void WolkSingle::updateParameter(Parameter parameter)
 {
     addToCommandBuffer([=] { m_dataService->updateParameter(m_device.getKey(), parameter); });
+    notifyBuffered();
 }
 
 void WolkSingle::obtainChildren(std::function<void(std::vector<std::string>)> callback)
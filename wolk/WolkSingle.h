@@ -21,10 +21,14 @@
 #include "core/model/Device.h"
 #include "core/utilities/StringUtils.h"
 #include "wolk/WolkInterface.h"
+#include "wolk/service/data/ReadingBatch.h"
+#include "wolk/service/data/ReadingValue.h"
 
 #include <algorithm>
 #include <functional>
+#include <future>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace wolkabout
@@ -68,8 +72,9 @@ public:
      *               - const char*<br>
      * @param rtc Reading POSIX time - Number of seconds since 01/01/1970<br>
      *            If omitted current POSIX time is adopted
+     * @return Whether the reading was taken. It is refused only when the command queue is full and set to reject.
      */
-    template <typename T> void addReading(const std::string& reference, T value, std::uint64_t rtc = 0);
+    template <typename T> bool addReading(const std::string& reference, T value, std::uint64_t rtc = 0);
 
     /**
      * @brief Publishes sensor reading to Wolkabout IoT Cloud<br>
@@ -78,8 +83,21 @@ public:
      * @param value Sensor value
      * @param rtc Reading POSIX time - Number of seconds since 01/01/1970<br>
      *            If omitted current POSIX time is adopted
+     * @return Whether the reading was taken. It is refused only when the command queue is full and set to reject.
      */
-    void addReading(const std::string& reference, std::string value, std::uint64_t rtc = 0);
+    bool addReading(const std::string& reference, std::string value, std::uint64_t rtc = 0);
+
+    /**
+     * @brief Publishes sensor reading to Wolkabout IoT Cloud<br>
+     *        This method is thread safe, and can be called from multiple thread simultaneously<br>
+     *        Numeric values are kept in their native form, and are formatted only once they are stored
+     * @param reference Sensor reference
+     * @param value Sensor value
+     * @param rtc Reading POSIX time - Number of seconds since 01/01/1970<br>
+     *            If omitted current POSIX time is adopted
+     * @return Whether the reading was taken. It is refused only when the command queue is full and set to reject.
+     */
+    bool addReading(const std::string& reference, const ReadingValue& value, std::uint64_t rtc = 0);
 
     /**
      * @brief Publishes multi-value sensor reading to Wolkabout IoT Cloud<br>
@@ -101,9 +119,10 @@ public:
      *               - const char*<br>
      * @param rtc Reading POSIX time - Number of seconds since 01/01/1970<br>
      *            If omitted current POSIX time is adopted
+     * @return Whether the reading was taken. It is refused only when the command queue is full and set to reject.
      */
     template <typename T>
-    void addReading(const std::string& reference, const std::vector<T>& values, std::uint64_t rtc = 0);
+    bool addReading(const std::string& reference, const std::vector<T>& values, std::uint64_t rtc = 0);
 
     /**
      * @brief Publishes multi-value sensor reading to Wolkabout IoT Cloud<br>
@@ -112,12 +131,29 @@ public:
      * @param values Multi-value sensor values
      * @param rtc Reading POSIX time - Number of seconds since 01/01/1970<br>
      *            If omitted current POSIX time is adopted
+     * @return Whether the reading was taken. It is refused only when the command queue is full and set to reject.
      */
-    void addReading(const std::string& reference, const std::vector<std::string>& values, std::uint64_t rtc = 0);
+    bool addReading(const std::string& reference, const std::vector<std::string>& values, std::uint64_t rtc = 0);
+
+    bool addReading(const std::string& reference, std::vector<std::string>&& values, std::uint64_t rtc = 0);
+
+    bool addReading(const Reading& reading);
 
-    void addReading(const Reading& reading);
+    bool addReading(Reading&& reading);
 
-    void addReadings(const std::vector<Reading>& readings);
+    bool addReadings(const std::vector<Reading>& readings);
+
+    bool addReadings(std::vector<Reading>&& readings);
+
+    /**
+     * @brief Publishes a bulk of samples of a single sensor to Wolkabout IoT Cloud<br>
+     *        This method is thread safe, and can be called from multiple thread simultaneously<br>
+     *        The batch is moved into the connector as a single unit
+     * @param batch Samples of the sensor. Samples without a timestamp will adopt the current POSIX time
+     * @return Whether the batch was taken. It is refused when it is not valid, or when the command queue is full and
+     * set to reject.
+     */
+    bool addReadings(ReadingBatch batch);
 
     void pullFeedValues();
     void pullParameters();
@@ -127,9 +163,28 @@ public:
     void synchronizeParameters(const std::vector<ParameterName>& parameters,
                                std::function<void(std::vector<Parameter>)> callback = nullptr);
 
+    /**
+     * This method will request the values of parameters from the platform, like `synchronizeParameters`.
+     *
+     * @param parameters The names of the parameters.
+     * @return The future holding the parameters once the platform responds. It holds an exception if the request
+     * could not be sent, or if the platform does not respond to it in time.
+     */
+    std::future<std::vector<Parameter>> synchronizeParametersAsync(const std::vector<ParameterName>& parameters);
+
     void registerFeed(const Feed& feed);
+    void registerFeed(const Feed& feed, FeedPriority priority);
     void registerFeeds(const std::vector<Feed>& feeds);
 
+    /**
+     * This method will register feeds on the platform, like `registerFeeds`.
+     *
+     * @param feeds The feeds to register.
+     * @return The future that is ready once the registration was handed over to the connection. It holds an exception
+     * if the registration could not be sent.
+     */
+    std::future<void> registerFeedsAsync(const std::vector<Feed>& feeds);
+
     void removeFeed(const std::string& reference);
     void removeFeeds(const std::vector<std::string>& references);
 
@@ -151,22 +206,22 @@ protected:
     Device m_device;
 };
 
-template <typename T> void WolkSingle::addReading(const std::string& reference, T value, std::uint64_t rtc)
+template <typename T> bool WolkSingle::addReading(const std::string& reference, T value, std::uint64_t rtc)
 {
-    addReading(reference, StringUtils::toString(value), rtc);
+    return addReading(reference, ReadingValue{value}, rtc);
 }
 
 template <typename T>
-void WolkSingle::addReading(const std::string& reference, const std::vector<T>& values, std::uint64_t rtc)
+bool WolkSingle::addReading(const std::string& reference, const std::vector<T>& values, std::uint64_t rtc)
 {
     if (values.empty())
-        return;
+        return true;
 
     std::vector<std::string> stringifiedValues(values.size());
     std::transform(values.cbegin(), values.cend(), stringifiedValues.begin(),
                    [&](const T& value) -> std::string { return StringUtils::toString(value); });
 
-    addReading(reference, stringifiedValues, rtc);
+    return addReading(reference, std::move(stringifiedValues), rtc);
 }
 }    // namespace connect
 }    // namespace wolkabout
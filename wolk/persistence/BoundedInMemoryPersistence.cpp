@@ -0,0 +1,304 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/persistence/BoundedInMemoryPersistence.h"
+
+#include "core/utilities/Logger.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
+namespace wolkabout
+{
+namespace connect
+{
+BoundedInMemoryPersistence::BoundedInMemoryPersistence(std::uint64_t maxBytes, std::uint64_t maxReadings,
+                                                       OverflowPolicy policy)
+: m_maxBytes(maxBytes), m_maxReadings(maxReadings), m_policy(policy), m_sequence(0), m_count(0), m_size(0)
+{
+}
+
+bool BoundedInMemoryPersistence::putReading(const std::string& key, const Reading& reading)
+{
+    const auto size = estimateSize(reading) + key.size();
+    if (m_maxBytes != 0 && size > m_maxBytes)
+    {
+        LOG(ERROR) << "Failed to persist reading -> The reading is larger than the cap (" << size << " bytes).";
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock{m_mutex};
+    if (!makeRoom(size))
+    {
+        ++m_counters.droppedNewest;
+        return false;
+    }
+
+    auto& entries = m_readings[key];
+    if (entries.empty())
+        m_fronts.emplace(m_sequence, key);
+    entries.push_back(Entry{m_sequence++, size, std::make_shared<Reading>(reading)});
+    ++m_count;
+    m_size += size;
+    return true;
+}
+
+std::vector<std::shared_ptr<Reading>> BoundedInMemoryPersistence::getReadings(const std::string& key,
+                                                                              std::uint_fast64_t count)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    auto readings = std::vector<std::shared_ptr<Reading>>{};
+    const auto it = m_readings.find(key);
+    if (it == m_readings.cend())
+        return readings;
+
+    const auto& entries = it->second;
+    const auto size = static_cast<std::size_t>(std::min<std::uint_fast64_t>(count, entries.size()));
+    readings.reserve(size);
+    for (auto i = std::size_t{0}; i < size; ++i)
+        readings.emplace_back(entries[i].reading);
+    return readings;
+}
+
+void BoundedInMemoryPersistence::removeReadings(const std::string& key, std::uint_fast64_t count)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    const auto it = m_readings.find(key);
+    if (it == m_readings.end())
+        return;
+
+    // The feed is erased with its last reading, which is also the last one removed here
+    const auto size = std::min<std::uint_fast64_t>(count, it->second.size());
+    for (auto i = std::uint_fast64_t{0}; i < size; ++i)
+        popFront(it);
+}
+
+std::vector<std::string> BoundedInMemoryPersistence::getReadingsKeys()
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    auto keys = std::vector<std::string>{};
+    keys.reserve(m_readings.size());
+    for (const auto& readings : m_readings)
+        keys.emplace_back(readings.first);
+    return keys;
+}
+
+bool BoundedInMemoryPersistence::putAttribute(const std::string& key, std::shared_ptr<Attribute> attribute)
+{
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    m_attributes[key] = std::move(attribute);
+    return true;
+}
+
+std::map<std::string, std::shared_ptr<Attribute>> BoundedInMemoryPersistence::getAttributes()
+{
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    return m_attributes;
+}
+
+std::shared_ptr<Attribute> BoundedInMemoryPersistence::getAttributeUnderKey(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    const auto it = m_attributes.find(key);
+    return it != m_attributes.cend() ? it->second : nullptr;
+}
+
+void BoundedInMemoryPersistence::removeAttributes()
+{
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    m_attributes.clear();
+}
+
+void BoundedInMemoryPersistence::removeAttributes(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    m_attributes.erase(key);
+}
+
+std::vector<std::string> BoundedInMemoryPersistence::getAttributeKeys()
+{
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    auto keys = std::vector<std::string>{};
+    for (const auto& attribute : m_attributes)
+        keys.emplace_back(attribute.first);
+    return keys;
+}
+
+bool BoundedInMemoryPersistence::putParameter(const std::string& key, Parameter parameter)
+{
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    m_parameters[key] = std::move(parameter);
+    return true;
+}
+
+std::map<std::string, Parameter> BoundedInMemoryPersistence::getParameters()
+{
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    return m_parameters;
+}
+
+Parameter BoundedInMemoryPersistence::getParameterForKey(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    const auto it = m_parameters.find(key);
+    return it != m_parameters.cend() ? it->second : Parameter{};
+}
+
+void BoundedInMemoryPersistence::removeParameters()
+{
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    m_parameters.clear();
+}
+
+void BoundedInMemoryPersistence::removeParameters(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    m_parameters.erase(key);
+}
+
+std::vector<std::string> BoundedInMemoryPersistence::getParameterKeys()
+{
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    auto keys = std::vector<std::string>{};
+    for (const auto& parameter : m_parameters)
+        keys.emplace_back(parameter.first);
+    return keys;
+}
+
+bool BoundedInMemoryPersistence::isEmpty()
+{
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        if (!m_readings.empty())
+            return false;
+    }
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    return m_attributes.empty() && m_parameters.empty();
+}
+
+EvictionCounters BoundedInMemoryPersistence::getEvictionCounters() const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_counters;
+}
+
+std::uint64_t BoundedInMemoryPersistence::getReadingsCount() const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_count;
+}
+
+std::uint64_t BoundedInMemoryPersistence::getReadingsSize() const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_size;
+}
+
+std::uint64_t BoundedInMemoryPersistence::estimateSize(const Reading& reading)
+{
+    // The reading itself, the shared pointer control block and the strings with their heap storage
+    auto size = std::uint64_t{sizeof(Entry) + sizeof(Reading) + 2 * sizeof(void*) + reading.getReference().size()};
+    for (const auto& value : reading.getStringValues())
+        size += sizeof(std::string) + value.size();
+    return size;
+}
+
+bool BoundedInMemoryPersistence::fits(std::uint64_t size) const
+{
+    return (m_maxBytes == 0 || m_size + size <= m_maxBytes) && (m_maxReadings == 0 || m_count < m_maxReadings);
+}
+
+bool BoundedInMemoryPersistence::makeRoom(std::uint64_t size)
+{
+    while (!fits(size))
+    {
+        switch (m_policy)
+        {
+        case OverflowPolicy::DropNewest:
+            return false;
+        case OverflowPolicy::Downsample:
+            if (downsample())
+                break;
+            evictOldest();
+            break;
+        case OverflowPolicy::DropOldest:
+        default:
+            evictOldest();
+            break;
+        }
+    }
+    return true;
+}
+
+void BoundedInMemoryPersistence::evictOldest()
+{
+    if (m_fronts.empty())
+        return;
+
+    popFront(m_readings.find(m_fronts.cbegin()->second));
+    ++m_counters.droppedOldest;
+}
+
+bool BoundedInMemoryPersistence::downsample()
+{
+    auto largest = m_readings.end();
+    for (auto it = m_readings.begin(); it != m_readings.end(); ++it)
+        if (largest == m_readings.end() || it->second.size() > largest->second.size())
+            largest = it;
+    if (largest == m_readings.end() || largest->second.size() < 4)
+        return false;
+
+    // Keep the first reading and every second one after it in the older half, so the first sequence stays the same
+    auto& entries = largest->second;
+    const auto half = entries.size() / 2;
+    auto kept = std::size_t{1};
+    for (auto i = std::size_t{1}; i < half; ++i)
+    {
+        if (i % 2 == 0)
+        {
+            entries[kept++] = std::move(entries[i]);
+            continue;
+        }
+        m_size -= entries[i].size;
+        --m_count;
+        ++m_counters.downsampled;
+    }
+    entries.erase(entries.begin() + static_cast<std::ptrdiff_t>(kept),
+                  entries.begin() + static_cast<std::ptrdiff_t>(half));
+    return true;
+}
+
+void BoundedInMemoryPersistence::popFront(std::unordered_map<std::string, std::deque<Entry>>::iterator it)
+{
+    if (it == m_readings.end() || it->second.empty())
+        return;
+
+    auto& entries = it->second;
+    m_fronts.erase(entries.front().sequence);
+    m_size -= entries.front().size;
+    --m_count;
+    entries.pop_front();
+    if (entries.empty())
+    {
+        m_readings.erase(it);
+        return;
+    }
+    m_fronts.emplace(entries.front().sequence, it->first);
+}
+}    // namespace connect
+}    // namespace wolkabout
@@ -0,0 +1,173 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WOLKABOUTCONNECTOR_BOUNDEDINMEMORYPERSISTENCE_H
+#define WOLKABOUTCONNECTOR_BOUNDEDINMEMORYPERSISTENCE_H
+
+#include "core/persistence/Persistence.h"
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace wolkabout
+{
+namespace connect
+{
+/**
+ * This enumeration describes what the `BoundedInMemoryPersistence` does with a reading that does not fit.
+ */
+enum class OverflowPolicy
+{
+    // The oldest readings (of any feed) are evicted to make room for the new one
+    DropOldest = 0,
+    // The new reading is rejected, and the stored readings are kept
+    DropNewest,
+    // Every second reading in the older half of the feed with the most readings is evicted, thinning out its history
+    Downsample
+};
+
+/**
+ * This structure holds the counts of readings the `BoundedInMemoryPersistence` had to let go of.
+ */
+struct EvictionCounters
+{
+    // The count of stored readings evicted to make room for newer ones
+    std::uint64_t droppedOldest = 0;
+    // The count of new readings that were rejected
+    std::uint64_t droppedNewest = 0;
+    // The count of stored readings evicted by thinning out the history of a feed
+    std::uint64_t downsampled = 0;
+};
+
+/**
+ * This class is a `Persistence` that keeps everything in memory, like the default in-memory persistence, but has a cap
+ * on the count of readings and on the memory they take up. Once a reading does not fit under the caps, the overflow
+ * policy decides which readings are let go of, so the memory use stays bounded during long outages.
+ * Attributes and parameters are not counted against the caps, as there are only a few of them.
+ */
+class BoundedInMemoryPersistence : public Persistence
+{
+public:
+    /**
+     * Default parameter constructor.
+     *
+     * @param maxBytes The cap on the memory taken up by the stored readings (in bytes). Zero means no cap.
+     * @param maxReadings The cap on the count of stored readings. Zero means no cap.
+     * @param policy The policy applied to the readings that do not fit.
+     */
+    explicit BoundedInMemoryPersistence(std::uint64_t maxBytes = DEFAULT_MAX_BYTES,
+                                        std::uint64_t maxReadings = DEFAULT_MAX_READINGS,
+                                        OverflowPolicy policy = OverflowPolicy::DropOldest);
+
+    bool putReading(const std::string& key, const Reading& reading) override;
+    std::vector<std::shared_ptr<Reading>> getReadings(const std::string& key, std::uint_fast64_t count) override;
+    void removeReadings(const std::string& key, std::uint_fast64_t count) override;
+    std::vector<std::string> getReadingsKeys() override;
+
+    bool putAttribute(const std::string& key, std::shared_ptr<Attribute> attribute) override;
+    std::map<std::string, std::shared_ptr<Attribute>> getAttributes() override;
+    std::shared_ptr<Attribute> getAttributeUnderKey(const std::string& key) override;
+    void removeAttributes() override;
+    void removeAttributes(const std::string& key) override;
+    std::vector<std::string> getAttributeKeys() override;
+
+    bool putParameter(const std::string& key, Parameter parameter) override;
+    std::map<std::string, Parameter> getParameters() override;
+    Parameter getParameterForKey(const std::string& key) override;
+    void removeParameters() override;
+    void removeParameters(const std::string& key) override;
+    std::vector<std::string> getParameterKeys() override;
+
+    bool isEmpty() override;
+
+    /**
+     * This method returns the counts of readings that were evicted or rejected so far.
+     *
+     * @return The eviction counters.
+     */
+    EvictionCounters getEvictionCounters() const;
+
+    /**
+     * This method returns the count of readings currently stored.
+     *
+     * @return The count of readings.
+     */
+    std::uint64_t getReadingsCount() const;
+
+    /**
+     * This method returns the memory currently taken up by the stored readings.
+     *
+     * @return The size in bytes.
+     */
+    std::uint64_t getReadingsSize() const;
+
+    /**
+     * This method estimates the memory a reading takes up while it is stored.
+     *
+     * @param reading The reading.
+     * @return The size in bytes.
+     */
+    static std::uint64_t estimateSize(const Reading& reading);
+
+    static const constexpr std::uint64_t DEFAULT_MAX_BYTES = 16 * 1024 * 1024;
+    static const constexpr std::uint64_t DEFAULT_MAX_READINGS = 0;
+
+private:
+    struct Entry
+    {
+        std::uint64_t sequence;
+        std::uint64_t size;
+        std::shared_ptr<Reading> reading;
+    };
+
+    bool fits(std::uint64_t size) const;
+    bool makeRoom(std::uint64_t size);
+
+    // Evicts the oldest reading of all feeds
+    void evictOldest();
+    // Evicts every second reading in the older half of the feed with the most readings, returns false if none was
+    bool downsample();
+
+    void popFront(std::unordered_map<std::string, std::deque<Entry>>::iterator it);
+
+    const std::uint64_t m_maxBytes;
+    const std::uint64_t m_maxReadings;
+    const OverflowPolicy m_policy;
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, std::deque<Entry>> m_readings;
+    // The sequence of the first reading of every feed, ordered from the oldest one
+    std::map<std::uint64_t, std::string> m_fronts;
+    std::uint64_t m_sequence;
+    std::uint64_t m_count;
+    std::uint64_t m_size;
+    EvictionCounters m_counters;
+
+    std::mutex m_detailsMutex;
+    std::map<std::string, std::shared_ptr<Attribute>> m_attributes;
+    std::map<std::string, Parameter> m_parameters;
+};
+}    // namespace connect
+}    // namespace wolkabout
+
+#endif    // WOLKABOUTCONNECTOR_BOUNDEDINMEMORYPERSISTENCE_H
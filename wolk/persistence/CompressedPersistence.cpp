@@ -0,0 +1,244 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/persistence/CompressedPersistence.h"
+
+#include "core/utilities/Logger.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace wolkabout
+{
+namespace connect
+{
+CompressedPersistence::CompressedPersistence(std::uint32_t segmentReadings)
+: m_segmentReadings(std::max(segmentReadings, std::uint32_t{1}))
+{
+}
+
+bool CompressedPersistence::putReading(const std::string& key, const Reading& reading)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    auto& feed = m_feeds[key];
+    auto& segments = feed.segments;
+    if (!segments.empty() && segments.back().getCount() < m_segmentReadings && segments.back().append(reading))
+        return true;
+
+    // Start a new segment once the last one is full
+    if (!segments.empty())
+        segments.back().seal();
+    segments.emplace_back();
+    if (!segments.back().append(reading))
+    {
+        LOG(ERROR) << "Failed to persist reading -> The reading does not fit in a segment.";
+        segments.pop_back();
+        if (segments.empty())
+            m_feeds.erase(key);
+        return false;
+    }
+    if (segments.size() == 1)
+        feed.cursor = segments.front().begin();
+    return true;
+}
+
+std::vector<std::shared_ptr<Reading>> CompressedPersistence::getReadings(const std::string& key,
+                                                                         std::uint_fast64_t count)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    auto readings = std::vector<std::shared_ptr<Reading>>{};
+    const auto it = m_feeds.find(key);
+    if (it == m_feeds.cend())
+        return readings;
+
+    // Read from a copy of the cursor, so the readings stay until they are removed
+    const auto& segments = it->second.segments;
+    auto cursor = it->second.cursor;
+    for (auto segment = segments.cbegin(); segment != segments.cend() && readings.size() < count; ++segment)
+    {
+        if (segment != segments.cbegin())
+            cursor = segment->begin();
+        while (readings.size() < count)
+        {
+            auto reading = segment->read(cursor);
+            if (reading == nullptr)
+                break;
+            readings.emplace_back(std::move(reading));
+        }
+    }
+    return readings;
+}
+
+void CompressedPersistence::removeReadings(const std::string& key, std::uint_fast64_t count)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    const auto it = m_feeds.find(key);
+    if (it == m_feeds.end())
+        return;
+
+    auto& feed = it->second;
+    auto& segments = feed.segments;
+    auto removed = std::uint_fast64_t{0};
+    while (!segments.empty())
+    {
+        // A segment is dropped as soon as all of its readings are removed, or if it can not be read
+        auto& front = segments.front();
+        if (feed.cursor.getIndex() < front.getCount())
+        {
+            if (removed == count)
+                break;
+            if (front.read(feed.cursor) != nullptr)
+            {
+                ++removed;
+                continue;
+            }
+        }
+        segments.pop_front();
+        if (!segments.empty())
+            feed.cursor = segments.front().begin();
+    }
+    if (segments.empty())
+        m_feeds.erase(it);
+}
+
+std::vector<std::string> CompressedPersistence::getReadingsKeys()
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    auto keys = std::vector<std::string>{};
+    keys.reserve(m_feeds.size());
+    for (const auto& feed : m_feeds)
+        keys.emplace_back(feed.first);
+    return keys;
+}
+
+bool CompressedPersistence::putAttribute(const std::string& key, std::shared_ptr<Attribute> attribute)
+{
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    m_attributes[key] = std::move(attribute);
+    return true;
+}
+
+std::map<std::string, std::shared_ptr<Attribute>> CompressedPersistence::getAttributes()
+{
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    return m_attributes;
+}
+
+std::shared_ptr<Attribute> CompressedPersistence::getAttributeUnderKey(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    const auto it = m_attributes.find(key);
+    return it != m_attributes.cend() ? it->second : nullptr;
+}
+
+void CompressedPersistence::removeAttributes()
+{
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    m_attributes.clear();
+}
+
+void CompressedPersistence::removeAttributes(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    m_attributes.erase(key);
+}
+
+std::vector<std::string> CompressedPersistence::getAttributeKeys()
+{
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    auto keys = std::vector<std::string>{};
+    for (const auto& attribute : m_attributes)
+        keys.emplace_back(attribute.first);
+    return keys;
+}
+
+bool CompressedPersistence::putParameter(const std::string& key, Parameter parameter)
+{
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    m_parameters[key] = std::move(parameter);
+    return true;
+}
+
+std::map<std::string, Parameter> CompressedPersistence::getParameters()
+{
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    return m_parameters;
+}
+
+Parameter CompressedPersistence::getParameterForKey(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    const auto it = m_parameters.find(key);
+    return it != m_parameters.cend() ? it->second : Parameter{};
+}
+
+void CompressedPersistence::removeParameters()
+{
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    m_parameters.clear();
+}
+
+void CompressedPersistence::removeParameters(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    m_parameters.erase(key);
+}
+
+std::vector<std::string> CompressedPersistence::getParameterKeys()
+{
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    auto keys = std::vector<std::string>{};
+    for (const auto& parameter : m_parameters)
+        keys.emplace_back(parameter.first);
+    return keys;
+}
+
+bool CompressedPersistence::isEmpty()
+{
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        if (!m_feeds.empty())
+            return false;
+    }
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    return m_attributes.empty() && m_parameters.empty();
+}
+
+std::uint64_t CompressedPersistence::getReadingsCount() const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    auto count = std::uint64_t{0};
+    for (const auto& feed : m_feeds)
+    {
+        for (const auto& segment : feed.second.segments)
+            count += segment.getCount();
+        count -= feed.second.cursor.getIndex();
+    }
+    return count;
+}
+
+std::uint64_t CompressedPersistence::getReadingsSize() const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    auto size = std::uint64_t{0};
+    for (const auto& feed : m_feeds)
+        for (const auto& segment : feed.second.segments)
+            size += segment.getSize();
+    return size;
+}
+}    // namespace connect
+}    // namespace wolkabout
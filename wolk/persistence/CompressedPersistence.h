@@ -0,0 +1,110 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WOLKABOUTCONNECTOR_COMPRESSEDPERSISTENCE_H
+#define WOLKABOUTCONNECTOR_COMPRESSEDPERSISTENCE_H
+
+#include "core/persistence/Persistence.h"
+#include "wolk/persistence/CompressedSegment.h"
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace wolkabout
+{
+namespace connect
+{
+/**
+ * This class is a `Persistence` that keeps readings in memory, compressed into a chain of `CompressedSegment`s for
+ * every feed. A regularly sampled numeric feed takes up a few bytes per reading, instead of a `Reading` object with
+ * its strings, so much longer backlogs fit in the same memory. Readings are decompressed only when they are published.
+ * Attributes and parameters are kept as they are, as there are only a few of them.
+ */
+class CompressedPersistence : public Persistence
+{
+public:
+    /**
+     * Default parameter constructor.
+     *
+     * @param segmentReadings The count of readings in a segment, after which a new segment is started for the feed.
+     */
+    explicit CompressedPersistence(std::uint32_t segmentReadings = DEFAULT_SEGMENT_READINGS);
+
+    bool putReading(const std::string& key, const Reading& reading) override;
+    std::vector<std::shared_ptr<Reading>> getReadings(const std::string& key, std::uint_fast64_t count) override;
+    void removeReadings(const std::string& key, std::uint_fast64_t count) override;
+    std::vector<std::string> getReadingsKeys() override;
+
+    bool putAttribute(const std::string& key, std::shared_ptr<Attribute> attribute) override;
+    std::map<std::string, std::shared_ptr<Attribute>> getAttributes() override;
+    std::shared_ptr<Attribute> getAttributeUnderKey(const std::string& key) override;
+    void removeAttributes() override;
+    void removeAttributes(const std::string& key) override;
+    std::vector<std::string> getAttributeKeys() override;
+
+    bool putParameter(const std::string& key, Parameter parameter) override;
+    std::map<std::string, Parameter> getParameters() override;
+    Parameter getParameterForKey(const std::string& key) override;
+    void removeParameters() override;
+    void removeParameters(const std::string& key) override;
+    std::vector<std::string> getParameterKeys() override;
+
+    bool isEmpty() override;
+
+    /**
+     * This method returns the count of readings currently stored.
+     *
+     * @return The count of readings.
+     */
+    std::uint64_t getReadingsCount() const;
+
+    /**
+     * This method returns the memory currently taken up by the compressed readings.
+     *
+     * @return The size in bytes.
+     */
+    std::uint64_t getReadingsSize() const;
+
+    static const constexpr std::uint32_t DEFAULT_SEGMENT_READINGS = 1024;
+
+private:
+    struct FeedSegments
+    {
+        std::deque<CompressedSegment> segments;
+        // The position of the first reading not yet removed, in the first segment
+        CompressedSegment::Cursor cursor;
+    };
+
+    const std::uint32_t m_segmentReadings;
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, FeedSegments> m_feeds;
+
+    std::mutex m_detailsMutex;
+    std::map<std::string, std::shared_ptr<Attribute>> m_attributes;
+    std::map<std::string, Parameter> m_parameters;
+};
+}    // namespace connect
+}    // namespace wolkabout
+
+#endif    // WOLKABOUTCONNECTOR_COMPRESSEDPERSISTENCE_H
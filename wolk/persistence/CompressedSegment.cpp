@@ -0,0 +1,497 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/persistence/CompressedSegment.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace wolkabout
+{
+namespace connect
+{
+namespace
+{
+const constexpr std::uint32_t SEGMENT_MAGIC = 0x47455343;
+const constexpr std::uint32_t MAX_PRECISION = 17;
+
+// A value that is stored as a number, along with the count of significant digits it is printed with
+struct Number
+{
+    bool numeric;
+    std::uint64_t bits;
+    std::uint32_t precision;
+};
+
+std::uint64_t toBits(double number)
+{
+    auto bits = std::uint64_t{0};
+    std::memcpy(&bits, &number, sizeof(bits));
+    return bits;
+}
+
+double fromBits(std::uint64_t bits)
+{
+    auto number = 0.0;
+    std::memcpy(&number, &bits, sizeof(number));
+    return number;
+}
+
+std::string format(double number, std::uint32_t precision)
+{
+    char buffer[32];
+    const auto length = std::snprintf(buffer, sizeof(buffer), "%.*g", static_cast<int>(precision), number);
+    return std::string(buffer, static_cast<std::size_t>(std::max(length, 0)));
+}
+
+// A value is stored as a number only if printing the number with the fewest digits that keep it gives the same text
+Number parse(const std::string& value)
+{
+    if (value.empty() || value.size() > 24)
+        return Number{false, 0, 0};
+    char* end = nullptr;
+    errno = 0;
+    const auto number = std::strtod(value.c_str(), &end);
+    if (end != value.c_str() + value.size() || errno != 0 || !std::isfinite(number))
+        return Number{false, 0, 0};
+
+    for (auto precision = std::uint32_t{1}; precision <= MAX_PRECISION; ++precision)
+    {
+        const auto text = format(number, precision);
+        if (toBits(std::strtod(text.c_str(), nullptr)) == toBits(number))
+            return Number{text == value, toBits(number), precision};
+    }
+    return Number{false, 0, 0};
+}
+
+std::uint32_t bitsFor(std::uint32_t value)
+{
+    auto bits = std::uint32_t{0};
+    while (bits < 32 && (value >> bits) != 0)
+        ++bits;
+    return bits;
+}
+
+std::uint32_t leadingZeros(std::uint64_t value)
+{
+    auto count = std::uint32_t{0};
+    for (auto mask = std::uint64_t{1} << 63; mask != 0 && (value & mask) == 0; mask >>= 1)
+        ++count;
+    return count;
+}
+
+std::uint32_t trailingZeros(std::uint64_t value)
+{
+    auto count = std::uint32_t{0};
+    for (auto mask = std::uint64_t{1}; mask != 0 && (value & mask) == 0; mask <<= 1)
+        ++count;
+    return count;
+}
+
+template <typename T> void put(std::vector<std::uint8_t>& buffer, T value)
+{
+    const auto offset = buffer.size();
+    buffer.resize(offset + sizeof(T));
+    std::memcpy(buffer.data() + offset, &value, sizeof(T));
+}
+
+template <typename T> bool take(const std::vector<std::uint8_t>& buffer, std::size_t& offset, T& value)
+{
+    if (offset + sizeof(T) > buffer.size())
+        return false;
+    std::memcpy(&value, buffer.data() + offset, sizeof(T));
+    offset += sizeof(T);
+    return true;
+}
+}    // namespace
+
+bool CompressedSegment::append(const Reading& reading)
+{
+    const auto& values = reading.getStringValues();
+    if (m_sealed || values.size() > MAX_VALUES_COUNT)
+        return false;
+
+    // Check whether the dictionary can take all the new strings first, so a reading is never half written
+    auto numbers = std::vector<Number>{};
+    numbers.reserve(values.size());
+    auto added = std::size_t{m_lookup.count(reading.getReference()) == 0 ? 1u : 0u};
+    for (const auto& value : values)
+    {
+        numbers.emplace_back(parse(value));
+        if (!numbers.back().numeric && m_lookup.count(value) == 0)
+            ++added;
+    }
+    if (m_dictionary.size() + added > MAX_DICTIONARY_SIZE)
+        return false;
+
+    const auto reference = lookup(reading.getReference());
+    if (m_count > 0 && reference == m_state.reference)
+    {
+        writeBits(0, 1);
+    }
+    else
+    {
+        writeBits(1, 1);
+        writeIndex(m_state, reference);
+        m_state.reference = reference;
+    }
+    writeTimestamp(m_state, reading.getTimestamp(), m_count == 0);
+
+    if (values.size() == 1)
+    {
+        writeBits(0, 1);
+    }
+    else
+    {
+        writeBits(1, 1);
+        writeBits(values.size(), 16);
+    }
+    for (auto i = std::size_t{0}; i < values.size(); ++i)
+    {
+        if (!numbers[i].numeric)
+        {
+            writeBits(1, 1);
+            writeIndex(m_state, lookup(values[i]));
+            continue;
+        }
+
+        // Only the bits that changed since the previous number are written
+        writeBits(0, 1);
+        const auto changed = numbers[i].bits ^ m_state.value;
+        if (changed == 0)
+        {
+            writeBits(0, 1);
+        }
+        else
+        {
+            writeBits(1, 1);
+            const auto leading = std::min(leadingZeros(changed), std::uint32_t{31});
+            const auto trailing = trailingZeros(changed);
+            if (m_state.length != 0 && leading >= m_state.leading &&
+                trailing >= 64 - m_state.leading - m_state.length)
+            {
+                writeBits(0, 1);
+                writeBits(changed >> (64 - m_state.leading - m_state.length), m_state.length);
+            }
+            else
+            {
+                writeBits(1, 1);
+                m_state.leading = leading;
+                m_state.length = 64 - leading - trailing;
+                writeBits(leading, 5);
+                writeBits(m_state.length - 1, 6);
+                writeBits(changed >> trailing, m_state.length);
+            }
+        }
+        m_state.value = numbers[i].bits;
+
+        if (numbers[i].precision == m_state.precision)
+        {
+            writeBits(0, 1);
+        }
+        else
+        {
+            writeBits(1, 1);
+            writeBits(numbers[i].precision, 5);
+            m_state.precision = numbers[i].precision;
+        }
+    }
+    ++m_count;
+    return true;
+}
+
+void CompressedSegment::seal()
+{
+    m_sealed = true;
+    std::unordered_map<std::string, std::uint32_t>{}.swap(m_lookup);
+    m_bytes.shrink_to_fit();
+}
+
+CompressedSegment::Cursor CompressedSegment::begin() const
+{
+    return Cursor{};
+}
+
+std::shared_ptr<Reading> CompressedSegment::read(Cursor& cursor) const
+{
+    if (cursor.m_index >= m_count || cursor.m_failed)
+        return nullptr;
+
+    auto& state = cursor.m_state;
+    if (readBits(cursor, 1) == 1)
+        state.reference = readIndex(cursor);
+    const auto timestamp = readTimestamp(cursor);
+
+    const auto multiple = readBits(cursor, 1) == 1;
+    const auto count = multiple ? readBits(cursor, 16) : 1;
+    auto values = std::vector<std::string>{};
+    values.reserve(static_cast<std::size_t>(count));
+    for (auto i = std::uint64_t{0}; i < count && !cursor.m_failed; ++i)
+    {
+        if (readBits(cursor, 1) == 1)
+        {
+            const auto index = readIndex(cursor);
+            values.emplace_back(cursor.m_failed ? std::string{} : m_dictionary[index]);
+            continue;
+        }
+
+        if (readBits(cursor, 1) == 1)
+        {
+            if (readBits(cursor, 1) == 1)
+            {
+                state.leading = static_cast<std::uint32_t>(readBits(cursor, 5));
+                state.length = static_cast<std::uint32_t>(readBits(cursor, 6)) + 1;
+            }
+            if (state.leading + state.length > 64)
+            {
+                cursor.m_failed = true;
+                break;
+            }
+            state.value ^= readBits(cursor, state.length) << (64 - state.leading - state.length);
+        }
+        if (readBits(cursor, 1) == 1)
+            state.precision = static_cast<std::uint32_t>(readBits(cursor, 5));
+        values.emplace_back(format(fromBits(state.value), state.precision));
+    }
+    ++cursor.m_index;
+
+    if (cursor.m_failed || state.reference >= m_dictionary.size())
+    {
+        cursor.m_failed = true;
+        return nullptr;
+    }
+    const auto& reference = m_dictionary[state.reference];
+    if (multiple)
+        return std::make_shared<Reading>(reference, values, timestamp);
+    return std::make_shared<Reading>(reference, values.front(), timestamp);
+}
+
+std::uint32_t CompressedSegment::getCount() const
+{
+    return m_count;
+}
+
+std::uint64_t CompressedSegment::getSize() const
+{
+    auto size = std::uint64_t{sizeof(CompressedSegment) + m_bytes.capacity()};
+    for (const auto& value : m_dictionary)
+        size += sizeof(std::string) + value.capacity();
+    size += m_lookup.bucket_count() * sizeof(void*);
+    for (const auto& entry : m_lookup)
+        size += sizeof(entry) + sizeof(void*) + entry.first.capacity();
+    return size;
+}
+
+std::vector<std::uint8_t> CompressedSegment::serialize() const
+{
+    auto bytes = std::vector<std::uint8_t>{};
+    put(bytes, SEGMENT_MAGIC);
+    put(bytes, m_count);
+    put(bytes, static_cast<std::uint32_t>(m_dictionary.size()));
+    put(bytes, m_bits);
+    for (const auto& value : m_dictionary)
+    {
+        put(bytes, static_cast<std::uint32_t>(value.size()));
+        bytes.insert(bytes.end(), value.cbegin(), value.cend());
+    }
+    bytes.insert(bytes.end(), m_bytes.cbegin(), m_bytes.cend());
+    return bytes;
+}
+
+bool CompressedSegment::deserialize(const std::vector<std::uint8_t>& bytes, CompressedSegment& segment)
+{
+    auto offset = std::size_t{0};
+    auto magic = std::uint32_t{0};
+    auto count = std::uint32_t{0};
+    auto dictionarySize = std::uint32_t{0};
+    auto bits = std::uint64_t{0};
+    if (!take(bytes, offset, magic) || magic != SEGMENT_MAGIC || !take(bytes, offset, count) ||
+        !take(bytes, offset, dictionarySize) || dictionarySize > MAX_DICTIONARY_SIZE || !take(bytes, offset, bits))
+        return false;
+
+    auto result = CompressedSegment{};
+    result.m_dictionary.reserve(dictionarySize);
+    for (auto i = std::uint32_t{0}; i < dictionarySize; ++i)
+    {
+        auto length = std::uint32_t{0};
+        if (!take(bytes, offset, length) || offset + length > bytes.size())
+            return false;
+        result.m_dictionary.emplace_back(reinterpret_cast<const char*>(bytes.data() + offset), length);
+        result.m_lookup.emplace(result.m_dictionary.back(), i);
+        offset += length;
+    }
+    if ((bits + 7) / 8 != bytes.size() - offset)
+        return false;
+    result.m_bytes.assign(bytes.cbegin() + static_cast<std::ptrdiff_t>(offset), bytes.cend());
+    result.m_bits = bits;
+    result.m_count = count;
+
+    // Read through all the readings, to check them and to pick up the state to append the next reading with
+    auto cursor = result.begin();
+    for (auto i = std::uint32_t{0}; i < count; ++i)
+        if (result.read(cursor) == nullptr)
+            return false;
+    if (cursor.m_position != bits || cursor.m_state.known != dictionarySize)
+        return false;
+    result.m_state = cursor.m_state;
+    segment = std::move(result);
+    return true;
+}
+
+void CompressedSegment::writeBits(std::uint64_t value, std::uint32_t count)
+{
+    while (count > 0)
+    {
+        if (m_bits % 8 == 0)
+            m_bytes.push_back(0);
+        const auto free = static_cast<std::uint32_t>(8 - m_bits % 8);
+        const auto taken = std::min(free, count);
+        const auto chunk = (value >> (count - taken)) & ((std::uint64_t{1} << taken) - 1);
+        m_bytes.back() = static_cast<std::uint8_t>(m_bytes.back() | (chunk << (free - taken)));
+        m_bits += taken;
+        count -= taken;
+    }
+}
+
+std::uint64_t CompressedSegment::readBits(Cursor& cursor, std::uint32_t count) const
+{
+    if (cursor.m_position + count > m_bits)
+    {
+        cursor.m_failed = true;
+        return 0;
+    }
+
+    auto value = std::uint64_t{0};
+    while (count > 0)
+    {
+        const auto byte = m_bytes[static_cast<std::size_t>(cursor.m_position / 8)];
+        const auto available = static_cast<std::uint32_t>(8 - cursor.m_position % 8);
+        const auto taken = std::min(available, count);
+        const auto chunk =
+          (static_cast<std::uint64_t>(byte) >> (available - taken)) & ((std::uint64_t{1} << taken) - 1);
+        value = (value << taken) | chunk;
+        cursor.m_position += taken;
+        count -= taken;
+    }
+    return value;
+}
+
+void CompressedSegment::writeIndex(State& state, std::uint32_t index)
+{
+    // An index one past the known entries introduces the next entry of the dictionary
+    writeBits(index, bitsFor(state.known));
+    if (index == state.known)
+        ++state.known;
+}
+
+std::uint32_t CompressedSegment::readIndex(Cursor& cursor) const
+{
+    auto& state = cursor.m_state;
+    const auto index = static_cast<std::uint32_t>(readBits(cursor, bitsFor(state.known)));
+    if (index == state.known)
+        ++state.known;
+    if (index >= m_dictionary.size())
+        cursor.m_failed = true;
+    return index;
+}
+
+void CompressedSegment::writeTimestamp(State& state, std::uint64_t timestamp, bool first)
+{
+    if (first)
+    {
+        writeBits(timestamp, 64);
+        state.timestamp = timestamp;
+        state.delta = 0;
+        return;
+    }
+
+    // The difference of the deltas is zigzag encoded, so small negative differences stay small
+    const auto delta = timestamp - state.timestamp;
+    const auto difference = delta - state.delta;
+    const auto zigzag = (difference << 1) ^ (std::uint64_t{0} - (difference >> 63));
+    if (zigzag == 0)
+    {
+        writeBits(0, 1);
+    }
+    else if (zigzag < (1u << 7))
+    {
+        writeBits(0x2, 2);
+        writeBits(zigzag, 7);
+    }
+    else if (zigzag < (1u << 9))
+    {
+        writeBits(0x6, 3);
+        writeBits(zigzag, 9);
+    }
+    else if (zigzag < (1u << 12))
+    {
+        writeBits(0xE, 4);
+        writeBits(zigzag, 12);
+    }
+    else
+    {
+        writeBits(0xF, 4);
+        writeBits(zigzag, 64);
+    }
+    state.timestamp = timestamp;
+    state.delta = delta;
+}
+
+std::uint64_t CompressedSegment::readTimestamp(Cursor& cursor) const
+{
+    auto& state = cursor.m_state;
+    if (cursor.m_index == 0)
+    {
+        state.timestamp = readBits(cursor, 64);
+        state.delta = 0;
+        return state.timestamp;
+    }
+
+    auto zigzag = std::uint64_t{0};
+    if (readBits(cursor, 1) == 1)
+    {
+        if (readBits(cursor, 1) == 0)
+            zigzag = readBits(cursor, 7);
+        else if (readBits(cursor, 1) == 0)
+            zigzag = readBits(cursor, 9);
+        else if (readBits(cursor, 1) == 0)
+            zigzag = readBits(cursor, 12);
+        else
+            zigzag = readBits(cursor, 64);
+    }
+    const auto difference = (zigzag >> 1) ^ (std::uint64_t{0} - (zigzag & 1));
+    state.delta += difference;
+    state.timestamp += state.delta;
+    return state.timestamp;
+}
+
+std::uint32_t CompressedSegment::lookup(const std::string& value)
+{
+    const auto it = m_lookup.find(value);
+    if (it != m_lookup.cend())
+        return it->second;
+    const auto index = static_cast<std::uint32_t>(m_dictionary.size());
+    m_dictionary.emplace_back(value);
+    m_lookup.emplace(value, index);
+    return index;
+}
+}    // namespace connect
+}    // namespace wolkabout
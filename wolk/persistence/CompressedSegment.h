@@ -0,0 +1,152 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WOLKABOUTCONNECTOR_COMPRESSEDSEGMENT_H
+#define WOLKABOUTCONNECTOR_COMPRESSEDSEGMENT_H
+
+#include "core/model/Reading.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace wolkabout
+{
+namespace connect
+{
+/**
+ * This class holds a sequence of readings in a compact bit stream, for persistence implementations that need to keep
+ * long buffers of readings. Timestamps are stored as deltas of deltas, so regularly sampled readings take up a single
+ * bit for the timestamp. Numeric values are stored as the XOR of the previous value, keeping only the bits that
+ * changed. References and all other values are stored as indexes into a dictionary of the segment.
+ * Values are always read back exactly as they were written, numbers that would not be are kept in the dictionary.
+ * The segment can be turned into bytes, to be written to the disk, and read back from them.
+ */
+class CompressedSegment
+{
+    // The state carried over from one reading to the next one in the stream
+    struct State
+    {
+        std::uint64_t timestamp = 0;
+        std::uint64_t delta = 0;
+        std::uint64_t value = 0;
+        std::uint32_t leading = 0;
+        std::uint32_t length = 0;
+        std::uint32_t precision = 0;
+        std::uint32_t reference = 0;
+        std::uint32_t known = 0;
+    };
+
+public:
+    /**
+     * This class marks the position of a reading in the segment. Reading through a cursor moves it on to the next
+     * reading, and it stays valid while readings are appended to the segment.
+     */
+    class Cursor
+    {
+    public:
+        std::uint32_t getIndex() const { return m_index; }
+
+    private:
+        friend class CompressedSegment;
+
+        std::uint64_t m_position = 0;
+        std::uint32_t m_index = 0;
+        bool m_failed = false;
+        State m_state;
+    };
+
+    /**
+     * This method will append the reading to the end of the segment.
+     *
+     * @param reading The reading.
+     * @return Whether the reading was appended. It is not if the segment is sealed, or its dictionary is full.
+     */
+    bool append(const Reading& reading);
+
+    /**
+     * This method will free up everything that is only needed to append readings. Readings can not be appended to a
+     * sealed segment.
+     */
+    void seal();
+
+    Cursor begin() const;
+
+    /**
+     * This method will read the reading at the cursor, and move the cursor on to the next one.
+     *
+     * @param cursor The cursor.
+     * @return The reading, or nullptr if there are no more readings.
+     */
+    std::shared_ptr<Reading> read(Cursor& cursor) const;
+
+    std::uint32_t getCount() const;
+
+    /**
+     * This method returns the memory taken up by the segment.
+     *
+     * @return The size in bytes.
+     */
+    std::uint64_t getSize() const;
+
+    /**
+     * This method will turn the segment into bytes, that can be turned back into the segment with `deserialize`.
+     *
+     * @return The bytes.
+     */
+    std::vector<std::uint8_t> serialize() const;
+
+    /**
+     * This method will read the segment back from the bytes. Readings can be appended to the segment read back.
+     *
+     * @param bytes The bytes made by `serialize`.
+     * @param segment The segment to read into.
+     * @return Whether the bytes held a valid segment.
+     */
+    static bool deserialize(const std::vector<std::uint8_t>& bytes, CompressedSegment& segment);
+
+    static const constexpr std::uint32_t MAX_DICTIONARY_SIZE = 65535;
+    static const constexpr std::uint32_t MAX_VALUES_COUNT = 65535;
+
+private:
+    void writeBits(std::uint64_t value, std::uint32_t count);
+    // Marks the cursor as failed if there are not enough bits left
+    std::uint64_t readBits(Cursor& cursor, std::uint32_t count) const;
+
+    void writeIndex(State& state, std::uint32_t index);
+    std::uint32_t readIndex(Cursor& cursor) const;
+
+    void writeTimestamp(State& state, std::uint64_t timestamp, bool first);
+    std::uint64_t readTimestamp(Cursor& cursor) const;
+
+    // Returns the index of the value in the dictionary, adding it if it is not there
+    std::uint32_t lookup(const std::string& value);
+
+    std::vector<std::uint8_t> m_bytes;
+    std::uint64_t m_bits = 0;
+    std::uint32_t m_count = 0;
+    bool m_sealed = false;
+    State m_state;
+    std::vector<std::string> m_dictionary;
+    std::unordered_map<std::string, std::uint32_t> m_lookup;
+};
+}    // namespace connect
+}    // namespace wolkabout
+
+#endif    // WOLKABOUTCONNECTOR_COMPRESSEDSEGMENT_H
@@ -0,0 +1,546 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "wolk/persistence/MemoryMappedPersistence.h"
+
+#include "core/utilities/Logger.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace wolkabout
+{
+namespace connect
+{
+namespace
+{
+// The file starts with a header describing the ring, followed by the segments
+const constexpr std::uint32_t FILE_MAGIC = 0x504D4D57;
+const constexpr std::uint32_t FILE_VERSION = 1;
+const constexpr std::uint64_t FILE_HEADER_SIZE = 64;
+
+// Every segment starts with its sequence number, the highest one belonging to the newest segment
+const constexpr std::uint32_t SEGMENT_MAGIC = 0x47455357;
+const constexpr std::uint32_t SEGMENT_HEADER_SIZE = 16;
+const constexpr std::uint32_t MIN_SEGMENT_SIZE = 4096;
+
+// Every record has a header with its size, the checksum of its payload and the flag marking it as removed.
+// The size is written last, so a record that was not fully written is never read back.
+const constexpr std::uint32_t RECORD_HEADER_SIZE = 12;
+const constexpr std::uint32_t RECORD_CHECKSUM_OFFSET = 4;
+const constexpr std::uint32_t RECORD_CONSUMED_OFFSET = 8;
+const constexpr std::uint32_t RECORD_ALIGNMENT = 8;
+
+std::uint32_t checksum(const std::uint8_t* data, std::size_t size)
+{
+    // FNV-1a
+    auto hash = std::uint32_t{2166136261u};
+    for (auto i = std::size_t{0}; i < size; ++i)
+    {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+template <typename T> void append(std::string& buffer, T value)
+{
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Strings are written with their length first, using the given type for the length
+template <typename Length> bool appendString(std::string& buffer, const std::string& value)
+{
+    if (value.size() > std::numeric_limits<Length>::max())
+        return false;
+    append(buffer, static_cast<Length>(value.size()));
+    buffer.append(value);
+    return true;
+}
+}    // namespace
+
+template <typename T> T MemoryMappedPersistence::read(std::uint64_t position) const
+{
+    auto value = T{};
+    std::memcpy(&value, m_memory + position, sizeof(T));
+    return value;
+}
+
+template <typename T> void MemoryMappedPersistence::write(std::uint64_t position, T value)
+{
+    std::memcpy(m_memory + position, &value, sizeof(T));
+}
+
+MemoryMappedPersistence::MemoryMappedPersistence(std::string path, std::uint32_t segmentCount,
+                                                 std::uint32_t segmentSize)
+: m_path(std::move(path))
+, m_segmentCount(std::max(segmentCount, std::uint32_t{2}))
+, m_segmentSize(std::max(segmentSize, MIN_SEGMENT_SIZE))
+, m_file(-1)
+, m_memory(nullptr)
+, m_size(FILE_HEADER_SIZE + static_cast<std::uint64_t>(m_segmentCount) * m_segmentSize)
+, m_head(0)
+, m_sequence(0)
+, m_dropped(0)
+{
+    open();
+    recover();
+}
+
+MemoryMappedPersistence::~MemoryMappedPersistence()
+{
+    sync();
+    ::munmap(m_memory, static_cast<std::size_t>(m_size));
+    ::close(m_file);
+}
+
+bool MemoryMappedPersistence::putReading(const std::string& key, const Reading& reading)
+{
+    // Encode the payload of the record
+    auto payload = std::string{};
+    if (!appendString<std::uint16_t>(payload, key) || !appendString<std::uint16_t>(payload, reading.getReference()))
+    {
+        LOG(ERROR) << "Failed to persist reading -> The key or the reference is too long.";
+        return false;
+    }
+    append(payload, static_cast<std::uint64_t>(reading.getTimestamp()));
+    const auto values = reading.getStringValues();
+    append(payload, static_cast<std::uint16_t>(std::min<std::size_t>(values.size(), 0xFFFF)));
+    for (auto i = std::size_t{0}; i < values.size() && i < 0xFFFF; ++i)
+        if (!appendString<std::uint32_t>(payload, values[i]))
+            return false;
+
+    const auto unaligned = RECORD_HEADER_SIZE + payload.size();
+    const auto size = (unaligned + RECORD_ALIGNMENT - 1) / RECORD_ALIGNMENT * RECORD_ALIGNMENT;
+    if (size > m_segmentSize - SEGMENT_HEADER_SIZE)
+    {
+        LOG(ERROR) << "Failed to persist reading -> The reading is larger than a segment (" << size << " bytes).";
+        return false;
+    }
+    payload.append(size - unaligned, '\0');
+
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    // Move on to the next segment if this one is full, dropping the oldest segment if the ring is full
+    if (m_segments[m_head].used + size > m_segmentSize)
+    {
+        const auto previous = m_head;
+        m_head = nextSegment();
+        if (m_segments[m_head].sequence != 0)
+            dropSegment(m_head);
+        allocateSegment(m_head);
+        if (m_segments[previous].live == 0)
+            releaseSegment(previous);
+        ::msync(m_memory, static_cast<std::size_t>(m_size), MS_ASYNC);
+    }
+
+    // Write the record, ending with its size
+    auto& segment = m_segments[m_head];
+    const auto offset = segment.used;
+    const auto position = segmentStart(m_head) + offset;
+    std::memcpy(m_memory + position + RECORD_HEADER_SIZE, payload.data(), payload.size());
+    write(position + RECORD_CHECKSUM_OFFSET,
+          checksum(reinterpret_cast<const std::uint8_t*>(payload.data()), payload.size()));
+    write(position + RECORD_CONSUMED_OFFSET, std::uint8_t{0});
+    if (offset + size + sizeof(std::uint32_t) <= m_segmentSize)
+        write(position + size, std::uint32_t{0});
+    write(position, static_cast<std::uint32_t>(size));
+
+    segment.used = static_cast<std::uint32_t>(offset + size);
+    ++segment.live;
+    m_readings[key].push_back(Location{m_head, offset});
+    return true;
+}
+
+std::vector<std::shared_ptr<Reading>> MemoryMappedPersistence::getReadings(const std::string& key,
+                                                                           std::uint_fast64_t count)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    auto readings = std::vector<std::shared_ptr<Reading>>{};
+    const auto it = m_readings.find(key);
+    if (it == m_readings.cend())
+        return readings;
+
+    const auto& locations = it->second;
+    const auto size = static_cast<std::size_t>(std::min<std::uint_fast64_t>(count, locations.size()));
+    readings.reserve(size);
+    for (auto i = std::size_t{0}; i < size; ++i)
+        readings.emplace_back(recordReading(locations[i]));
+    return readings;
+}
+
+void MemoryMappedPersistence::removeReadings(const std::string& key, std::uint_fast64_t count)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    const auto it = m_readings.find(key);
+    if (it == m_readings.end())
+        return;
+
+    auto& locations = it->second;
+    for (auto i = std::uint_fast64_t{0}; i < count && !locations.empty(); ++i)
+    {
+        consume(locations.front());
+        locations.pop_front();
+    }
+    if (locations.empty())
+        m_readings.erase(it);
+}
+
+std::vector<std::string> MemoryMappedPersistence::getReadingsKeys()
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    auto keys = std::vector<std::string>{};
+    keys.reserve(m_readings.size());
+    for (const auto& readings : m_readings)
+        keys.emplace_back(readings.first);
+    return keys;
+}
+
+bool MemoryMappedPersistence::putAttribute(const std::string& key, std::shared_ptr<Attribute> attribute)
+{
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    m_attributes[key] = std::move(attribute);
+    return true;
+}
+
+std::map<std::string, std::shared_ptr<Attribute>> MemoryMappedPersistence::getAttributes()
+{
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    return m_attributes;
+}
+
+std::shared_ptr<Attribute> MemoryMappedPersistence::getAttributeUnderKey(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    const auto it = m_attributes.find(key);
+    return it != m_attributes.cend() ? it->second : nullptr;
+}
+
+void MemoryMappedPersistence::removeAttributes()
+{
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    m_attributes.clear();
+}
+
+void MemoryMappedPersistence::removeAttributes(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    m_attributes.erase(key);
+}
+
+std::vector<std::string> MemoryMappedPersistence::getAttributeKeys()
+{
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    auto keys = std::vector<std::string>{};
+    for (const auto& attribute : m_attributes)
+        keys.emplace_back(attribute.first);
+    return keys;
+}
+
+bool MemoryMappedPersistence::putParameter(const std::string& key, Parameter parameter)
+{
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    m_parameters[key] = std::move(parameter);
+    return true;
+}
+
+std::map<std::string, Parameter> MemoryMappedPersistence::getParameters()
+{
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    return m_parameters;
+}
+
+Parameter MemoryMappedPersistence::getParameterForKey(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    const auto it = m_parameters.find(key);
+    return it != m_parameters.cend() ? it->second : Parameter{};
+}
+
+void MemoryMappedPersistence::removeParameters()
+{
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    m_parameters.clear();
+}
+
+void MemoryMappedPersistence::removeParameters(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    m_parameters.erase(key);
+}
+
+std::vector<std::string> MemoryMappedPersistence::getParameterKeys()
+{
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    auto keys = std::vector<std::string>{};
+    for (const auto& parameter : m_parameters)
+        keys.emplace_back(parameter.first);
+    return keys;
+}
+
+bool MemoryMappedPersistence::isEmpty()
+{
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        if (!m_readings.empty())
+            return false;
+    }
+    std::lock_guard<std::mutex> lock{m_detailsMutex};
+    return m_attributes.empty() && m_parameters.empty();
+}
+
+void MemoryMappedPersistence::sync()
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    if (::msync(m_memory, static_cast<std::size_t>(m_size), MS_SYNC) != 0)
+        LOG(ERROR) << "Failed to sync the persistence file '" << m_path << "' -> " << std::strerror(errno);
+}
+
+std::uint64_t MemoryMappedPersistence::getDroppedReadingsCount() const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_dropped;
+}
+
+void MemoryMappedPersistence::open()
+{
+    m_file = ::open(m_path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (m_file < 0)
+        throw std::runtime_error("Failed to open the persistence file '" + m_path + "': " + std::strerror(errno));
+
+    struct stat status{};
+    if (::fstat(m_file, &status) != 0 || static_cast<std::uint64_t>(status.st_size) != m_size)
+    {
+        if (::ftruncate(m_file, static_cast<off_t>(m_size)) != 0)
+        {
+            ::close(m_file);
+            throw std::runtime_error("Failed to resize the persistence file '" + m_path + "': " +
+                                     std::strerror(errno));
+        }
+    }
+
+    auto memory = ::mmap(nullptr, static_cast<std::size_t>(m_size), PROT_READ | PROT_WRITE, MAP_SHARED, m_file, 0);
+    if (memory == MAP_FAILED)
+    {
+        ::close(m_file);
+        throw std::runtime_error("Failed to map the persistence file '" + m_path + "': " + std::strerror(errno));
+    }
+    m_memory = static_cast<std::uint8_t*>(memory);
+
+    // A file that was created for a different ring can not be read
+    if (read<std::uint32_t>(0) != FILE_MAGIC || read<std::uint32_t>(4) != FILE_VERSION ||
+        read<std::uint32_t>(8) != m_segmentSize || read<std::uint32_t>(12) != m_segmentCount)
+        format();
+}
+
+void MemoryMappedPersistence::format()
+{
+    if (read<std::uint32_t>(0) != 0)
+        LOG(WARN) << "The persistence file '" << m_path << "' was created for a different size - Clearing it.";
+    for (auto segment = std::uint32_t{0}; segment < m_segmentCount; ++segment)
+    {
+        write(segmentStart(segment), std::uint64_t{0});
+        write(segmentStart(segment) + 8, std::uint32_t{0});
+    }
+    write(4, FILE_VERSION);
+    write(8, m_segmentSize);
+    write(12, m_segmentCount);
+    write(0, FILE_MAGIC);
+}
+
+void MemoryMappedPersistence::recover()
+{
+    // Find all the records that were not removed, segment by segment
+    m_segments.assign(m_segmentCount, Segment{0, SEGMENT_HEADER_SIZE, 0});
+    auto records = std::vector<std::vector<Location>>(m_segmentCount);
+    auto order = std::vector<std::uint32_t>{};
+    for (auto index = std::uint32_t{0}; index < m_segmentCount; ++index)
+    {
+        const auto start = segmentStart(index);
+        const auto sequence = read<std::uint64_t>(start);
+        if (sequence == 0 || read<std::uint32_t>(start + 8) != SEGMENT_MAGIC)
+            continue;
+
+        auto& segment = m_segments[index];
+        segment.sequence = sequence;
+        auto offset = SEGMENT_HEADER_SIZE;
+        while (const auto size = recordSize(index, offset))
+        {
+            if (read<std::uint8_t>(start + offset + RECORD_CONSUMED_OFFSET) == 0)
+                records[index].push_back(Location{index, offset});
+            offset += size;
+        }
+        segment.used = offset;
+        segment.live = static_cast<std::uint32_t>(records[index].size());
+        order.emplace_back(index);
+        m_sequence = std::max(m_sequence, sequence);
+    }
+    if (order.empty())
+    {
+        m_head = 0;
+        allocateSegment(m_head);
+        return;
+    }
+
+    // Index the records from the oldest segment to the newest
+    std::sort(order.begin(), order.end(), [&](std::uint32_t lhs, std::uint32_t rhs) {
+        return m_segments[lhs].sequence < m_segments[rhs].sequence;
+    });
+    m_head = order.back();
+    auto recovered = std::uint64_t{0};
+    for (const auto index : order)
+    {
+        for (const auto& location : records[index])
+            m_readings[recordKey(location)].push_back(location);
+        recovered += records[index].size();
+        if (m_segments[index].live == 0 && index != m_head)
+            releaseSegment(index);
+    }
+    if (recovered > 0)
+        LOG(INFO) << "Recovered " << recovered << " readings from the persistence file '" << m_path << "'.";
+}
+
+std::uint64_t MemoryMappedPersistence::segmentStart(std::uint32_t segment) const
+{
+    return FILE_HEADER_SIZE + static_cast<std::uint64_t>(segment) * m_segmentSize;
+}
+
+std::uint32_t MemoryMappedPersistence::recordSize(std::uint32_t segment, std::uint32_t offset) const
+{
+    if (offset + RECORD_HEADER_SIZE > m_segmentSize)
+        return 0;
+    const auto position = segmentStart(segment) + offset;
+    const auto size = read<std::uint32_t>(position);
+    if (size < RECORD_HEADER_SIZE || size > m_segmentSize - offset)
+        return 0;
+    const auto expected = read<std::uint32_t>(position + RECORD_CHECKSUM_OFFSET);
+    if (checksum(m_memory + position + RECORD_HEADER_SIZE, size - RECORD_HEADER_SIZE) != expected)
+        return 0;
+    return size;
+}
+
+std::string MemoryMappedPersistence::recordKey(const Location& location) const
+{
+    const auto position = segmentStart(location.segment) + location.offset + RECORD_HEADER_SIZE;
+    const auto size = read<std::uint16_t>(position);
+    return std::string{reinterpret_cast<const char*>(m_memory + position + sizeof(std::uint16_t)), size};
+}
+
+std::shared_ptr<Reading> MemoryMappedPersistence::recordReading(const Location& location) const
+{
+    auto position = segmentStart(location.segment) + location.offset + RECORD_HEADER_SIZE;
+    auto readString = [&](std::size_t lengthSize) -> std::string {
+        const auto size = lengthSize == sizeof(std::uint16_t) ? read<std::uint16_t>(position) :
+                                                                 read<std::uint32_t>(position);
+        position += lengthSize;
+        auto value = std::string{reinterpret_cast<const char*>(m_memory + position), size};
+        position += size;
+        return value;
+    };
+
+    readString(sizeof(std::uint16_t));
+    auto reference = readString(sizeof(std::uint16_t));
+    const auto timestamp = read<std::uint64_t>(position);
+    position += sizeof(std::uint64_t);
+    const auto count = read<std::uint16_t>(position);
+    position += sizeof(std::uint16_t);
+    auto values = std::vector<std::string>{};
+    values.reserve(count);
+    for (auto i = 0; i < count; ++i)
+        values.emplace_back(readString(sizeof(std::uint32_t)));
+
+    if (values.size() == 1)
+        return std::make_shared<Reading>(std::move(reference), std::move(values.front()), timestamp);
+    return std::make_shared<Reading>(std::move(reference), std::move(values), timestamp);
+}
+
+std::uint32_t MemoryMappedPersistence::nextSegment() const
+{
+    // Old segments can still be pinned by readings that are not removed yet, while newer ones were already released
+    auto oldest = (m_head + 1) % m_segmentCount;
+    for (auto i = std::uint32_t{1}; i < m_segmentCount; ++i)
+    {
+        const auto segment = (m_head + i) % m_segmentCount;
+        if (m_segments[segment].sequence == 0)
+            return segment;
+        if (m_segments[segment].sequence < m_segments[oldest].sequence)
+            oldest = segment;
+    }
+    return oldest;
+}
+
+void MemoryMappedPersistence::allocateSegment(std::uint32_t segment)
+{
+    const auto start = segmentStart(segment);
+    write(start + SEGMENT_HEADER_SIZE, std::uint32_t{0});
+    write(start + 8, SEGMENT_MAGIC);
+    write(start, ++m_sequence);
+    m_segments[segment] = Segment{m_sequence, SEGMENT_HEADER_SIZE, 0};
+}
+
+void MemoryMappedPersistence::releaseSegment(std::uint32_t segment)
+{
+    write(segmentStart(segment), std::uint64_t{0});
+    m_segments[segment] = Segment{0, SEGMENT_HEADER_SIZE, 0};
+}
+
+void MemoryMappedPersistence::dropSegment(std::uint32_t segment)
+{
+    // This is the oldest segment, so its readings are the first ones waiting under their keys
+    auto dropped = std::uint64_t{0};
+    const auto start = segmentStart(segment);
+    for (auto offset = SEGMENT_HEADER_SIZE; offset < m_segments[segment].used;)
+    {
+        const auto size = recordSize(segment, offset);
+        if (size == 0)
+            break;
+        if (read<std::uint8_t>(start + offset + RECORD_CONSUMED_OFFSET) == 0)
+        {
+            const auto it = m_readings.find(recordKey(Location{segment, offset}));
+            if (it != m_readings.end() && !it->second.empty() && it->second.front().segment == segment)
+            {
+                it->second.pop_front();
+                if (it->second.empty())
+                    m_readings.erase(it);
+                ++dropped;
+            }
+        }
+        offset += size;
+    }
+    if (dropped > 0)
+        LOG(WARN) << "The persistence file '" << m_path << "' is full - Dropped " << dropped << " oldest readings.";
+    m_dropped += dropped;
+    releaseSegment(segment);
+}
+
+void MemoryMappedPersistence::consume(const Location& location)
+{
+    write(segmentStart(location.segment) + location.offset + RECORD_CONSUMED_OFFSET, std::uint8_t{1});
+    auto& segment = m_segments[location.segment];
+    if (segment.live > 0 && --segment.live == 0 && location.segment != m_head)
+        releaseSegment(location.segment);
+}
+}    // namespace connect
+}    // namespace wolkabout
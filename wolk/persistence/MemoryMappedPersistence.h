@@ -0,0 +1,152 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WOLKABOUTCONNECTOR_MEMORYMAPPEDPERSISTENCE_H
+#define WOLKABOUTCONNECTOR_MEMORYMAPPEDPERSISTENCE_H
+
+#include "core/persistence/Persistence.h"
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace wolkabout
+{
+namespace connect
+{
+/**
+ * This class is a `Persistence` that keeps readings in a file, so they survive restarts of the application.
+ * The file is a fixed-size ring of segments mapped into memory. Readings are appended to the newest segment, and a
+ * segment is reused once all readings in it have been removed. When the ring is full, the oldest segment is dropped
+ * with all the readings in it, so the disk use and the memory footprint stay bounded.
+ * Attributes and parameters are kept in memory, as there are only a few of them and they are set again on start.
+ */
+class MemoryMappedPersistence : public Persistence
+{
+public:
+    /**
+     * Default parameter constructor. Readings that are already in the file are recovered.
+     * If the file was created with a different size, it is cleared.
+     * The constructor will throw an exception if the file can not be created or mapped into memory.
+     *
+     * @param path The path to the file.
+     * @param segmentCount The count of segments in the ring. At least two segments are used.
+     * @param segmentSize The size of a single segment (in bytes). A single reading needs to fit in a segment.
+     */
+    explicit MemoryMappedPersistence(std::string path, std::uint32_t segmentCount = DEFAULT_SEGMENT_COUNT,
+                                     std::uint32_t segmentSize = DEFAULT_SEGMENT_SIZE);
+
+    ~MemoryMappedPersistence() override;
+
+    bool putReading(const std::string& key, const Reading& reading) override;
+    std::vector<std::shared_ptr<Reading>> getReadings(const std::string& key, std::uint_fast64_t count) override;
+    void removeReadings(const std::string& key, std::uint_fast64_t count) override;
+    std::vector<std::string> getReadingsKeys() override;
+
+    bool putAttribute(const std::string& key, std::shared_ptr<Attribute> attribute) override;
+    std::map<std::string, std::shared_ptr<Attribute>> getAttributes() override;
+    std::shared_ptr<Attribute> getAttributeUnderKey(const std::string& key) override;
+    void removeAttributes() override;
+    void removeAttributes(const std::string& key) override;
+    std::vector<std::string> getAttributeKeys() override;
+
+    bool putParameter(const std::string& key, Parameter parameter) override;
+    std::map<std::string, Parameter> getParameters() override;
+    Parameter getParameterForKey(const std::string& key) override;
+    void removeParameters() override;
+    void removeParameters(const std::string& key) override;
+    std::vector<std::string> getParameterKeys() override;
+
+    bool isEmpty() override;
+
+    /**
+     * This method will write all the changes to the file out to the disk, and wait for it to finish.
+     */
+    void sync();
+
+    /**
+     * This method returns the count of readings that were dropped because the ring was full.
+     *
+     * @return The count of dropped readings.
+     */
+    std::uint64_t getDroppedReadingsCount() const;
+
+    static const constexpr std::uint32_t DEFAULT_SEGMENT_COUNT = 64;
+    static const constexpr std::uint32_t DEFAULT_SEGMENT_SIZE = 1024 * 1024;
+
+private:
+    struct Location
+    {
+        std::uint32_t segment;
+        std::uint32_t offset;
+    };
+
+    struct Segment
+    {
+        std::uint64_t sequence;    // Zero for a segment that is free
+        std::uint32_t used;        // The offset after the last record
+        std::uint32_t live;        // The count of records not yet removed
+    };
+
+    void open();
+    void format();
+    void recover();
+
+    std::uint64_t segmentStart(std::uint32_t segment) const;
+
+    // Returns the size of the record in the segment at the offset, or zero if there is no valid record there
+    std::uint32_t recordSize(std::uint32_t segment, std::uint32_t offset) const;
+    std::string recordKey(const Location& location) const;
+    std::shared_ptr<Reading> recordReading(const Location& location) const;
+
+    // Returns the segment to write into after the head, a free one if there is any, and the oldest one otherwise
+    std::uint32_t nextSegment() const;
+    void allocateSegment(std::uint32_t segment);
+    void releaseSegment(std::uint32_t segment);
+    void dropSegment(std::uint32_t segment);
+    void consume(const Location& location);
+
+    template <typename T> T read(std::uint64_t position) const;
+    template <typename T> void write(std::uint64_t position, T value);
+
+    const std::string m_path;
+    const std::uint32_t m_segmentCount;
+    const std::uint32_t m_segmentSize;
+
+    int m_file;
+    std::uint8_t* m_memory;
+    std::uint64_t m_size;
+
+    mutable std::mutex m_mutex;
+    std::vector<Segment> m_segments;
+    std::uint32_t m_head;
+    std::uint64_t m_sequence;
+    std::uint64_t m_dropped;
+    std::unordered_map<std::string, std::deque<Location>> m_readings;
+
+    std::mutex m_detailsMutex;
+    std::map<std::string, std::shared_ptr<Attribute>> m_attributes;
+    std::map<std::string, Parameter> m_parameters;
+};
+}    // namespace connect
+}    // namespace wolkabout
+
+#endif    // WOLKABOUTCONNECTOR_MEMORYMAPPEDPERSISTENCE_H
@@ -0,0 +1,246 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/persistence/TieredPersistence.h"
+
+#include "core/utilities/Logger.h"
+#include "wolk/persistence/BoundedInMemoryPersistence.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace wolkabout
+{
+namespace connect
+{
+TieredPersistence::TieredPersistence(std::unique_ptr<Persistence> diskTier, std::uint64_t memoryBytes)
+: m_diskTier(std::move(diskTier)), m_memoryBytes(memoryBytes), m_sequence(0), m_size(0), m_spilled(0)
+{
+    if (m_diskTier == nullptr)
+        throw std::runtime_error("Failed to create the tiered persistence -> The disk tier is missing.");
+
+    // The readings left in the disk tier are all older than anything that will be put in the memory tier. They are
+    // only counted once they are read, as reading them all here could take long.
+    for (const auto& key : m_diskTier->getReadingsKeys())
+        m_feeds[key].uncounted = true;
+}
+
+bool TieredPersistence::putReading(const std::string& key, const Reading& reading)
+{
+    const auto size = BoundedInMemoryPersistence::estimateSize(reading) + key.size();
+
+    std::lock_guard<std::mutex> lock{m_mutex};
+    auto& entries = m_feeds[key].entries;
+    if (entries.empty())
+        m_fronts.emplace(m_sequence, key);
+    entries.push_back(Entry{m_sequence++, size, std::make_shared<Reading>(reading)});
+    m_size += size;
+
+    if (m_size > m_memoryBytes)
+        spill();
+    return true;
+}
+
+std::vector<std::shared_ptr<Reading>> TieredPersistence::getReadings(const std::string& key,
+                                                                     std::uint_fast64_t count)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    auto readings = std::vector<std::shared_ptr<Reading>>{};
+    const auto it = m_feeds.find(key);
+    if (it == m_feeds.end())
+        return readings;
+
+    // The oldest readings are read back from the disk tier, which might have dropped some of them in the meantime
+    auto& feed = it->second;
+    if (feed.spilled > 0 || feed.uncounted)
+        readings = readSpilled(key, feed, count);
+
+    for (auto i = std::size_t{0}; i < feed.entries.size() && readings.size() < count; ++i)
+        readings.emplace_back(feed.entries[i].reading);
+    eraseIfEmpty(it);
+    return readings;
+}
+
+void TieredPersistence::removeReadings(const std::string& key, std::uint_fast64_t count)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    const auto it = m_feeds.find(key);
+    if (it == m_feeds.end())
+        return;
+
+    auto& feed = it->second;
+    if (feed.uncounted && count > feed.spilled)
+        readSpilled(key, feed, count);
+    const auto spilled = std::min<std::uint_fast64_t>(count, feed.spilled);
+    if (spilled > 0)
+    {
+        m_diskTier->removeReadings(key, spilled);
+        feed.spilled -= spilled;
+    }
+
+    const auto remaining = std::min<std::uint_fast64_t>(count - spilled, feed.entries.size());
+    for (auto i = std::uint_fast64_t{0}; i < remaining; ++i)
+        popFront(it);
+
+    // Once the counted readings are gone, check whether the disk tier holds any more of them
+    if (feed.uncounted && feed.spilled == 0)
+        readSpilled(key, feed, 1);
+    eraseIfEmpty(it);
+}
+
+std::vector<std::string> TieredPersistence::getReadingsKeys()
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    auto keys = std::vector<std::string>{};
+    keys.reserve(m_feeds.size());
+    for (const auto& feed : m_feeds)
+        keys.emplace_back(feed.first);
+    return keys;
+}
+
+bool TieredPersistence::putAttribute(const std::string& key, std::shared_ptr<Attribute> attribute)
+{
+    return m_diskTier->putAttribute(key, std::move(attribute));
+}
+
+std::map<std::string, std::shared_ptr<Attribute>> TieredPersistence::getAttributes()
+{
+    return m_diskTier->getAttributes();
+}
+
+std::shared_ptr<Attribute> TieredPersistence::getAttributeUnderKey(const std::string& key)
+{
+    return m_diskTier->getAttributeUnderKey(key);
+}
+
+void TieredPersistence::removeAttributes()
+{
+    m_diskTier->removeAttributes();
+}
+
+void TieredPersistence::removeAttributes(const std::string& key)
+{
+    m_diskTier->removeAttributes(key);
+}
+
+std::vector<std::string> TieredPersistence::getAttributeKeys()
+{
+    return m_diskTier->getAttributeKeys();
+}
+
+bool TieredPersistence::putParameter(const std::string& key, Parameter parameter)
+{
+    return m_diskTier->putParameter(key, std::move(parameter));
+}
+
+std::map<std::string, Parameter> TieredPersistence::getParameters()
+{
+    return m_diskTier->getParameters();
+}
+
+Parameter TieredPersistence::getParameterForKey(const std::string& key)
+{
+    return m_diskTier->getParameterForKey(key);
+}
+
+void TieredPersistence::removeParameters()
+{
+    m_diskTier->removeParameters();
+}
+
+void TieredPersistence::removeParameters(const std::string& key)
+{
+    m_diskTier->removeParameters(key);
+}
+
+std::vector<std::string> TieredPersistence::getParameterKeys()
+{
+    return m_diskTier->getParameterKeys();
+}
+
+bool TieredPersistence::isEmpty()
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_feeds.empty() && m_diskTier->isEmpty();
+}
+
+std::uint64_t TieredPersistence::getMemoryTierSize() const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_size;
+}
+
+std::uint64_t TieredPersistence::getSpilledReadingsCount() const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_spilled;
+}
+
+void TieredPersistence::spill()
+{
+    // Spilling down to three quarters of the cap leaves room for a burst of readings before the disk is touched again
+    const auto watermark = m_memoryBytes - m_memoryBytes / 4;
+    while (m_size > watermark && !m_fronts.empty())
+    {
+        const auto it = m_feeds.find(m_fronts.cbegin()->second);
+        if (m_diskTier->putReading(it->first, *it->second.entries.front().reading))
+        {
+            ++it->second.spilled;
+            ++m_spilled;
+        }
+        else
+        {
+            LOG(WARN) << "Failed to spill reading to the disk tier -> The reading is dropped.";
+        }
+        popFront(it);
+        eraseIfEmpty(it);
+    }
+}
+
+std::vector<std::shared_ptr<Reading>> TieredPersistence::readSpilled(const std::string& key, FeedReadings& feed,
+                                                                     std::uint_fast64_t count)
+{
+    auto readings = m_diskTier->getReadings(key, count);
+    if (feed.uncounted)
+    {
+        // Once the disk tier returns less than asked for, all of its readings of the feed are counted
+        feed.uncounted = readings.size() == count;
+        feed.spilled = feed.uncounted ? std::max<std::uint64_t>(feed.spilled, readings.size()) : readings.size();
+    }
+    else if (readings.size() < std::min<std::uint_fast64_t>(count, feed.spilled))
+        feed.spilled = readings.size();
+    return readings;
+}
+
+void TieredPersistence::popFront(std::unordered_map<std::string, FeedReadings>::iterator it)
+{
+    auto& entries = it->second.entries;
+    m_fronts.erase(entries.front().sequence);
+    m_size -= entries.front().size;
+    entries.pop_front();
+    if (!entries.empty())
+        m_fronts.emplace(entries.front().sequence, it->first);
+}
+
+void TieredPersistence::eraseIfEmpty(std::unordered_map<std::string, FeedReadings>::iterator it)
+{
+    if (it->second.spilled == 0 && !it->second.uncounted && it->second.entries.empty())
+        m_feeds.erase(it);
+}
+}    // namespace connect
+}    // namespace wolkabout
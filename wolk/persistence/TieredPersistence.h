@@ -0,0 +1,134 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WOLKABOUTCONNECTOR_TIEREDPERSISTENCE_H
+#define WOLKABOUTCONNECTOR_TIEREDPERSISTENCE_H
+
+#include "core/persistence/Persistence.h"
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace wolkabout
+{
+namespace connect
+{
+/**
+ * This class is a `Persistence` made out of two tiers. The newest readings are kept in memory, up to a cap on the
+ * memory they take up, so they are stored and published without touching the disk. Once the memory tier is full, its
+ * oldest readings are spilled to the disk tier (usually a `MemoryMappedPersistence`), and they are read back from it
+ * only when they are published. Readings of a feed are always returned from the oldest one, across both tiers.
+ * Only the readings that were spilled survive a restart of the application.
+ * Attributes and parameters are kept by the disk tier.
+ */
+class TieredPersistence : public Persistence
+{
+public:
+    /**
+     * Default parameter constructor. Readings the disk tier already holds are published before the new ones. They
+     * are counted as they are read back, so the constructor does not read them.
+     * The constructor will throw an exception if the disk tier is missing.
+     *
+     * @param diskTier The persistence the readings are spilled to.
+     * @param memoryBytes The cap on the memory taken up by the readings in the memory tier (in bytes).
+     */
+    explicit TieredPersistence(std::unique_ptr<Persistence> diskTier,
+                               std::uint64_t memoryBytes = DEFAULT_MEMORY_BYTES);
+
+    bool putReading(const std::string& key, const Reading& reading) override;
+    std::vector<std::shared_ptr<Reading>> getReadings(const std::string& key, std::uint_fast64_t count) override;
+    void removeReadings(const std::string& key, std::uint_fast64_t count) override;
+    std::vector<std::string> getReadingsKeys() override;
+
+    bool putAttribute(const std::string& key, std::shared_ptr<Attribute> attribute) override;
+    std::map<std::string, std::shared_ptr<Attribute>> getAttributes() override;
+    std::shared_ptr<Attribute> getAttributeUnderKey(const std::string& key) override;
+    void removeAttributes() override;
+    void removeAttributes(const std::string& key) override;
+    std::vector<std::string> getAttributeKeys() override;
+
+    bool putParameter(const std::string& key, Parameter parameter) override;
+    std::map<std::string, Parameter> getParameters() override;
+    Parameter getParameterForKey(const std::string& key) override;
+    void removeParameters() override;
+    void removeParameters(const std::string& key) override;
+    std::vector<std::string> getParameterKeys() override;
+
+    bool isEmpty() override;
+
+    /**
+     * This method returns the memory currently taken up by the readings in the memory tier.
+     *
+     * @return The size in bytes.
+     */
+    std::uint64_t getMemoryTierSize() const;
+
+    /**
+     * This method returns the count of readings that were spilled to the disk tier so far.
+     *
+     * @return The count of spilled readings.
+     */
+    std::uint64_t getSpilledReadingsCount() const;
+
+    static const constexpr std::uint64_t DEFAULT_MEMORY_BYTES = 4 * 1024 * 1024;
+
+private:
+    struct Entry
+    {
+        std::uint64_t sequence;
+        std::uint64_t size;
+        std::shared_ptr<Reading> reading;
+    };
+
+    struct FeedReadings
+    {
+        // The count of the oldest readings of the feed that are in the disk tier
+        std::uint64_t spilled = 0;
+        // Whether the disk tier may hold more of them than counted, as they were left there before a restart
+        bool uncounted = false;
+        std::deque<Entry> entries;
+    };
+
+    // Spills the oldest readings of the memory tier until it is below the low watermark
+    void spill();
+    // Reads the oldest readings of the feed from the disk tier, and learns from them how many it holds
+    std::vector<std::shared_ptr<Reading>> readSpilled(const std::string& key, FeedReadings& feed,
+                                                      std::uint_fast64_t count);
+    void popFront(std::unordered_map<std::string, FeedReadings>::iterator it);
+    void eraseIfEmpty(std::unordered_map<std::string, FeedReadings>::iterator it);
+
+    const std::unique_ptr<Persistence> m_diskTier;
+    const std::uint64_t m_memoryBytes;
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, FeedReadings> m_feeds;
+    // The sequence of the first reading of every feed in the memory tier, ordered from the oldest one
+    std::map<std::uint64_t, std::string> m_fronts;
+    std::uint64_t m_sequence;
+    std::uint64_t m_size;
+    std::uint64_t m_spilled;
+};
+}    // namespace connect
+}    // namespace wolkabout
+
+#endif    // WOLKABOUTCONNECTOR_TIEREDPERSISTENCE_H
@@ -0,0 +1,177 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/service/data/CatchUpAggregator.h"
+
+#include "wolk/service/data/ReadingValue.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+namespace wolkabout
+{
+namespace connect
+{
+namespace
+{
+bool parseNumber(const std::string& value, double& number)
+{
+    char* end = nullptr;
+    errno = 0;
+    number = std::strtod(value.c_str(), &end);
+    return !value.empty() && end == value.c_str() + value.size() && errno == 0 && std::isfinite(number);
+}
+
+std::uint64_t currentTime()
+{
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                        std::chrono::system_clock::now().time_since_epoch())
+                                        .count());
+}
+}    // namespace
+
+void CatchUpAggregator::setPolicy(const CatchUpPolicy& policy)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_policy = policy;
+}
+
+CatchUpPolicy CatchUpAggregator::getPolicy() const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_policy;
+}
+
+std::vector<FoldedReading> CatchUpAggregator::fold(const std::vector<std::shared_ptr<Reading>>& readings) const
+{
+    return fold(readings, currentTime());
+}
+
+std::vector<FoldedReading> CatchUpAggregator::fold(const std::vector<std::shared_ptr<Reading>>& readings,
+                                                   std::uint64_t now) const
+{
+    const auto policy = getPolicy();
+    auto folded = std::vector<FoldedReading>{};
+    folded.reserve(readings.size());
+    if (!policy.isEnabled())
+    {
+        for (const auto& reading : readings)
+            folded.emplace_back(FoldedReading{*reading, 1});
+        return folded;
+    }
+
+    const auto window = static_cast<std::uint64_t>(policy.getWindow().count());
+
+    for (auto i = std::size_t{0}; i < readings.size();)
+    {
+        if (!isOld(policy, *readings[i], now))
+        {
+            folded.emplace_back(FoldedReading{*readings[i], 1});
+            ++i;
+            continue;
+        }
+
+        // Take all the consecutive old readings that fall into the same window
+        const auto windowStart = readings[i]->getTimestamp() - readings[i]->getTimestamp() % window;
+        auto end = i + 1;
+        while (end < readings.size() && isOld(policy, *readings[end], now) &&
+               readings[end]->getTimestamp() >= windowStart && readings[end]->getTimestamp() - windowStart < window)
+            ++end;
+        folded.emplace_back(aggregate(policy, readings, i, end, windowStart));
+        i = end;
+    }
+    return folded;
+}
+
+bool CatchUpAggregator::isFoldable(const Reading& reading) const
+{
+    return isFoldable(reading, currentTime());
+}
+
+bool CatchUpAggregator::isFoldable(const Reading& reading, std::uint64_t now) const
+{
+    const auto policy = getPolicy();
+    return policy.isEnabled() && isOld(policy, reading, now);
+}
+
+bool CatchUpAggregator::isOld(const CatchUpPolicy& policy, const Reading& reading, std::uint64_t now)
+{
+    const auto maxAge = static_cast<std::uint64_t>(policy.getMaxAge().count());
+    const auto cutoff = now > maxAge ? now - maxAge : std::uint64_t{0};
+    return reading.getTimestamp() != 0 && reading.getTimestamp() < cutoff && reading.getStringValues().size() == 1;
+}
+
+FoldedReading CatchUpAggregator::aggregate(const CatchUpPolicy& policy,
+                                           const std::vector<std::shared_ptr<Reading>>& readings, std::size_t begin,
+                                           std::size_t end, std::uint64_t windowStart)
+{
+    const auto count = static_cast<std::uint64_t>(end - begin);
+    if (count == 1)
+        return FoldedReading{*readings[begin], 1};
+
+    const auto& reference = readings[begin]->getReference();
+    auto function = policy.getNumericFunction();
+    const auto needsNumbers = function != AggregateFunction::First && function != AggregateFunction::Last;
+    auto sum = 0.0;
+    auto minimum = begin;
+    auto maximum = begin;
+    auto minimumValue = 0.0;
+    auto maximumValue = 0.0;
+    for (auto i = begin; needsNumbers && i < end; ++i)
+    {
+        auto number = 0.0;
+        if (!parseNumber(readings[i]->getStringValue(), number))
+        {
+            // A single value that is not a number makes the whole window fold as text
+            function = policy.getTextFunction();
+            break;
+        }
+        sum += number;
+        if (i == begin || number < minimumValue)
+        {
+            minimum = i;
+            minimumValue = number;
+        }
+        if (i == begin || number > maximumValue)
+        {
+            maximum = i;
+            maximumValue = number;
+        }
+    }
+
+    switch (function)
+    {
+    case AggregateFunction::Average:
+        return FoldedReading{Reading{reference, ReadingValue{sum / static_cast<double>(count)}.toString(), windowStart},
+                             count};
+    case AggregateFunction::Minimum:
+        return FoldedReading{*readings[minimum], count};
+    case AggregateFunction::Maximum:
+        return FoldedReading{*readings[maximum], count};
+    case AggregateFunction::Count:
+        return FoldedReading{Reading{reference, ReadingValue{count}.toString(), windowStart}, count};
+    case AggregateFunction::First:
+        return FoldedReading{*readings[begin], count};
+    case AggregateFunction::Last:
+    default:
+        return FoldedReading{*readings[end - 1], count};
+    }
+}
+}    // namespace connect
+}    // namespace wolkabout
@@ -0,0 +1,99 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WOLKABOUTCONNECTOR_CATCHUPAGGREGATOR_H
+#define WOLKABOUTCONNECTOR_CATCHUPAGGREGATOR_H
+
+#include "core/model/Reading.h"
+#include "wolk/service/data/CatchUpPolicy.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace wolkabout
+{
+namespace connect
+{
+// A reading that is published in place of a count of readings from the persistence.
+struct FoldedReading
+{
+    Reading reading;
+    std::uint64_t count;
+};
+
+/**
+ * This class applies the `CatchUpPolicy` to the readings of a feed that are about to be published.
+ * Consecutive old readings that fall into the same window are folded into one. Averages and counts are stamped with
+ * the start of the window, while the other functions keep the reading they pick, with its own timestamp.
+ * Readings without a timestamp and readings with multiple values are never folded.
+ */
+class CatchUpAggregator
+{
+public:
+    void setPolicy(const CatchUpPolicy& policy);
+
+    CatchUpPolicy getPolicy() const;
+
+    /**
+     * This method will fold the readings of a single feed, using the current time to tell which ones are old.
+     *
+     * @param readings The readings of the feed, from the oldest one.
+     * @return The readings to publish, each with the count of readings it stands for.
+     */
+    std::vector<FoldedReading> fold(const std::vector<std::shared_ptr<Reading>>& readings) const;
+
+    /**
+     * This method will fold the readings of a single feed.
+     *
+     * @param readings The readings of the feed, from the oldest one.
+     * @param now The current time (in milliseconds).
+     * @return The readings to publish, each with the count of readings it stands for.
+     */
+    std::vector<FoldedReading> fold(const std::vector<std::shared_ptr<Reading>>& readings, std::uint64_t now) const;
+
+    /**
+     * This method checks whether a reading is old enough to be folded, using the current time.
+     *
+     * @param reading The reading to check.
+     * @return Whether the policy is enabled, and the reading would be folded with the readings of its window.
+     */
+    bool isFoldable(const Reading& reading) const;
+
+    /**
+     * This method checks whether a reading is old enough to be folded.
+     *
+     * @param reading The reading to check.
+     * @param now The current time (in milliseconds).
+     * @return Whether the policy is enabled, and the reading would be folded with the readings of its window.
+     */
+    bool isFoldable(const Reading& reading, std::uint64_t now) const;
+
+private:
+    static bool isOld(const CatchUpPolicy& policy, const Reading& reading, std::uint64_t now);
+
+    static FoldedReading aggregate(const CatchUpPolicy& policy, const std::vector<std::shared_ptr<Reading>>& readings,
+                                   std::size_t begin, std::size_t end, std::uint64_t windowStart);
+
+    mutable std::mutex m_mutex;
+    CatchUpPolicy m_policy;
+};
+}    // namespace connect
+}    // namespace wolkabout
+
+#endif    // WOLKABOUTCONNECTOR_CATCHUPAGGREGATOR_H
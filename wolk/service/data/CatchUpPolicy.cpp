@@ -0,0 +1,58 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/service/data/CatchUpPolicy.h"
+
+namespace wolkabout
+{
+namespace connect
+{
+CatchUpPolicy::CatchUpPolicy(std::chrono::milliseconds maxAge, std::chrono::milliseconds window,
+                             AggregateFunction numericFunction, AggregateFunction textFunction)
+: m_maxAge(maxAge)
+, m_window(window)
+, m_numericFunction(numericFunction)
+, m_textFunction(textFunction == AggregateFunction::First ? AggregateFunction::First : AggregateFunction::Last)
+{
+}
+
+bool CatchUpPolicy::isEnabled() const
+{
+    return m_maxAge.count() > 0 && m_window.count() > 0;
+}
+
+std::chrono::milliseconds CatchUpPolicy::getMaxAge() const
+{
+    return m_maxAge;
+}
+
+std::chrono::milliseconds CatchUpPolicy::getWindow() const
+{
+    return m_window;
+}
+
+AggregateFunction CatchUpPolicy::getNumericFunction() const
+{
+    return m_numericFunction;
+}
+
+AggregateFunction CatchUpPolicy::getTextFunction() const
+{
+    return m_textFunction;
+}
+}    // namespace connect
+}    // namespace wolkabout
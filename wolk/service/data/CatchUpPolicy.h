@@ -0,0 +1,85 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WOLKABOUTCONNECTOR_CATCHUPPOLICY_H
+#define WOLKABOUTCONNECTOR_CATCHUPPOLICY_H
+
+#include <chrono>
+
+namespace wolkabout
+{
+namespace connect
+{
+// The ways the readings of a feed in a single window can be folded into one reading.
+enum class AggregateFunction
+{
+    Average = 0,
+    Minimum,
+    Maximum,
+    Count,
+    First,
+    Last
+};
+
+/**
+ * This class describes how a backlog of readings is caught up with once the connection comes back.
+ * Readings older than the maximum age are folded into one reading per window of time for every feed, while the newer
+ * readings are published as they are. Numeric readings are folded with the numeric function, and all other readings
+ * are folded by keeping either the first or the last reading of the window.
+ */
+class CatchUpPolicy
+{
+public:
+    /**
+     * Default parameter constructor. The policy is disabled unless both the maximum age and the window are set.
+     *
+     * @param maxAge The age after which readings are folded.
+     * @param window The length of the window readings are folded in.
+     * @param numericFunction The function folding numeric readings.
+     * @param textFunction The function folding other readings. Only `First` and `Last` are used, anything else
+     * means `Last`.
+     */
+    explicit CatchUpPolicy(std::chrono::milliseconds maxAge = std::chrono::milliseconds{0},
+                           std::chrono::milliseconds window = std::chrono::milliseconds{0},
+                           AggregateFunction numericFunction = AggregateFunction::Average,
+                           AggregateFunction textFunction = AggregateFunction::Last);
+
+    /**
+     * This method checks whether the policy folds any readings.
+     *
+     * @return Whether old readings are folded.
+     */
+    bool isEnabled() const;
+
+    std::chrono::milliseconds getMaxAge() const;
+
+    std::chrono::milliseconds getWindow() const;
+
+    AggregateFunction getNumericFunction() const;
+
+    AggregateFunction getTextFunction() const;
+
+private:
+    std::chrono::milliseconds m_maxAge;
+    std::chrono::milliseconds m_window;
+    AggregateFunction m_numericFunction;
+    AggregateFunction m_textFunction;
+};
+}    // namespace connect
+}    // namespace wolkabout
+
+#endif    // WOLKABOUTCONNECTOR_CATCHUPPOLICY_H
@@ -25,6 +25,7 @@
 #include "core/persistence/Persistence.h"
 #include "core/protocol/DataProtocol.h"
 #include "core/utilities/Logger.h"
+#include "wolk/utilities/CommandQueue.h"
 
 #include <algorithm>
 #include <cassert>
@@ -45,7 +46,7 @@ const std::string DataService::PERSISTENCE_KEY_DELIMITER = "+";
 DataService::DataService(DataProtocol& protocol, Persistence& persistence, ConnectivityService& connectivityService,
                          OutboundRetryMessageHandler& outboundRetryMessageHandler,
                          FeedUpdateSetHandler feedUpdateHandler, ParameterSyncHandler parameterSyncHandler,
-                         DetailsSyncHandler detailsSyncHandler)
+                         DetailsSyncHandler detailsSyncHandler, std::unique_ptr<CommandExecutor> commandExecutor)
 : m_protocol{protocol}
 , m_persistence{persistence}
 , m_connectivityService{connectivityService}
@@ -53,58 +54,135 @@ DataService::DataService(DataProtocol& protocol, Persistence& persistence, Conne
 , m_feedUpdateHandler{std::move(feedUpdateHandler)}
 , m_parameterSyncHandler{std::move(parameterSyncHandler)}
 , m_detailsSyncHandler{std::move(detailsSyncHandler)}
+, m_keys(PERSISTENCE_KEY_DELIMITER)
+, m_commandBuffer(commandExecutor != nullptr ? std::move(commandExecutor)
+                                             : std::unique_ptr<CommandExecutor>{new CommandQueue})
 , m_iterator(0)
+, m_handle(std::make_shared<Handle>())
+, m_batchReadings(false)
+, m_batchPayloadSize(DEFAULT_BATCH_PAYLOAD_SIZE)
 {
+    m_handle->service = this;
+}
+
+DataService::~DataService()
+{
+    // The requests still waiting for a response can no longer reach the service
+    std::lock_guard<std::mutex> lock{m_handle->mutex};
+    m_handle->service = nullptr;
 }
 
 void DataService::addReading(const std::string& deviceKey, const std::string& reference, const std::string& value,
                              std::uint64_t rtc)
 {
-    m_persistence.putReading(makePersistenceKey(deviceKey, reference), Reading{reference, value, rtc});
+    const auto& key = m_keys.intern(deviceKey, reference);
+    if (!m_reporting.shouldReport(key, value, rtc))
+        return;
+    storeReading(key, Reading{reference, value, rtc});
 }
 
 void DataService::addReading(const std::string& deviceKey, const std::string& reference,
                              const std::vector<std::string>& value, std::uint64_t rtc)
 {
-    m_persistence.putReading(makePersistenceKey(deviceKey, reference), Reading{reference, value, rtc});
+    const auto& key = m_keys.intern(deviceKey, reference);
+    if (!m_reporting.shouldReport(key, value, rtc))
+        return;
+    storeReading(key, Reading{reference, value, rtc});
+}
+
+void DataService::addReading(const std::string& deviceKey, const std::string& reference, const ReadingValue& value,
+                             std::uint64_t rtc)
+{
+    const auto& key = m_keys.intern(deviceKey, reference);
+    if (!m_reporting.shouldReport(key, value, rtc))
+        return;
+    storeReading(key, Reading{reference, value.toString(), rtc});
 }
 
 void DataService::addReading(const std::string& deviceKey, const Reading& reading)
 {
-    m_persistence.putReading(makePersistenceKey(deviceKey, reading.getReference()), reading);
+    const auto& key = m_keys.intern(deviceKey, reading.getReference());
+    if (!m_reporting.shouldReport(key, reading.getStringValues(), reading.getTimestamp()))
+        return;
+    storeReading(key, reading);
 }
 
 void DataService::addReadings(const std::string& deviceKey, const std::vector<Reading>& readings)
 {
     for (const auto& reading : readings)
-        m_persistence.putReading(makePersistenceKey(deviceKey, reading.getReference()), reading);
+        addReading(deviceKey, reading);
+}
+
+void DataService::addReadings(const std::string& deviceKey, const ReadingBatch& batch)
+{
+    const auto& key = m_keys.intern(deviceKey, batch.getReference());
+    const auto& values = batch.getValues();
+    const auto& timestamps = batch.getTimestamps();
+    for (auto i = std::size_t{0}; i < values.size() && i < timestamps.size(); ++i)
+    {
+        if (!m_reporting.shouldReport(key, values[i], timestamps[i]))
+            continue;
+        storeReading(key, Reading{key.reference, values[i].toString(), timestamps[i]});
+    }
 }
 
 void DataService::addAttribute(const std::string& deviceKey, const Attribute& attribute)
 {
-    m_persistence.putAttribute(makePersistenceKey(deviceKey, attribute.getName()),
-                               std::make_shared<Attribute>(attribute));
+    const auto& key = m_keys.intern(deviceKey, attribute.getName());
+    {
+        // A value that is the same as the last one the platform received is not sent again
+        std::lock_guard<std::mutex> lock{m_publishedMutex};
+        const auto it = m_publishedAttributes.find(key.id);
+        if (it != m_publishedAttributes.cend() && it->second.first == attribute.getDataType() &&
+            it->second.second == attribute.getValue() && !m_index.contains(DataKind::Attributes, key))
+        {
+            LOG(TRACE) << "Attribute '" << key.persistenceKey << "' is unchanged, it will not be published again.";
+            return;
+        }
+        m_index.add(DataKind::Attributes, key);
+    }
+    m_persistence.putAttribute(key.persistenceKey, std::make_shared<Attribute>(attribute));
 }
 
 void DataService::updateParameter(const std::string& deviceKey, const Parameter& parameter)
 {
-    m_persistence.putParameter(makePersistenceKey(deviceKey, toString(parameter.first)), parameter);
+    const auto& key = m_keys.intern(deviceKey, toString(parameter.first));
+    {
+        // A value that is the same as the last one the platform has is not sent again
+        std::lock_guard<std::mutex> lock{m_publishedMutex};
+        const auto it = m_publishedParameters.find(key.id);
+        if (it != m_publishedParameters.cend() && it->second == parameter.second &&
+            !m_index.contains(DataKind::Parameters, key))
+        {
+            LOG(TRACE) << "Parameter '" << key.persistenceKey << "' is unchanged, it will not be published again.";
+            return;
+        }
+        m_index.add(DataKind::Parameters, key);
+    }
+    m_persistence.putParameter(key.persistenceKey, parameter);
 }
 
-void DataService::registerFeed(const std::string& deviceKey, Feed feed)
+bool DataService::registerFeed(const std::string& deviceKey, Feed feed)
 {
-    registerFeeds(deviceKey, {std::move(feed)});
+    return registerFeeds(deviceKey, {std::move(feed)});
 }
 
-void DataService::registerFeeds(const std::string& deviceKey, std::vector<Feed> feeds)
+bool DataService::registerFeeds(const std::string& deviceKey, std::vector<Feed> feeds)
 {
     LOG(TRACE) << METHOD_INFO;
     auto message =
       std::shared_ptr<Message>{m_protocol.makeOutboundMessage(deviceKey, FeedRegistrationMessage(std::move(feeds)))};
     if (message == nullptr)
+    {
         LOG(ERROR) << "Failed to register feeds -> Failed to parse the outgoing 'FeedRegistrationMessage'.";
-    else if (!m_connectivityService.publish(message))
+        return false;
+    }
+    if (!m_connectivityService.publish(message))
+    {
         LOG(ERROR) << "Failed to register feeds -> Failed to publish the outgoing 'FeedRegistrationMessage'.";
+        return false;
+    }
+    return true;
 }
 
 void DataService::removeFeed(const std::string& deviceKey, std::string reference)
@@ -144,7 +222,8 @@ void DataService::pullParameters(const std::string& deviceKey)
 }
 
 bool DataService::synchronizeParameters(const std::string& deviceKey, const std::vector<ParameterName>& parameters,
-                                        std::function<void(std::vector<Parameter>)> callback)
+                                        std::function<void(std::vector<Parameter>)> callback,
+                                        std::function<void()> timeoutCallback)
 {
     LOG(TRACE) << METHOD_INFO;
 
@@ -157,17 +236,35 @@ bool DataService::synchronizeParameters(const std::string& deviceKey, const std:
         return false;
     }
 
-    // Send the message out, and add the subscription to the map.
-    if (!m_connectivityService.publish(message))
+    // Without a callback nothing waits for the response, so the message is just sent out
+    if (!callback)
     {
-        LOG(ERROR) << "Failed to synchronize parameters - Failed to send the outgoing SynchronizeParameterMessage.";
-        return false;
+        if (!m_connectivityService.publish(message))
+        {
+            LOG(ERROR) << "Failed to synchronize parameters - Failed to send the outgoing SynchronizeParameterMessage.";
+            return false;
+        }
+        return true;
     }
-    if (callback)
+
+    // Add the subscription to the map, and send the message out until the platform responds
+    auto id = std::uint64_t{0};
     {
         std::lock_guard<std::mutex> lockGuard{m_subscriptionMutex};
-        m_parameterSubscriptions.emplace(m_iterator++, ParameterSubscription{parameters, std::move(callback)});
+        id = m_iterator++;
+        m_parameterSubscriptions.emplace(
+          id, ParameterSubscription{parameters, std::move(callback), std::move(timeoutCallback)});
     }
+    const auto handle = m_handle;
+    m_outboundRetryMessageHandler.addMessage(
+      {message, m_protocol.getResponseChannelForMessage(MessageType::SYNCHRONIZE_PARAMETERS, deviceKey),
+       [handle, id](const std::shared_ptr<Message>&) {
+           LOG(ERROR) << "Failed to receive response for 'SynchronizeParametersMessage' - no response from platform.";
+           std::lock_guard<std::mutex> lock{handle->mutex};
+           if (handle->service != nullptr)
+               handle->service->expireParameterSubscription(id);
+       },
+       RETRY_COUNT, RETRY_TIMEOUT});
     return true;
 }
 
@@ -204,29 +301,104 @@ bool DataService::detailsSynchronizationAsync(
 
 void DataService::publishReadings()
 {
-    for (const auto& key : m_persistence.getReadingsKeys())
+    auto budget = PublishBudget{};
+    publishReadings(budget);
+}
+
+void DataService::publishReadings(const std::string& deviceKey)
+{
+    LOG(TRACE) << METHOD_INFO;
+    releaseReorderedReadings();
+
+    // Only the feeds of this device are visited, through the index
+    auto feeds = indexedKeys(DataKind::Readings, deviceKey);
+    if (feeds.empty())
+        return;
+
+    // The feeds in the higher priority classes go first
+    std::stable_sort(feeds.begin(), feeds.end(), [this](const InternedKey* lhs, const InternedKey* rhs) {
+        return getFeedPriority(lhs->reference) < getFeedPriority(rhs->reference);
+    });
+
+    auto budget = PublishBudget{};
+    if (m_batchReadings)
     {
-        publishReadingsForPersistenceKey(key);
+        publishReadingsForDevice(feeds, budget);
+        return;
     }
+    for (const auto feed : feeds)
+        publishReadingsForPersistenceKey(feed->persistenceKey, budget);
 }
 
-void DataService::publishReadings(const std::string& deviceKey)
+bool DataService::publishReadings(PublishBudget& budget)
 {
-    publishReadingsForPersistenceKey(deviceKey);
+    LOG(TRACE) << METHOD_INFO;
+    releaseReorderedReadings();
+
+    const auto keys = m_persistence.getReadingsKeys();
+    seedIndex(DataKind::Readings, keys);
+
+    // Sort the work into the priority classes, a key at a time, or a device at a time when batching
+    auto classes = std::array<std::deque<PublishWork>, PriorityPolicy::CLASS_COUNT>{};
+    if (!m_batchReadings)
+    {
+        for (const auto& key : keys)
+        {
+            const auto feed = m_keys.resolve(key);
+            const auto priority = feed != nullptr ? getFeedPriority(feed->reference) : FeedPriority::Normal;
+            classes[static_cast<std::size_t>(priority)].emplace_back(
+              [this, key](PublishBudget& slice) { return publishReadingsForPersistenceKey(key, slice); });
+        }
+        return publishPriorityClasses(classes, budget);
+    }
+
+    // Group up all the keys by their priority and the device they belong to
+    auto keysByDevice = std::array<std::map<DeviceId, std::vector<const InternedKey*>>, PriorityPolicy::CLASS_COUNT>{};
+    for (const auto& key : keys)
+    {
+        const auto feed = m_keys.resolve(key);
+        if (feed == nullptr)
+        {
+            LOG(ERROR) << "Unable to create message from readings: The device key is empty.";
+            continue;
+        }
+        keysByDevice[static_cast<std::size_t>(getFeedPriority(feed->reference))][feed->deviceId].emplace_back(feed);
+    }
+    for (auto i = std::size_t{0}; i < PriorityPolicy::CLASS_COUNT; ++i)
+        for (const auto& deviceKeys : keysByDevice[i])
+        {
+            const auto feeds = deviceKeys.second;
+            classes[i].emplace_back(
+              [this, feeds](PublishBudget& slice) { return publishReadingsForDevice(feeds, slice); });
+        }
+    return publishPriorityClasses(classes, budget);
 }
 
 void DataService::publishAttributes()
 {
     LOG(TRACE) << METHOD_INFO;
 
+    // Once the index is seeded, only the devices with attributes waiting are visited
+    if (m_index.isSeeded(DataKind::Attributes))
+    {
+        for (const auto device : m_index.getDevices(DataKind::Attributes))
+        {
+            const auto keys = keysOfDevice(DataKind::Attributes, device);
+            if (!keys.empty() && !publishDeviceAttributes(keys.front()->deviceKey, pendingAttributes(keys)))
+                return;
+        }
+        return;
+    }
+
     // Extract all attributes for all devices and group them up by device
     auto attributes = std::map<std::string, std::vector<Attribute>>{};
     for (const auto& attributeFromPersistence : m_persistence.getAttributes())
     {
         // Extract everything about the attribute
-        auto deviceKey = std::string{};
-        auto reference = std::string{};
-        std::tie(deviceKey, reference) = parsePersistenceKey(attributeFromPersistence.first);
+        const auto key = m_keys.resolve(attributeFromPersistence.first);
+        const auto& deviceKey = key != nullptr ? key->deviceKey : std::string{};
+        if (key != nullptr)
+            m_index.add(DataKind::Attributes, *key);
 
         // Check if there is already an array for the device
         auto it = attributes.find(deviceKey);
@@ -234,82 +406,45 @@ void DataService::publishAttributes()
             it = attributes.emplace(deviceKey, std::vector<Attribute>{}).first;
         it->second.emplace_back(*attributeFromPersistence.second);
     }
-    if (attributes.empty())
-        return;
+    m_index.markSeeded(DataKind::Attributes);
 
     // Send a message out for all devices
     for (const auto& deviceAttributes : attributes)
-    {
-        // Make a lambda that will delete all these attributes from persistence
-        const auto& deviceKey = deviceAttributes.first;
-        auto deleteAllAttributes = [&]() {
-            for (const auto& attribute : deviceAttributes.second)
-                m_persistence.removeAttributes(makePersistenceKey(deviceKey, attribute.getName()));
-        };
-
-        // Form the message
-        auto outboundMessage = std::shared_ptr<Message>(
-          m_protocol.makeOutboundMessage(deviceKey, AttributeRegistrationMessage(deviceAttributes.second)));
-        if (!outboundMessage)
-        {
-            LOG(ERROR) << "Unable to create message from attributes";
-            deleteAllAttributes();
+        if (!publishDeviceAttributes(deviceAttributes.first, deviceAttributes.second))
             return;
-        }
-        if (m_connectivityService.publish(outboundMessage))
-            deleteAllAttributes();
-    }
 }
 
 void DataService::publishAttributes(const std::string& deviceKey)
 {
     LOG(TRACE) << METHOD_INFO;
-
-    // Extract all the attributes for this device key
-    auto attributes = std::vector<Attribute>{};
-    for (const auto& attribute : m_persistence.getAttributes())
-    {
-        // Check the device key
-        auto attributeDeviceKey = std::string{};
-        auto reference = std::string{};
-        std::tie(attributeDeviceKey, reference) = parsePersistenceKey(attribute.first);
-        if (attributeDeviceKey == deviceKey)
-            attributes.emplace_back(*attribute.second);
-    }
-    if (attributes.empty())
-        return;
-
-    // Make a lambda that will delete all these attributes from persistence
-    auto deleteAllAttributes = [&]() {
-        for (const auto& attribute : attributes)
-            m_persistence.removeAttributes(makePersistenceKey(deviceKey, attribute.getName()));
-    };
-
-    // Form the message
-    auto message = AttributeRegistrationMessage(attributes);
-    auto outboundMessage = std::shared_ptr<Message>(m_protocol.makeOutboundMessage(deviceKey, message));
-    if (!outboundMessage)
-    {
-        LOG(ERROR) << "Unable to create message from attributes";
-        deleteAllAttributes();
-        return;
-    }
-    if (m_connectivityService.publish(outboundMessage))
-        deleteAllAttributes();
+    publishDeviceAttributes(deviceKey, pendingAttributes(indexedKeys(DataKind::Attributes, deviceKey)));
 }
 
 void DataService::publishParameters()
 {
     LOG(TRACE) << METHOD_INFO;
 
+    // Once the index is seeded, only the devices with parameters waiting are visited
+    if (m_index.isSeeded(DataKind::Parameters))
+    {
+        for (const auto device : m_index.getDevices(DataKind::Parameters))
+        {
+            const auto keys = keysOfDevice(DataKind::Parameters, device);
+            if (!keys.empty() && !publishDeviceParameters(keys.front()->deviceKey, pendingParameters(keys)))
+                return;
+        }
+        return;
+    }
+
     // Extract all attributes for all devices and group them up by device
     auto parameters = std::map<std::string, std::vector<Parameter>>{};
     for (const auto& parameterFromPersistence : m_persistence.getParameters())
     {
         // Extract everything about the parameter
-        auto deviceKey = std::string{};
-        auto reference = std::string{};
-        std::tie(deviceKey, reference) = parsePersistenceKey(parameterFromPersistence.first);
+        const auto key = m_keys.resolve(parameterFromPersistence.first);
+        const auto& deviceKey = key != nullptr ? key->deviceKey : std::string{};
+        if (key != nullptr)
+            m_index.add(DataKind::Parameters, *key);
 
         // Check if there is already an array for the device
         auto it = parameters.find(deviceKey);
@@ -317,68 +452,137 @@ void DataService::publishParameters()
             it = parameters.emplace(deviceKey, std::vector<Parameter>{}).first;
         it->second.emplace_back(parameterFromPersistence.second);
     }
-    if (parameters.empty())
-        return;
+    m_index.markSeeded(DataKind::Parameters);
 
     // Send a message out for all devices
     for (const auto& deviceParameters : parameters)
-    {
-        // Make a lambda that will delete all these parameters from persistence
-        const auto& deviceKey = deviceParameters.first;
-        auto deleteAllParameters = [&]() {
-            for (const auto& parameter : deviceParameters.second)
-                m_persistence.removeParameters(makePersistenceKey(deviceKey, toString(parameter.first)));
-        };
-
-        // Form the message
-        auto message = ParametersUpdateMessage(deviceParameters.second);
-        auto outboundMessage = std::shared_ptr<Message>(m_protocol.makeOutboundMessage(deviceKey, message));
-        if (!outboundMessage)
-        {
-            LOG(ERROR) << "Unable to create message from parameters";
-            deleteAllParameters();
+        if (!publishDeviceParameters(deviceParameters.first, deviceParameters.second))
             return;
-        }
-        if (m_connectivityService.publish(outboundMessage))
-            deleteAllParameters();
-    }
 }
 
 void DataService::publishParameters(const std::string& deviceKey)
 {
     LOG(TRACE) << METHOD_INFO;
+    publishDeviceParameters(deviceKey, pendingParameters(indexedKeys(DataKind::Parameters, deviceKey)));
+}
 
-    // Extract all the attributes for this device key
-    auto parameters = std::vector<Parameter>{};
-    for (const auto& parameter : m_persistence.getParameters())
-    {
-        // Check the device key
-        auto parameterDeviceKey = std::string{};
-        auto reference = std::string{};
-        std::tie(parameterDeviceKey, reference) = parsePersistenceKey(parameter.first);
-        if (parameterDeviceKey == deviceKey)
-            parameters.emplace_back(parameter.second);
-    }
-    if (parameters.empty())
-        return;
+void DataService::setReportingPolicy(const std::string& reference, const ReportingPolicy& policy)
+{
+    m_reporting.setPolicy(reference, policy);
+}
 
-    // Make a lambda that will delete all these parameters from persistence
-    auto deleteAllParameters = [&]() {
-        for (const auto& parameter : parameters)
-            m_persistence.removeParameters(makePersistenceKey(deviceKey, toString(parameter.first)));
-    };
+ReportingPolicy DataService::getReportingPolicy(const std::string& reference) const
+{
+    return m_reporting.getPolicy(reference);
+}
 
-    // Form the message
-    auto message = ParametersUpdateMessage(parameters);
-    auto outboundMessage = std::shared_ptr<Message>(m_protocol.makeOutboundMessage(deviceKey, message));
-    if (!outboundMessage)
+void DataService::setReadingsBatching(bool enabled, std::uint64_t maxPayloadSize)
+{
+    m_batchReadings = enabled;
+    m_batchPayloadSize = maxPayloadSize > 0 ? maxPayloadSize : DEFAULT_BATCH_PAYLOAD_SIZE;
+}
+
+void DataService::setFeedPriority(const std::string& reference, FeedPriority priority)
+{
+    std::lock_guard<std::mutex> lock{m_priorityMutex};
+    if (priority == FeedPriority::Normal)
+        m_feedPriorities.erase(reference);
+    else
+        m_feedPriorities[reference] = priority;
+}
+
+FeedPriority DataService::getFeedPriority(const std::string& reference) const
+{
+    std::lock_guard<std::mutex> lock{m_priorityMutex};
+    const auto it = m_feedPriorities.find(reference);
+    return it != m_feedPriorities.cend() ? it->second : FeedPriority::Normal;
+}
+
+void DataService::setPriorityPolicy(const PriorityPolicy& policy)
+{
+    std::lock_guard<std::mutex> lock{m_priorityMutex};
+    m_priorityPolicy = policy;
+}
+
+PriorityPolicy DataService::getPriorityPolicy() const
+{
+    std::lock_guard<std::mutex> lock{m_priorityMutex};
+    return m_priorityPolicy;
+}
+
+void DataService::setRateLimiter(const RateLimiter& rateLimiter)
+{
+    std::lock_guard<std::mutex> lock{m_rateMutex};
+    m_rateLimiter = rateLimiter;
+}
+
+RateLimiterMetrics DataService::getRateLimiterMetrics() const
+{
+    std::lock_guard<std::mutex> lock{m_rateMutex};
+    return m_rateLimiter.getMetrics();
+}
+
+std::chrono::milliseconds DataService::getRateLimitDelay() const
+{
+    std::lock_guard<std::mutex> lock{m_rateMutex};
+    return m_rateLimiter.getDelay();
+}
+
+void DataService::setInFlightWindow(std::size_t batches)
+{
+    std::lock_guard<std::mutex> lock{m_inFlightMutex};
+    m_inFlight.setCapacity(batches);
+}
+
+bool DataService::isInFlightWindowFull() const
+{
+    std::lock_guard<std::mutex> lock{m_inFlightMutex};
+    return m_inFlight.isFull();
+}
+
+void DataService::notifyDelivered(const std::shared_ptr<Message>& message)
+{
+    auto committed = InFlightWindow::CommittedReadings{};
     {
-        LOG(ERROR) << "Unable to create message from parameters";
-        deleteAllParameters();
-        return;
+        std::lock_guard<std::mutex> lock{m_inFlightMutex};
+        if (!m_inFlight.confirm(message))
+            return;
+
+        // The persistence may have evicted some of the readings since they were published
+        for (const auto& key : m_inFlight.getCommittableKeys())
+            m_inFlight.align(key, m_persistence.getReadings(key, m_inFlight.getInFlight(key)));
+        committed = m_inFlight.commit();
     }
-    if (m_connectivityService.publish(outboundMessage))
-        deleteAllParameters();
+    for (const auto& readings : committed)
+        m_persistence.removeReadings(readings.first, readings.second);
+}
+
+void DataService::requeueInFlight()
+{
+    std::lock_guard<std::mutex> lock{m_inFlightMutex};
+    const auto count = m_inFlight.requeue();
+    if (count > 0)
+        LOG(INFO) << "Requeued " << count << " batches of readings that were not confirmed as delivered.";
+}
+
+void DataService::setReorderLateness(std::chrono::milliseconds lateness)
+{
+    m_reorder.setLateness(lateness);
+}
+
+std::chrono::milliseconds DataService::getReorderLateness() const
+{
+    return m_reorder.getLateness();
+}
+
+void DataService::setCatchUpPolicy(const CatchUpPolicy& policy)
+{
+    m_catchUp.setPolicy(policy);
+}
+
+CatchUpPolicy DataService::getCatchUpPolicy() const
+{
+    return m_catchUp.getPolicy();
 }
 
 const Protocol& DataService::getProtocol()
@@ -416,10 +620,15 @@ void DataService::messageReceived(std::shared_ptr<Message> message)
     {
         auto parameterMessage = m_protocol.parseParameters(message);
         if (parameterMessage == nullptr)
+        {
             LOG(WARN) << "Unable to parse message: " << message->getChannel();
-        else if (checkIfSubscriptionIsWaiting(*parameterMessage))    // It's important to first check this
             return;
-        else if (m_parameterSyncHandler)
+        }
+        m_outboundRetryMessageHandler.messageReceived(message);
+        rememberPlatformParameters(deviceKey, parameterMessage->getParameters());
+        if (checkIfSubscriptionIsWaiting(*parameterMessage))    // It's important to first check this
+            return;
+        if (m_parameterSyncHandler)
             m_parameterSyncHandler(deviceKey, parameterMessage->getParameters());
         return;
     }
@@ -443,6 +652,170 @@ void DataService::messageReceived(std::shared_ptr<Message> message)
     }
 }
 
+void DataService::storeReading(const InternedKey& key, Reading reading)
+{
+    for (const auto& released : m_reorder.push(key.persistenceKey, std::move(reading)))
+    {
+        m_index.add(DataKind::Readings, key);
+        m_persistence.putReading(key.persistenceKey, released);
+    }
+}
+
+void DataService::releaseReorderedReadings()
+{
+    for (const auto& released : m_reorder.release())
+    {
+        const auto key = m_keys.resolve(released.first);
+        if (key != nullptr)
+            m_index.add(DataKind::Readings, *key);
+        for (const auto& reading : released.second)
+            m_persistence.putReading(released.first, reading);
+    }
+}
+
+void DataService::seedIndex(DataKind kind, const std::vector<std::string>& persistenceKeys)
+{
+    if (m_index.isSeeded(kind))
+        return;
+    for (const auto& persistenceKey : persistenceKeys)
+    {
+        const auto key = m_keys.resolve(persistenceKey);
+        if (key != nullptr)
+            m_index.add(kind, *key);
+    }
+    m_index.markSeeded(kind);
+}
+
+std::vector<const InternedKey*> DataService::indexedKeys(DataKind kind, const std::string& deviceKey)
+{
+    // Data that was in the persistence before this service was created is indexed once, on first use
+    if (!m_index.isSeeded(kind))
+    {
+        switch (kind)
+        {
+        case DataKind::Readings:
+            seedIndex(kind, m_persistence.getReadingsKeys());
+            break;
+        case DataKind::Attributes:
+            seedIndex(kind, m_persistence.getAttributeKeys());
+            break;
+        case DataKind::Parameters:
+            seedIndex(kind, m_persistence.getParameterKeys());
+            break;
+        }
+    }
+
+    return keysOfDevice(kind, m_keys.internDevice(deviceKey));
+}
+
+void DataService::rememberPlatformParameters(const std::string& deviceKey, const std::vector<Parameter>& parameters)
+{
+    std::lock_guard<std::mutex> lock{m_publishedMutex};
+    for (const auto& parameter : parameters)
+        m_publishedParameters[m_keys.intern(deviceKey, toString(parameter.first)).id] = parameter.second;
+}
+
+std::vector<const InternedKey*> DataService::keysOfDevice(DataKind kind, DeviceId device)
+{
+    auto keys = std::vector<const InternedKey*>{};
+    for (const auto id : m_index.get(kind, device))
+        keys.emplace_back(m_keys.get(id));
+    return keys;
+}
+
+std::vector<Attribute> DataService::pendingAttributes(const std::vector<const InternedKey*>& keys)
+{
+    auto attributes = std::vector<Attribute>{};
+    for (const auto key : keys)
+    {
+        const auto attribute = m_persistence.getAttributeUnderKey(key->persistenceKey);
+        if (attribute != nullptr)
+            attributes.emplace_back(*attribute);
+        else
+            m_index.remove(DataKind::Attributes, *key);
+    }
+    return attributes;
+}
+
+std::vector<Parameter> DataService::pendingParameters(const std::vector<const InternedKey*>& keys)
+{
+    auto parameters = std::vector<Parameter>{};
+    for (const auto key : keys)
+    {
+        // A parameter that is not stored anymore comes back under a different name
+        const auto parameter = m_persistence.getParameterForKey(key->persistenceKey);
+        if (toString(parameter.first) == key->reference)
+            parameters.emplace_back(parameter);
+        else
+            m_index.remove(DataKind::Parameters, *key);
+    }
+    return parameters;
+}
+
+bool DataService::publishDeviceAttributes(const std::string& deviceKey, const std::vector<Attribute>& attributes)
+{
+    if (attributes.empty())
+        return true;
+
+    // Make a lambda that will delete all these attributes from persistence
+    auto deleteAllAttributes = [&](bool published) {
+        std::lock_guard<std::mutex> lock{m_publishedMutex};
+        for (const auto& attribute : attributes)
+        {
+            const auto& key = m_keys.intern(deviceKey, attribute.getName());
+            if (published)
+                m_publishedAttributes[key.id] = {attribute.getDataType(), attribute.getValue()};
+            m_index.remove(DataKind::Attributes, key);
+            m_persistence.removeAttributes(key.persistenceKey);
+        }
+    };
+
+    // Form the message
+    auto outboundMessage =
+      std::shared_ptr<Message>(m_protocol.makeOutboundMessage(deviceKey, AttributeRegistrationMessage(attributes)));
+    if (!outboundMessage)
+    {
+        LOG(ERROR) << "Unable to create message from attributes";
+        deleteAllAttributes(false);
+        return false;
+    }
+    if (m_connectivityService.publish(outboundMessage))
+        deleteAllAttributes(true);
+    return true;
+}
+
+bool DataService::publishDeviceParameters(const std::string& deviceKey, const std::vector<Parameter>& parameters)
+{
+    if (parameters.empty())
+        return true;
+
+    // Make a lambda that will delete all these parameters from persistence
+    auto deleteAllParameters = [&](bool published) {
+        std::lock_guard<std::mutex> lock{m_publishedMutex};
+        for (const auto& parameter : parameters)
+        {
+            const auto& key = m_keys.intern(deviceKey, toString(parameter.first));
+            if (published)
+                m_publishedParameters[key.id] = parameter.second;
+            m_index.remove(DataKind::Parameters, key);
+            m_persistence.removeParameters(key.persistenceKey);
+        }
+    };
+
+    // Form the message
+    auto outboundMessage =
+      std::shared_ptr<Message>(m_protocol.makeOutboundMessage(deviceKey, ParametersUpdateMessage(parameters)));
+    if (!outboundMessage)
+    {
+        LOG(ERROR) << "Unable to create message from parameters";
+        deleteAllParameters(false);
+        return false;
+    }
+    if (m_connectivityService.publish(outboundMessage))
+        deleteAllParameters(true);
+    return true;
+}
+
 std::string DataService::makePersistenceKey(const std::string& deviceKey, const std::string& reference)
 {
     return deviceKey + PERSISTENCE_KEY_DELIMITER + reference;
@@ -496,8 +869,7 @@ bool DataService::checkIfSubscriptionIsWaiting(const ParametersUpdateMessage& pa
             // Invoke the subscription
             if (callback)
             {
-                m_commandBuffer.pushCommand(
-                  std::make_shared<std::function<void()>>([callback, values]() { callback(values); }));
+                m_commandBuffer->pushCommand([callback, values]() { callback(values); });
                 return true;
             }
             return false;
@@ -506,6 +878,23 @@ bool DataService::checkIfSubscriptionIsWaiting(const ParametersUpdateMessage& pa
     return false;
 }
 
+void DataService::expireParameterSubscription(std::uint64_t id)
+{
+    LOG(TRACE) << METHOD_INFO;
+
+    auto timeoutCallback = std::function<void()>{};
+    {
+        std::lock_guard<std::mutex> lockGuard{m_subscriptionMutex};
+        const auto subscription = m_parameterSubscriptions.find(id);
+        if (subscription == m_parameterSubscriptions.end())
+            return;
+        timeoutCallback = std::move(subscription->second.timeoutCallback);
+        m_parameterSubscriptions.erase(subscription);
+    }
+    if (timeoutCallback)
+        m_commandBuffer->pushCommand(std::move(timeoutCallback));
+}
+
 bool DataService::checkIfCallbackIsWaiting(const DetailsSynchronizationResponseMessage& synchronizationResponseMessage)
 {
     LOG(TRACE) << METHOD_INFO;
@@ -515,10 +904,9 @@ bool DataService::checkIfCallbackIsWaiting(const DetailsSynchronizationResponseM
         if (!m_detailsCallbacks.empty())
         {
             const auto callback = m_detailsCallbacks.front();
-            m_commandBuffer.pushCommand(
-              std::make_shared<std::function<void()>>([callback, synchronizationResponseMessage] {
-                  callback(synchronizationResponseMessage.getFeeds(), synchronizationResponseMessage.getAttributes());
-              }));
+            m_commandBuffer->pushCommand([callback, synchronizationResponseMessage] {
+                callback(synchronizationResponseMessage.getFeeds(), synchronizationResponseMessage.getAttributes());
+            });
             m_detailsCallbacks.pop();
             return true;
         }
@@ -526,40 +914,281 @@ bool DataService::checkIfCallbackIsWaiting(const DetailsSynchronizationResponseM
     return false;
 }
 
+bool DataService::publishPriorityClasses(std::array<std::deque<PublishWork>, PriorityPolicy::CLASS_COUNT>& classes,
+                                         PublishBudget& budget)
+{
+    // Work that has nothing left is dropped, and the class tells whether it still has work waiting
+    const auto publishClass = [&](std::deque<PublishWork>& work) {
+        while (!work.empty())
+        {
+            if (mustYield(budget) || work.front()(budget))
+                return true;
+            work.pop_front();
+        }
+        return false;
+    };
+
+    const auto policy = getPriorityPolicy();
+    if (policy.getMode() == PriorityMode::Strict)
+    {
+        for (auto& work : classes)
+            if (publishClass(work))
+                return true;
+        return false;
+    }
+
+    // Classes take turns, and a turn ends once the class has sent its weight in messages
+    auto pending = true;
+    while (pending)
+    {
+        pending = false;
+        for (auto i = std::size_t{0}; i < classes.size(); ++i)
+        {
+            if (classes[i].empty())
+                continue;
+            if (mustYield(budget))
+                return true;
+
+            const auto limit = budget.getMessageLimit();
+            const auto turn = budget.getSpentMessages() + policy.getWeight(static_cast<FeedPriority>(i));
+            budget.setMessageLimit(limit > 0 ? std::min(limit, turn) : turn);
+            publishClass(classes[i]);
+            budget.setMessageLimit(limit);
+            pending = pending || !classes[i].empty();
+        }
+    }
+    return false;
+}
+
 void DataService::publishReadingsForPersistenceKey(const std::string& persistenceKey)
+{
+    auto budget = PublishBudget{};
+    publishReadingsForPersistenceKey(persistenceKey, budget);
+}
+
+bool DataService::publishReadingsForPersistenceKey(const std::string& persistenceKey, PublishBudget& budget)
 {
     LOG(TRACE) << METHOD_INFO;
 
-    // Read all information from persistence
-    auto readings = std::vector<Reading>{};
-    for (const auto& readingFromPersistence : m_persistence.getReadings(persistenceKey, PUBLISH_BATCH_ITEMS_COUNT))
-        readings.emplace_back(*readingFromPersistence);
-    if (readings.empty())
-        return;
-    auto deviceKey = std::string{};
-    auto reference = std::string{};
-    std::tie(deviceKey, reference) = parsePersistenceKey(persistenceKey);
+    const auto key = m_keys.resolve(persistenceKey);
 
-    // Check the device key and the reference
-    if (deviceKey.empty())
+    // Drain the key batch by batch, until there is nothing left or the budget or the rate runs out
+    while (!mustYield(budget))
     {
-        LOG(ERROR) << "Unable to create message from readings: The device key is empty.";
-        return;
+        // Read all information from persistence, folding the old readings if catching up
+        auto readingsFromPersistence = std::vector<std::shared_ptr<Reading>>{};
+        auto foldedReadings = std::vector<FoldedReading>{};
+        fetchFoldedReadings(persistenceKey, readingsFromPersistence, foldedReadings);
+        if (readingsFromPersistence.empty())
+        {
+            if (key != nullptr && !hasInFlight(persistenceKey))
+                m_index.remove(DataKind::Readings, *key);
+            return false;
+        }
+        auto readings = std::vector<Reading>{};
+        auto taken = std::uint64_t{0};
+        for (const auto& folded : foldedReadings)
+        {
+            if (readings.size() == PUBLISH_BATCH_ITEMS_COUNT)
+                break;
+            readings.emplace_back(folded.reading);
+            taken += folded.count;
+        }
+
+        // Check the device key and the reference
+        if (key == nullptr)
+        {
+            LOG(ERROR) << "Unable to create message from readings: The device key is empty.";
+            return false;
+        }
+        // Create the message, with the readings in the order of their timestamps if the reorder buffer is used
+        if (m_reorder.isEnabled())
+            ReorderBuffer::order(readings);
+        const auto outboundMessage =
+          std::shared_ptr<Message>{m_protocol.makeOutboundMessage(key->deviceKey, FeedValuesMessage{readings})};
+        if (!outboundMessage)
+        {
+            LOG(ERROR) << "Unable to create message from readings: " << persistenceKey;
+            commitReadings(nullptr, {{persistenceKey, InFlightWindow::take(readingsFromPersistence, taken)}});
+            budget.fail();
+            return false;
+        }
+        if (!m_connectivityService.publish(outboundMessage))
+        {
+            budget.fail();
+            return false;
+        }
+        commitReadings(outboundMessage, {{persistenceKey, InFlightWindow::take(readingsFromPersistence, taken)}});
+        consume(budget, outboundMessage->getContent().size());
     }
-    // Create the message
-    const auto outboundMessage =
-      std::shared_ptr<Message>{m_protocol.makeOutboundMessage(deviceKey, FeedValuesMessage{readings})};
-    if (!outboundMessage)
+    return true;
+}
+
+bool DataService::publishReadingsForDevice(std::vector<const InternedKey*> feeds, PublishBudget& budget)
+{
+    LOG(TRACE) << METHOD_INFO;
+    if (feeds.empty())
+        return false;
+    const auto& deviceKey = feeds.front()->deviceKey;
+
+    while (!feeds.empty())
     {
-        LOG(ERROR) << "Unable to create message from readings: " << persistenceKey;
-        m_persistence.removeReadings(persistenceKey, PUBLISH_BATCH_ITEMS_COUNT);
-        return;
+        if (mustYield(budget))
+            return true;
+
+        // Fill up the message with readings of all the feeds, until the payload budget is reached
+        auto readings = std::vector<Reading>{};
+        auto takenReadings = InFlightWindow::TakenReadings{};
+        auto exhaustedFeeds = std::vector<const InternedKey*>{};
+        auto payloadSize = std::uint64_t{0};
+        auto budgetReached = false;
+        for (const auto feed : feeds)
+        {
+            auto readingsFromPersistence = std::vector<std::shared_ptr<Reading>>{};
+            auto foldedReadings = std::vector<FoldedReading>{};
+            const auto exhausted = fetchFoldedReadings(feed->persistenceKey, readingsFromPersistence, foldedReadings);
+            auto taken = std::uint64_t{0};
+            for (const auto& folded : foldedReadings)
+            {
+                const auto readingSize = estimateReadingSize(folded.reading);
+                if (!readings.empty() && payloadSize + readingSize > m_batchPayloadSize)
+                {
+                    budgetReached = true;
+                    break;
+                }
+                payloadSize += readingSize;
+                readings.emplace_back(folded.reading);
+                taken += folded.count;
+            }
+            if (taken > 0)
+                takenReadings.emplace_back(feed->persistenceKey,
+                                           InFlightWindow::take(readingsFromPersistence, taken));
+            if (taken == readingsFromPersistence.size() && exhausted)
+                exhaustedFeeds.emplace_back(feed);
+            if (budgetReached)
+                break;
+        }
+        if (readings.empty())
+        {
+            for (const auto feed : feeds)
+                if (!hasInFlight(feed->persistenceKey))
+                    m_index.remove(DataKind::Readings, *feed);
+            return false;
+        }
+
+        // Create the message, with the readings in the order of their timestamps if the reorder buffer is used
+        if (m_reorder.isEnabled())
+            ReorderBuffer::order(readings);
+        const auto outboundMessage =
+          std::shared_ptr<Message>{m_protocol.makeOutboundMessage(deviceKey, FeedValuesMessage{readings})};
+        if (!outboundMessage)
+        {
+            LOG(ERROR) << "Unable to create message from readings for device: " << deviceKey;
+            commitReadings(nullptr, takenReadings);
+            budget.fail();
+            return false;
+        }
+        if (!m_connectivityService.publish(outboundMessage))
+        {
+            budget.fail();
+            return false;
+        }
+        commitReadings(outboundMessage, takenReadings);
+        consume(budget, outboundMessage->getContent().size());
+
+        // Remove the feeds that have no more readings waiting
+        for (const auto feed : exhaustedFeeds)
+        {
+            if (!hasInFlight(feed->persistenceKey))
+                m_index.remove(DataKind::Readings, *feed);
+            feeds.erase(std::remove(feeds.begin(), feeds.end(), feed), feeds.end());
+        }
     }
-    if (m_connectivityService.publish(outboundMessage))
+    return false;
+}
+
+std::vector<std::shared_ptr<Reading>> DataService::fetchReadings(const std::string& persistenceKey,
+                                                                 std::uint64_t count)
+{
+    // The readings in flight are at the front, as they were the oldest when they were published
+    std::lock_guard<std::mutex> lock{m_inFlightMutex};
+    const auto inFlight = m_inFlight.getInFlight(persistenceKey);
+    auto readings = m_persistence.getReadings(persistenceKey, count + inFlight);
+    if (inFlight == 0)
+        return readings;
+
+    // Skip the ones still in flight, as the persistence may have evicted some of them since they were published
+    const auto skipped = m_inFlight.align(persistenceKey, readings);
+    readings.erase(readings.begin(), readings.begin() + static_cast<std::ptrdiff_t>(skipped));
+    return readings;
+}
+
+void DataService::commitReadings(std::shared_ptr<Message> message, const InFlightWindow::TakenReadings& taken)
+{
+    auto committed = InFlightWindow::CommittedReadings{};
     {
-        m_persistence.removeReadings(persistenceKey, PUBLISH_BATCH_ITEMS_COUNT);
-        publishReadingsForPersistenceKey(persistenceKey);
+        std::lock_guard<std::mutex> lock{m_inFlightMutex};
+        if (m_inFlight.isEnabled())
+            committed = m_inFlight.add(std::move(message), taken);
+        else
+            for (const auto& readings : taken)
+                committed.emplace_back(readings.first, readings.second.size());
     }
+    for (const auto& readings : committed)
+        m_persistence.removeReadings(readings.first, readings.second);
+}
+
+bool DataService::hasInFlight(const std::string& persistenceKey) const
+{
+    std::lock_guard<std::mutex> lock{m_inFlightMutex};
+    return m_inFlight.getInFlight(persistenceKey) > 0;
+}
+
+bool DataService::mustYield(const PublishBudget& budget)
+{
+    if (budget.isExhausted() || isInFlightWindowFull())
+        return true;
+    std::lock_guard<std::mutex> lock{m_rateMutex};
+    return !m_rateLimiter.isAvailable();
+}
+
+void DataService::consume(PublishBudget& budget, std::uint64_t bytes)
+{
+    budget.consume(bytes);
+    std::lock_guard<std::mutex> lock{m_rateMutex};
+    m_rateLimiter.consume(bytes);
+}
+
+bool DataService::fetchFoldedReadings(const std::string& persistenceKey,
+                                      std::vector<std::shared_ptr<Reading>>& readings,
+                                      std::vector<FoldedReading>& folded)
+{
+    // Start with a message worth of readings, and read further only while the last one read would be folded with the
+    // readings after it, so its window is not cut short by the batch
+    auto count = std::uint64_t{PUBLISH_BATCH_ITEMS_COUNT};
+    while (true)
+    {
+        readings = fetchReadings(persistenceKey, count);
+        folded = m_catchUp.fold(readings);
+        const auto exhausted = readings.size() < count;
+        if (exhausted || count >= CATCH_UP_BATCH_ITEMS_COUNT || folded.size() > PUBLISH_BATCH_ITEMS_COUNT ||
+            !m_catchUp.isFoldable(*readings.back()))
+            return exhausted;
+
+        // Guess the count that folds into more than a message worth of readings from the ones read so far
+        const auto guess = count * (PUBLISH_BATCH_ITEMS_COUNT + 1) / folded.size();
+        count = std::min<std::uint64_t>(std::max(guess, count * 2), CATCH_UP_BATCH_ITEMS_COUNT);
+    }
+}
+
+std::uint64_t DataService::estimateReadingSize(const Reading& reading)
+{
+    // A reading is serialized as `{"<reference>":<value(s)>,"timestamp":<rtc>}`, so the overhead covers the
+    // punctuation, the timestamp and the quotes around string values.
+    auto size = static_cast<std::uint64_t>(reading.getReference().size()) + READING_PAYLOAD_OVERHEAD;
+    for (const auto& value : reading.getStringValues())
+        size += value.size() + 1;
+    return size;
 }
 }    // namespace connect
 }    // namespace wolkabout
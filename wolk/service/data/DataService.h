@@ -22,12 +22,29 @@
 #include "core/model/Attribute.h"
 #include "core/model/Feed.h"
 #include "core/model/Reading.h"
-#include "core/utilities/CommandBuffer.h"
+#include "wolk/service/data/CatchUpAggregator.h"
+#include "wolk/service/data/DeviceIndex.h"
+#include "wolk/service/data/InFlightWindow.h"
+#include "wolk/service/data/KeyInterner.h"
+#include "wolk/service/data/PriorityPolicy.h"
+#include "wolk/service/data/PublishBudget.h"
+#include "wolk/service/data/RateLimiter.h"
+#include "wolk/service/data/ReadingBatch.h"
+#include "wolk/service/data/ReadingValue.h"
+#include "wolk/service/data/ReorderBuffer.h"
+#include "wolk/service/data/ReportingFilter.h"
+#include "wolk/service/data/ReportingPolicy.h"
+#include "wolk/utilities/CommandExecutor.h"
 
+#include <array>
+#include <deque>
 #include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <queue>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace wolkabout
@@ -51,29 +68,40 @@ class DataService : public MessageListener
 public:
     DataService(DataProtocol& protocol, Persistence& persistence, ConnectivityService& connectivityService,
                 OutboundRetryMessageHandler& outboundRetryMessageHandler, FeedUpdateSetHandler feedUpdateHandler,
-                ParameterSyncHandler parameterSyncHandler, DetailsSyncHandler detailsSyncHandler);
+                ParameterSyncHandler parameterSyncHandler, DetailsSyncHandler detailsSyncHandler,
+                std::unique_ptr<CommandExecutor> commandExecutor = nullptr);
+
+    ~DataService() override;
 
     virtual void addReading(const std::string& deviceKey, const std::string& reference, const std::string& value,
                             std::uint64_t rtc);
     virtual void addReading(const std::string& deviceKey, const std::string& reference,
                             const std::vector<std::string>& value, std::uint64_t rtc);
+    // The value is formatted only once it is handed over to the persistence
+    virtual void addReading(const std::string& deviceKey, const std::string& reference, const ReadingValue& value,
+                            std::uint64_t rtc);
 
     virtual void addReading(const std::string& deviceKey, const Reading& reading);
     virtual void addReadings(const std::string& deviceKey, const std::vector<Reading>& readings);
+    virtual void addReadings(const std::string& deviceKey, const ReadingBatch& batch);
 
     virtual void addAttribute(const std::string& deviceKey, const Attribute& attribute);
     virtual void updateParameter(const std::string& deviceKey, const Parameter& parameter);
 
-    virtual void registerFeed(const std::string& deviceKey, Feed feed);
-    virtual void registerFeeds(const std::string& deviceKey, std::vector<Feed> feed);
+    // Returns whether the registration was handed over to the connection
+    virtual bool registerFeed(const std::string& deviceKey, Feed feed);
+    virtual bool registerFeeds(const std::string& deviceKey, std::vector<Feed> feed);
 
     virtual void removeFeed(const std::string& deviceKey, std::string reference);
     virtual void removeFeeds(const std::string& deviceKey, std::vector<std::string> feeds);
 
     virtual void pullFeedValues(const std::string& deviceKey);
     virtual void pullParameters(const std::string& deviceKey);
+    // With a callback, the request is retried until the platform responds, and the timeout callback is invoked if it
+    // never does
     virtual bool synchronizeParameters(const std::string& deviceKey, const std::vector<ParameterName>& parameters,
-                                       std::function<void(std::vector<Parameter>)> callback);
+                                       std::function<void(std::vector<Parameter>)> callback,
+                                       std::function<void()> timeoutCallback = nullptr);
 
     virtual bool detailsSynchronizationAsync(
       const std::string& deviceKey, std::function<void(std::vector<std::string>, std::vector<std::string>)> callback);
@@ -81,12 +109,58 @@ public:
     virtual void publishReadings();
     virtual void publishReadings(const std::string& deviceKey);
 
+    // Publishes readings until the budget is exhausted. Returns whether there are still readings waiting, and a message
+    // that could not be sent fails the budget.
+    virtual bool publishReadings(PublishBudget& budget);
+
     virtual void publishAttributes();
     virtual void publishAttributes(const std::string& deviceKey);
 
     virtual void publishParameters();
     virtual void publishParameters(const std::string& deviceKey);
 
+    // Readings of all feeds with the reference are checked against the policy before they are stored, and the ones
+    // not worth reporting are dropped. Setting `ReportingMode::Always` removes the policy.
+    virtual void setReportingPolicy(const std::string& reference, const ReportingPolicy& policy);
+    ReportingPolicy getReportingPolicy(const std::string& reference) const;
+
+    // When batching is enabled, pending readings of a device are grouped across all of its feeds, and each outgoing
+    // message is filled up until it reaches the given payload size (in bytes).
+    void setReadingsBatching(bool enabled, std::uint64_t maxPayloadSize = DEFAULT_BATCH_PAYLOAD_SIZE);
+
+    // Readings of all feeds with the reference are published in the priority class. Classes are drained in the order
+    // the priority policy sets, and feeds without a priority are in the `FeedPriority::Normal` class.
+    virtual void setFeedPriority(const std::string& reference, FeedPriority priority);
+    FeedPriority getFeedPriority(const std::string& reference) const;
+
+    void setPriorityPolicy(const PriorityPolicy& policy);
+    PriorityPolicy getPriorityPolicy() const;
+
+    // Readings are published no faster than the rate limiter allows. Once it runs dry, publishing the readings yields
+    // as if the budget was exhausted, and the rest can be published after the delay.
+    void setRateLimiter(const RateLimiter& rateLimiter);
+    RateLimiterMetrics getRateLimiterMetrics() const;
+    std::chrono::milliseconds getRateLimitDelay() const;
+
+    // With an in-flight window, published readings stay in the persistence until their delivery is confirmed, and up
+    // to the set count of batches can wait for a confirmation at once. Batches that are not confirmed when the
+    // connection is lost are requeued, and published again. A window of zero removes readings once they are published.
+    void setInFlightWindow(std::size_t batches);
+    bool isInFlightWindowFull() const;
+    virtual void notifyDelivered(const std::shared_ptr<Message>& message);
+    virtual void requeueInFlight();
+
+    // Readings are held back for the lateness window before they are stored, so the ones that arrive out of order are
+    // stored in the order of their timestamps, and repeated readings are collapsed. A window of zero stores and
+    // publishes them as they arrive.
+    void setReorderLateness(std::chrono::milliseconds lateness);
+    std::chrono::milliseconds getReorderLateness() const;
+
+    // When catching up is enabled, stored readings older than the maximum age of the policy are folded into one
+    // reading per window of every feed before they are published.
+    void setCatchUpPolicy(const CatchUpPolicy& policy);
+    CatchUpPolicy getCatchUpPolicy() const;
+
     const Protocol& getProtocol() override;
 
     void messageReceived(std::shared_ptr<Message> message) override;
@@ -98,10 +172,60 @@ private:
 
     bool checkIfSubscriptionIsWaiting(const ParametersUpdateMessage& parameterMessage);
 
+    void expireParameterSubscription(std::uint64_t id);
+
     bool checkIfCallbackIsWaiting(const DetailsSynchronizationResponseMessage& synchronizationResponseMessage);
 
+    // Publishes a part of the readings within the budget, and returns whether it still has readings waiting
+    using PublishWork = std::function<bool(PublishBudget&)>;
+
+    // Returns whether there is still work waiting in any of the classes
+    bool publishPriorityClasses(std::array<std::deque<PublishWork>, PriorityPolicy::CLASS_COUNT>& classes,
+                                PublishBudget& budget);
+
+    // Reads the readings of the key that are not in flight, and removes the published ones once they can be removed
+    std::vector<std::shared_ptr<Reading>> fetchReadings(const std::string& persistenceKey, std::uint64_t count);
+    void commitReadings(std::shared_ptr<Message> message, const InFlightWindow::TakenReadings& taken);
+    bool hasInFlight(const std::string& persistenceKey) const;
+
+    // Returns whether publishing readings should stop, because of the budget, the rate limiter or the in-flight window
+    bool mustYield(const PublishBudget& budget);
+    void consume(PublishBudget& budget, std::uint64_t bytes);
+
     void publishReadingsForPersistenceKey(const std::string& persistenceKey);
 
+    bool publishReadingsForPersistenceKey(const std::string& persistenceKey, PublishBudget& budget);
+
+    bool publishReadingsForDevice(std::vector<const InternedKey*> feeds, PublishBudget& budget);
+
+    // Reads the readings of a feed for a single message, folded if catching up. Returns whether the feed has no more
+    // readings than the ones read.
+    bool fetchFoldedReadings(const std::string& persistenceKey, std::vector<std::shared_ptr<Reading>>& readings,
+                             std::vector<FoldedReading>& folded);
+
+    static std::uint64_t estimateReadingSize(const Reading& reading);
+
+    // Stores the reading through the reorder buffer, and stores the readings the buffer lets through
+    void storeReading(const InternedKey& key, Reading reading);
+    void releaseReorderedReadings();
+
+    void seedIndex(DataKind kind, const std::vector<std::string>& persistenceKeys);
+
+    std::vector<const InternedKey*> indexedKeys(DataKind kind, const std::string& deviceKey);
+
+    std::vector<const InternedKey*> keysOfDevice(DataKind kind, DeviceId device);
+
+    // Fetches the values stored under the keys, and drops the keys that have nothing stored from the index
+    std::vector<Attribute> pendingAttributes(const std::vector<const InternedKey*>& keys);
+    std::vector<Parameter> pendingParameters(const std::vector<const InternedKey*>& keys);
+
+    // Return false if the message could not be created, which stops the rest of the devices from being published
+    bool publishDeviceAttributes(const std::string& deviceKey, const std::vector<Attribute>& attributes);
+    bool publishDeviceParameters(const std::string& deviceKey, const std::vector<Parameter>& parameters);
+
+    // Values the platform sent are what it has, so an update back to the previous value is not suppressed
+    void rememberPlatformParameters(const std::string& deviceKey, const std::vector<Parameter>& parameters);
+
     DataProtocol& m_protocol;
     Persistence& m_persistence;
     ConnectivityService& m_connectivityService;
@@ -111,21 +235,57 @@ private:
     ParameterSyncHandler m_parameterSyncHandler;
     DetailsSyncHandler m_detailsSyncHandler;
 
-    CommandBuffer m_commandBuffer;
+    KeyInterner m_keys;
+    DeviceIndex m_index;
+    ReportingFilter m_reporting;
+    CatchUpAggregator m_catchUp;
+    ReorderBuffer m_reorder;
+
+    mutable std::mutex m_priorityMutex;
+    std::unordered_map<std::string, FeedPriority> m_feedPriorities;
+    PriorityPolicy m_priorityPolicy;
+
+    mutable std::mutex m_rateMutex;
+    RateLimiter m_rateLimiter;
+
+    mutable std::mutex m_inFlightMutex;
+    InFlightWindow m_inFlight;
+
+    // The last values the platform is known to have, used to skip updates that change nothing
+    std::mutex m_publishedMutex;
+    std::unordered_map<FeedId, std::pair<DataType, std::string>> m_publishedAttributes;
+    std::unordered_map<FeedId, std::string> m_publishedParameters;
+
+    std::unique_ptr<CommandExecutor> m_commandBuffer;
     struct ParameterSubscription
     {
         std::vector<ParameterName> parameters;
         std::function<void(std::vector<Parameter>)> callback;
+        std::function<void()> timeoutCallback;
     };
     std::uint64_t m_iterator;
     std::mutex m_subscriptionMutex;
     std::map<std::uint64_t, ParameterSubscription> m_parameterSubscriptions;
 
+    // Lets the callbacks left with the retry handler, which may outlive the service, reach it while it exists
+    struct Handle
+    {
+        std::mutex mutex;
+        DataService* service;
+    };
+    std::shared_ptr<Handle> m_handle;
+
     std::mutex m_detailsMutex;
     std::queue<std::function<void(std::vector<std::string>, std::vector<std::string>)>> m_detailsCallbacks;
 
+    bool m_batchReadings;
+    std::uint64_t m_batchPayloadSize;
+
     static const std::string PERSISTENCE_KEY_DELIMITER;
     static const constexpr unsigned int PUBLISH_BATCH_ITEMS_COUNT = 50;
+    static const constexpr unsigned int CATCH_UP_BATCH_ITEMS_COUNT = 1000;
+    static const constexpr std::uint64_t DEFAULT_BATCH_PAYLOAD_SIZE = 64 * 1024;
+    static const constexpr std::uint64_t READING_PAYLOAD_OVERHEAD = 32;
 };
 }    // namespace connect
 }    // namespace wolkabout
@@ -0,0 +1,90 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/service/data/DeviceIndex.h"
+
+namespace wolkabout
+{
+namespace connect
+{
+void DeviceIndex::add(DataKind kind, const InternedKey& key)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_devices[key.deviceId][static_cast<std::size_t>(kind)].emplace(key.id);
+}
+
+void DeviceIndex::remove(DataKind kind, const InternedKey& key)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    const auto it = m_devices.find(key.deviceId);
+    if (it == m_devices.end())
+        return;
+    it->second[static_cast<std::size_t>(kind)].erase(key.id);
+}
+
+std::vector<FeedId> DeviceIndex::get(DataKind kind, DeviceId device) const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    const auto it = m_devices.find(device);
+    if (it == m_devices.cend())
+        return {};
+    const auto& keys = it->second[static_cast<std::size_t>(kind)];
+    return {keys.cbegin(), keys.cend()};
+}
+
+std::size_t DeviceIndex::count(DataKind kind, DeviceId device) const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    const auto it = m_devices.find(device);
+    if (it == m_devices.cend())
+        return 0;
+    return it->second[static_cast<std::size_t>(kind)].size();
+}
+
+bool DeviceIndex::contains(DataKind kind, const InternedKey& key) const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    const auto it = m_devices.find(key.deviceId);
+    if (it == m_devices.cend())
+        return false;
+    const auto& keys = it->second[static_cast<std::size_t>(kind)];
+    return keys.find(key.id) != keys.cend();
+}
+
+std::vector<DeviceId> DeviceIndex::getDevices(DataKind kind) const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    auto devices = std::vector<DeviceId>{};
+    for (const auto& device : m_devices)
+        if (!device.second[static_cast<std::size_t>(kind)].empty())
+            devices.emplace_back(device.first);
+    return devices;
+}
+
+bool DeviceIndex::isSeeded(DataKind kind) const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_seeded[static_cast<std::size_t>(kind)];
+}
+
+void DeviceIndex::markSeeded(DataKind kind)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_seeded[static_cast<std::size_t>(kind)] = true;
+}
+}    // namespace connect
+}    // namespace wolkabout
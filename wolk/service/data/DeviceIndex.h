@@ -0,0 +1,115 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WOLKABOUTCONNECTOR_DEVICEINDEX_H
+#define WOLKABOUTCONNECTOR_DEVICEINDEX_H
+
+#include "wolk/service/data/KeyInterner.h"
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+namespace wolkabout
+{
+namespace connect
+{
+// The kinds of data the `DataService` keeps in persistence.
+enum class DataKind
+{
+    Readings = 0,
+    Attributes,
+    Parameters
+};
+
+/**
+ * This class is a secondary index over the persistence, mapping every device to the keys it has data stored under.
+ * It allows the data of a single device to be found without going over the keys of all other devices.
+ * Every kind of data can be marked as seeded, once the keys that were already in the persistence have been indexed.
+ */
+class DeviceIndex
+{
+public:
+    /**
+     * This method will add a key to the index.
+     *
+     * @param kind The kind of data stored under the key.
+     * @param key The interned key.
+     */
+    void add(DataKind kind, const InternedKey& key);
+
+    /**
+     * This method will remove a key from the index.
+     *
+     * @param kind The kind of data stored under the key.
+     * @param key The interned key.
+     */
+    void remove(DataKind kind, const InternedKey& key);
+
+    /**
+     * This method returns identifiers of all the keys a device has data of some kind stored under.
+     *
+     * @param kind The kind of data.
+     * @param device The identifier of the device.
+     * @return The identifiers of the keys, in the order they were interned.
+     */
+    std::vector<FeedId> get(DataKind kind, DeviceId device) const;
+
+    /**
+     * This method returns the count of keys a device has data of some kind stored under.
+     *
+     * @param kind The kind of data.
+     * @param device The identifier of the device.
+     * @return The count of keys.
+     */
+    std::size_t count(DataKind kind, DeviceId device) const;
+
+    /**
+     * This method checks whether a key is in the index.
+     *
+     * @param kind The kind of data stored under the key.
+     * @param key The interned key.
+     * @return Whether the key is in the index.
+     */
+    bool contains(DataKind kind, const InternedKey& key) const;
+
+    /**
+     * This method returns identifiers of all the devices that have at least one key of some kind in the index.
+     *
+     * @param kind The kind of data.
+     * @return The identifiers of the devices.
+     */
+    std::vector<DeviceId> getDevices(DataKind kind) const;
+
+    bool isSeeded(DataKind kind) const;
+
+    void markSeeded(DataKind kind);
+
+private:
+    static const constexpr std::size_t KIND_COUNT = 3;
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<DeviceId, std::array<std::set<FeedId>, KIND_COUNT>> m_devices;
+    std::array<bool, KIND_COUNT> m_seeded{{false, false, false}};
+};
+}    // namespace connect
+}    // namespace wolkabout
+
+#endif    // WOLKABOUTCONNECTOR_DEVICEINDEX_H
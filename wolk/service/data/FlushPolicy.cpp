@@ -0,0 +1,66 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/service/data/FlushPolicy.h"
+
+#include <algorithm>
+
+namespace wolkabout
+{
+namespace connect
+{
+const std::chrono::milliseconds FlushPolicy::MIN_CHECK_PERIOD{10};
+const std::chrono::milliseconds FlushPolicy::MAX_CHECK_PERIOD{1000};
+
+FlushPolicy::FlushPolicy(std::uint64_t bufferedCount, std::chrono::milliseconds maxAge,
+                         std::chrono::milliseconds minInterval)
+: m_bufferedCount(bufferedCount), m_maxAge(maxAge), m_minInterval(minInterval)
+{
+}
+
+bool FlushPolicy::isEnabled() const
+{
+    return m_bufferedCount > 0 || m_maxAge.count() > 0 || m_minInterval.count() > 0;
+}
+
+std::uint64_t FlushPolicy::getBufferedCount() const
+{
+    return m_bufferedCount;
+}
+
+std::chrono::milliseconds FlushPolicy::getMaxAge() const
+{
+    return m_maxAge;
+}
+
+std::chrono::milliseconds FlushPolicy::getMinInterval() const
+{
+    return m_minInterval;
+}
+
+std::chrono::milliseconds FlushPolicy::getCheckPeriod() const
+{
+    // Check twice as often as the shortest time based trigger, to keep the lateness of a flush bounded
+    auto period = MAX_CHECK_PERIOD;
+    if (m_maxAge.count() > 0)
+        period = std::min(period, m_maxAge / 2);
+    if (m_minInterval.count() > 0)
+        period = std::min(period, m_minInterval / 2);
+    return std::max(period, MIN_CHECK_PERIOD);
+}
+}    // namespace connect
+}    // namespace wolkabout
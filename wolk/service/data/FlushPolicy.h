@@ -0,0 +1,79 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WOLKABOUTCONNECTOR_FLUSHPOLICY_H
+#define WOLKABOUTCONNECTOR_FLUSHPOLICY_H
+
+#include <chrono>
+#include <cstdint>
+
+namespace wolkabout
+{
+namespace connect
+{
+/**
+ * This class describes when the buffered data should be published automatically.
+ * A flush is triggered once enough items are buffered, once the oldest buffered item gets old enough, or once the
+ * interval passes while there is something buffered. The interval is also the minimum time between two flushes.
+ * A value set to zero means that the trigger is not used.
+ */
+class FlushPolicy
+{
+public:
+    /**
+     * Default parameter constructor.
+     *
+     * @param bufferedCount The count of buffered items that triggers a flush.
+     * @param maxAge The age of the oldest buffered item that triggers a flush.
+     * @param minInterval The interval at which buffered items are flushed, and the minimum time between two flushes.
+     */
+    explicit FlushPolicy(std::uint64_t bufferedCount = 0,
+                         std::chrono::milliseconds maxAge = std::chrono::milliseconds{0},
+                         std::chrono::milliseconds minInterval = std::chrono::milliseconds{0});
+
+    /**
+     * This method checks whether any of the triggers is set.
+     *
+     * @return Whether the policy will ever trigger a flush.
+     */
+    bool isEnabled() const;
+
+    std::uint64_t getBufferedCount() const;
+
+    std::chrono::milliseconds getMaxAge() const;
+
+    std::chrono::milliseconds getMinInterval() const;
+
+    /**
+     * This method returns how often the triggers need to be checked.
+     *
+     * @return The period for checking the time based triggers.
+     */
+    std::chrono::milliseconds getCheckPeriod() const;
+
+private:
+    std::uint64_t m_bufferedCount;
+    std::chrono::milliseconds m_maxAge;
+    std::chrono::milliseconds m_minInterval;
+
+    static const std::chrono::milliseconds MIN_CHECK_PERIOD;
+    static const std::chrono::milliseconds MAX_CHECK_PERIOD;
+};
+}    // namespace connect
+}    // namespace wolkabout
+
+#endif    // WOLKABOUTCONNECTOR_FLUSHPOLICY_H
@@ -0,0 +1,138 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/service/data/FlushScheduler.h"
+
+#include "core/utilities/Logger.h"
+#include "wolk/utilities/ThreadTimer.h"
+
+#include <utility>
+
+namespace wolkabout
+{
+namespace connect
+{
+FlushScheduler::FlushScheduler(FlushPolicy policy, std::function<void()> flush, std::unique_ptr<CommandTimer> timer)
+: m_policy(std::move(policy))
+, m_flush(std::move(flush))
+, m_running(false)
+, m_flushScheduled(false)
+, m_buffered(0)
+, m_oldest(Clock::now())
+, m_lastFlush(Clock::time_point{})
+, m_timer(timer != nullptr ? std::move(timer) : std::unique_ptr<CommandTimer>{new ThreadTimer})
+{
+}
+
+FlushScheduler::~FlushScheduler()
+{
+    stop();
+}
+
+void FlushScheduler::start()
+{
+    LOG(TRACE) << METHOD_INFO;
+
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        if (m_running)
+            return;
+        m_running = true;
+    }
+    m_timer->run(m_policy.getCheckPeriod(), [this] { check(); });
+}
+
+void FlushScheduler::stop()
+{
+    LOG(TRACE) << METHOD_INFO;
+
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        if (!m_running)
+            return;
+        m_running = false;
+    }
+    m_timer->stop();
+}
+
+void FlushScheduler::notifyBuffered(std::uint64_t count)
+{
+    auto flush = false;
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        const auto now = Clock::now();
+        if (m_buffered == 0)
+            m_oldest = now;
+        m_buffered += count;
+
+        // Only the count trigger is checked here, the time based ones are left for the timer
+        if (m_running && m_policy.getBufferedCount() > 0 && m_buffered >= m_policy.getBufferedCount())
+            flush = evaluate(now);
+    }
+    if (flush)
+        m_flush();
+}
+
+void FlushScheduler::notifyFlushStarted()
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_flushScheduled = false;
+}
+
+const FlushPolicy& FlushScheduler::getPolicy() const
+{
+    return m_policy;
+}
+
+bool FlushScheduler::evaluate(Clock::time_point now)
+{
+    if (m_buffered == 0)
+        return false;
+
+    // Respect the minimum interval between two flushes
+    const auto sinceLastFlush = now - m_lastFlush;
+    const auto& interval = m_policy.getMinInterval();
+    if (interval.count() > 0 && sinceLastFlush < interval)
+        return false;
+
+    const auto countReached = m_policy.getBufferedCount() > 0 && m_buffered >= m_policy.getBufferedCount();
+    const auto ageReached = m_policy.getMaxAge().count() > 0 && now - m_oldest >= m_policy.getMaxAge();
+    const auto intervalReached = interval.count() > 0 && sinceLastFlush >= interval;
+    if (!countReached && !ageReached && !intervalReached)
+        return false;
+
+    // Everything buffered until now will be picked up by the flush, whether it is a new one or an already scheduled one
+    m_buffered = 0;
+    m_lastFlush = now;
+    if (m_flushScheduled)
+        return false;
+    m_flushScheduled = true;
+    return true;
+}
+
+void FlushScheduler::check()
+{
+    auto flush = false;
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        flush = m_running && evaluate(Clock::now());
+    }
+    if (flush)
+        m_flush();
+}
+}    // namespace connect
+}    // namespace wolkabout
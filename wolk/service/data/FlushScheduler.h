@@ -0,0 +1,101 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WOLKABOUTCONNECTOR_FLUSHSCHEDULER_H
+#define WOLKABOUTCONNECTOR_FLUSHSCHEDULER_H
+
+#include "wolk/service/data/FlushPolicy.h"
+#include "wolk/utilities/CommandTimer.h"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace wolkabout
+{
+namespace connect
+{
+/**
+ * This class decides when the buffered data should be flushed, according to a `FlushPolicy`.
+ * Producers notify it about buffered items, and it invokes the flush callback once one of the triggers fires.
+ * While a triggered flush has not yet started, further triggers are coalesced into it.
+ */
+class FlushScheduler
+{
+public:
+    /**
+     * Default parameter constructor.
+     *
+     * @param policy The policy describing the triggers.
+     * @param flush The callback that will schedule a flush. It should not block.
+     * @param timer The timer checking the time based triggers. If none is given, the scheduler uses its own thread.
+     */
+    FlushScheduler(FlushPolicy policy, std::function<void()> flush, std::unique_ptr<CommandTimer> timer = nullptr);
+
+    virtual ~FlushScheduler();
+
+    /**
+     * This method will start checking the time based triggers.
+     */
+    virtual void start();
+
+    /**
+     * This method will stop checking the time based triggers.
+     */
+    virtual void stop();
+
+    /**
+     * This method is used to notify the scheduler that new items have been buffered.
+     *
+     * @param count The count of new items.
+     */
+    virtual void notifyBuffered(std::uint64_t count = 1);
+
+    /**
+     * This method is used to notify the scheduler that the scheduled flush has started executing.
+     * Triggers firing from now on will schedule a new flush.
+     */
+    virtual void notifyFlushStarted();
+
+    const FlushPolicy& getPolicy() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // Checks all the triggers, and if one of them fires, marks the buffer as flushed. Returns whether to flush.
+    bool evaluate(Clock::time_point now);
+
+    void check();
+
+    FlushPolicy m_policy;
+    std::function<void()> m_flush;
+
+    std::mutex m_mutex;
+    bool m_running;
+    bool m_flushScheduled;
+    std::uint64_t m_buffered;
+    Clock::time_point m_oldest;
+    Clock::time_point m_lastFlush;
+
+    std::unique_ptr<CommandTimer> m_timer;
+};
+}    // namespace connect
+}    // namespace wolkabout
+
+#endif    // WOLKABOUTCONNECTOR_FLUSHSCHEDULER_H
@@ -0,0 +1,180 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/service/data/InFlightWindow.h"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace wolkabout
+{
+namespace connect
+{
+InFlightWindow::InFlightWindow(std::size_t capacity) : m_capacity(capacity) {}
+
+void InFlightWindow::setCapacity(std::size_t capacity)
+{
+    m_capacity = capacity;
+}
+
+std::size_t InFlightWindow::getCapacity() const
+{
+    return m_capacity;
+}
+
+bool InFlightWindow::isEnabled() const
+{
+    return m_capacity > 0;
+}
+
+bool InFlightWindow::isFull() const
+{
+    return isEnabled() && m_batches.size() >= m_capacity;
+}
+
+std::size_t InFlightWindow::getSize() const
+{
+    return m_batches.size();
+}
+
+std::vector<std::shared_ptr<Reading>> InFlightWindow::take(const std::vector<std::shared_ptr<Reading>>& readings,
+                                                            std::uint64_t count)
+{
+    const auto taken = static_cast<std::ptrdiff_t>(std::min<std::uint64_t>(count, readings.size()));
+    return {readings.cbegin(), readings.cbegin() + taken};
+}
+
+InFlightWindow::CommittedReadings InFlightWindow::add(std::shared_ptr<Message> message, const TakenReadings& taken)
+{
+    auto counts = CommittedReadings{};
+    for (const auto& readings : taken)
+    {
+        auto& inFlight = m_inFlight[readings.first];
+        inFlight.insert(inFlight.end(), readings.second.cbegin(), readings.second.cend());
+        counts.emplace_back(readings.first, readings.second.size());
+    }
+    const auto confirmed = message == nullptr;
+    m_batches.emplace_back(Batch{std::move(message), std::move(counts), confirmed});
+    return confirmed ? commit() : CommittedReadings{};
+}
+
+std::uint64_t InFlightWindow::getInFlight(const std::string& key) const
+{
+    const auto it = m_inFlight.find(key);
+    return it != m_inFlight.cend() ? it->second.size() : 0;
+}
+
+std::uint64_t InFlightWindow::align(const std::string& key, const std::vector<std::shared_ptr<Reading>>& front)
+{
+    const auto it = m_inFlight.find(key);
+    if (it == m_inFlight.end())
+        return 0;
+    auto& inFlight = it->second;
+
+    // Eviction only takes readings off the front, so the ones left are the newest in flight, at the front of the key.
+    // The persistence returns copies of the readings, so they are recognized by their timestamp and values.
+    const auto matches = [&](std::size_t count) {
+        for (auto i = std::size_t{0}; i < count; ++i)
+        {
+            const auto& reading = *inFlight[inFlight.size() - count + i];
+            if (reading.getTimestamp() != front[i]->getTimestamp() ||
+                reading.getStringValues() != front[i]->getStringValues())
+                return false;
+        }
+        return true;
+    };
+    auto left = std::min(inFlight.size(), front.size());
+    while (left > 0 && !matches(left))
+        --left;
+
+    // Forget the evicted readings, taking them out of the oldest batches first
+    auto evicted = static_cast<std::uint64_t>(inFlight.size() - left);
+    inFlight.erase(inFlight.begin(), inFlight.begin() + static_cast<std::ptrdiff_t>(evicted));
+    for (auto& batch : m_batches)
+    {
+        for (auto& readings : batch.taken)
+        {
+            if (evicted == 0 || readings.first != key)
+                continue;
+            const auto count = std::min(evicted, readings.second);
+            readings.second -= count;
+            evicted -= count;
+        }
+    }
+    if (inFlight.empty())
+        m_inFlight.erase(it);
+    return left;
+}
+
+bool InFlightWindow::confirm(const std::shared_ptr<Message>& message)
+{
+    const auto it = std::find_if(m_batches.begin(), m_batches.end(), [&](const Batch& batch) {
+        return batch.message != nullptr && batch.message == message;
+    });
+    if (it == m_batches.end())
+        return false;
+    it->confirmed = true;
+    return true;
+}
+
+std::vector<std::string> InFlightWindow::getCommittableKeys() const
+{
+    auto keys = std::vector<std::string>{};
+    for (const auto& batch : m_batches)
+    {
+        if (!batch.confirmed)
+            break;
+        for (const auto& readings : batch.taken)
+            if (std::find(keys.cbegin(), keys.cend(), readings.first) == keys.cend())
+                keys.emplace_back(readings.first);
+    }
+    return keys;
+}
+
+InFlightWindow::CommittedReadings InFlightWindow::commit()
+{
+    // Only the confirmed batches at the front can be committed
+    auto committed = CommittedReadings{};
+    while (!m_batches.empty() && m_batches.front().confirmed)
+    {
+        for (const auto& readings : m_batches.front().taken)
+        {
+            if (readings.second == 0)
+                continue;
+            committed.emplace_back(readings);
+            auto& inFlight = m_inFlight[readings.first];
+            inFlight.erase(inFlight.begin(),
+                           inFlight.begin() +
+                             static_cast<std::ptrdiff_t>(std::min<std::uint64_t>(inFlight.size(), readings.second)));
+            if (inFlight.empty())
+                m_inFlight.erase(readings.first);
+        }
+        m_batches.pop_front();
+    }
+    return committed;
+}
+
+std::size_t InFlightWindow::requeue()
+{
+    // The confirmed batches waiting behind an unconfirmed one are sent again too, as the readings stay in order
+    const auto count = m_batches.size();
+    m_batches.clear();
+    m_inFlight.clear();
+    return count;
+}
+}    // namespace connect
+}    // namespace wolkabout
@@ -0,0 +1,152 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WOLKABOUTCONNECTOR_INFLIGHTWINDOW_H
+#define WOLKABOUTCONNECTOR_INFLIGHTWINDOW_H
+
+#include "core/model/Message.h"
+#include "core/model/Reading.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace wolkabout
+{
+namespace connect
+{
+/**
+ * This class keeps track of the batches of readings that were published, but whose delivery was not yet confirmed.
+ * Readings stay in persistence until their batch is confirmed, so they are not lost if the connection drops first,
+ * and the readings in flight are skipped when the next batch is read. Batches are committed in the order they were
+ * published, as persistence removes readings from the front.
+ * The readings in flight are kept, so the window can tell by their timestamps and values which of them are still at
+ * the front of the persistence after it evicted some of them by itself.
+ */
+class InFlightWindow
+{
+public:
+    // The readings taken from each persistence key, in the order they are stored in
+    using TakenReadings = std::vector<std::pair<std::string, std::vector<std::shared_ptr<Reading>>>>;
+
+    // The counts of readings to remove from the front of each persistence key
+    using CommittedReadings = std::vector<std::pair<std::string, std::uint64_t>>;
+
+    /**
+     * Default parameter constructor.
+     *
+     * @param capacity The count of batches that can be in flight at once. Zero disables the window.
+     */
+    explicit InFlightWindow(std::size_t capacity = 0);
+
+    void setCapacity(std::size_t capacity);
+    std::size_t getCapacity() const;
+
+    bool isEnabled() const;
+    bool isFull() const;
+    std::size_t getSize() const;
+
+    /**
+     * This method will take the readings at the front of the list.
+     *
+     * @param readings The readings as they were read from persistence.
+     * @param count The count of readings from the front to take.
+     * @return The taken readings.
+     */
+    static std::vector<std::shared_ptr<Reading>> take(const std::vector<std::shared_ptr<Reading>>& readings,
+                                                      std::uint64_t count);
+
+    /**
+     * This method will put a published batch in flight.
+     *
+     * @param message The published message. A batch without a message is treated as already confirmed.
+     * @param taken The readings in the batch.
+     * @return The counts of readings that can now be removed from persistence, if the batch was confirmed and there
+     * is nothing in front of it.
+     */
+    CommittedReadings add(std::shared_ptr<Message> message, const TakenReadings& taken);
+
+    /**
+     * This method will return the count of readings of the persistence key that are in flight.
+     *
+     * @param key The persistence key.
+     * @return The count of readings at the front of the key to skip.
+     */
+    std::uint64_t getInFlight(const std::string& key) const;
+
+    /**
+     * This method will match the readings in flight against the front of the persistence key, and forget the ones
+     * the persistence evicted. Those are no longer counted in their batches, so they are not removed a second time.
+     *
+     * @param key The persistence key.
+     * @param front The readings at the front of the key, at least as many as there are in flight.
+     * @return The count of readings at the front of the key that are in flight.
+     */
+    std::uint64_t align(const std::string& key, const std::vector<std::shared_ptr<Reading>>& front);
+
+    /**
+     * This method will confirm the delivery of a batch.
+     *
+     * @param message The delivered message.
+     * @return Whether the message belongs to a batch in flight.
+     */
+    bool confirm(const std::shared_ptr<Message>& message);
+
+    /**
+     * This method will return the persistence keys of the confirmed batches at the front, which `commit` removes
+     * readings from. They should be aligned before committing.
+     *
+     * @return The persistence keys.
+     */
+    std::vector<std::string> getCommittableKeys() const;
+
+    /**
+     * This method will take the confirmed batches off the front.
+     *
+     * @return The counts of readings that can now be removed from persistence. Empty while an older batch is still
+     * waiting for its confirmation.
+     */
+    CommittedReadings commit();
+
+    /**
+     * This method will forget all the batches in flight, so their readings are published again.
+     *
+     * @return The count of batches that were requeued.
+     */
+    std::size_t requeue();
+
+private:
+    struct Batch
+    {
+        std::shared_ptr<Message> message;
+        CommittedReadings taken;
+        bool confirmed;
+    };
+
+    std::size_t m_capacity;
+    std::deque<Batch> m_batches;
+    std::unordered_map<std::string, std::deque<std::shared_ptr<Reading>>> m_inFlight;
+};
+}    // namespace connect
+}    // namespace wolkabout
+
+#endif    // WOLKABOUTCONNECTOR_INFLIGHTWINDOW_H
@@ -0,0 +1,98 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/service/data/KeyInterner.h"
+
+#include <utility>
+
+namespace wolkabout
+{
+namespace connect
+{
+KeyInterner::KeyInterner(std::string delimiter) : m_delimiter(std::move(delimiter)) {}
+
+const InternedKey& KeyInterner::intern(const std::string& deviceKey, const std::string& reference)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return findOrAddKey(findOrAddDevice(deviceKey), deviceKey, reference);
+}
+
+const InternedKey* KeyInterner::resolve(const std::string& persistenceKey)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    // Check if the key has already been seen
+    const auto it = m_persistenceKeys.find(persistenceKey);
+    if (it != m_persistenceKeys.cend())
+        return &m_keys[it->second];
+
+    // Otherwise, parse it once
+    const auto position = persistenceKey.find(m_delimiter);
+    if (position == std::string::npos || position == 0)
+        return nullptr;
+    const auto deviceKey = persistenceKey.substr(0, position);
+    const auto reference = persistenceKey.substr(position + m_delimiter.size());
+    return &findOrAddKey(findOrAddDevice(deviceKey), deviceKey, reference);
+}
+
+const InternedKey* KeyInterner::get(FeedId id) const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    if (id >= m_keys.size())
+        return nullptr;
+    return &m_keys[id];
+}
+
+DeviceId KeyInterner::internDevice(const std::string& deviceKey)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return findOrAddDevice(deviceKey).id;
+}
+
+std::size_t KeyInterner::size() const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_keys.size();
+}
+
+KeyInterner::DeviceEntry& KeyInterner::findOrAddDevice(const std::string& deviceKey)
+{
+    auto it = m_devices.find(deviceKey);
+    if (it == m_devices.end())
+    {
+        const auto id = static_cast<DeviceId>(m_devices.size());
+        it = m_devices.emplace(deviceKey, DeviceEntry{id, {}}).first;
+    }
+    return it->second;
+}
+
+const InternedKey& KeyInterner::findOrAddKey(DeviceEntry& device, const std::string& deviceKey,
+                                             const std::string& reference)
+{
+    const auto it = device.references.find(reference);
+    if (it != device.references.cend())
+        return m_keys[it->second];
+
+    // Make the new entry, and remember it by both the pair and the composite key
+    const auto id = static_cast<FeedId>(m_keys.size());
+    m_keys.push_back(InternedKey{id, device.id, deviceKey, reference, deviceKey + m_delimiter + reference});
+    device.references.emplace(reference, id);
+    m_persistenceKeys.emplace(m_keys.back().persistenceKey, id);
+    return m_keys.back();
+}
+}    // namespace connect
+}    // namespace wolkabout
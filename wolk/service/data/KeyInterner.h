@@ -0,0 +1,126 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WOLKABOUTCONNECTOR_KEYINTERNER_H
+#define WOLKABOUTCONNECTOR_KEYINTERNER_H
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace wolkabout
+{
+namespace connect
+{
+// Compact identifiers handed out by the interner.
+using DeviceId = std::uint32_t;
+using FeedId = std::uint32_t;
+
+/**
+ * This is the structure holding everything about a single interned device key/reference pair.
+ * The strings are built only once, when the pair is seen for the first time.
+ */
+struct InternedKey
+{
+    FeedId id;
+    DeviceId deviceId;
+    std::string deviceKey;
+    std::string reference;
+    std::string persistenceKey;
+};
+
+/**
+ * This class maps device keys and references (feed references, attribute names, parameter names) to compact integer
+ * identifiers, and keeps the composite persistence key of every pair, so it does not need to be rebuilt or parsed
+ * every time a value passes through the `DataService`.
+ * Returned references to `InternedKey` objects remain valid for the lifetime of the interner.
+ */
+class KeyInterner
+{
+public:
+    /**
+     * Default parameter constructor.
+     *
+     * @param delimiter The delimiter placed between the device key and the reference in a persistence key.
+     */
+    explicit KeyInterner(std::string delimiter);
+
+    /**
+     * This method will obtain the entry for a device key/reference pair, creating one if the pair is new.
+     *
+     * @param deviceKey The device key.
+     * @param reference The reference.
+     * @return The interned entry.
+     */
+    const InternedKey& intern(const std::string& deviceKey, const std::string& reference);
+
+    /**
+     * This method will obtain the entry for a persistence key. If the key was not seen before, it will be parsed once.
+     *
+     * @param persistenceKey The composite persistence key.
+     * @return The interned entry. A nullptr if the key is not a valid persistence key.
+     */
+    const InternedKey* resolve(const std::string& persistenceKey);
+
+    /**
+     * This method will obtain the entry for a feed identifier.
+     *
+     * @param id The identifier of the entry.
+     * @return The interned entry. A nullptr if the identifier is unknown.
+     */
+    const InternedKey* get(FeedId id) const;
+
+    /**
+     * This method will obtain the identifier of a device, creating one if the device is new.
+     *
+     * @param deviceKey The device key.
+     * @return The device identifier.
+     */
+    DeviceId internDevice(const std::string& deviceKey);
+
+    /**
+     * This method returns the count of all the interned pairs.
+     *
+     * @return The count of interned pairs.
+     */
+    std::size_t size() const;
+
+private:
+    struct DeviceEntry
+    {
+        DeviceId id;
+        std::unordered_map<std::string, FeedId> references;
+    };
+
+    DeviceEntry& findOrAddDevice(const std::string& deviceKey);
+
+    const InternedKey& findOrAddKey(DeviceEntry& device, const std::string& deviceKey, const std::string& reference);
+
+    std::string m_delimiter;
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, DeviceEntry> m_devices;
+    std::deque<InternedKey> m_keys;
+    std::unordered_map<std::string, FeedId> m_persistenceKeys;
+};
+}    // namespace connect
+}    // namespace wolkabout
+
+#endif    // WOLKABOUTCONNECTOR_KEYINTERNER_H
@@ -0,0 +1,53 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/service/data/PriorityPolicy.h"
+
+#include <algorithm>
+
+namespace wolkabout
+{
+namespace connect
+{
+PriorityPolicy::PriorityPolicy(PriorityMode mode, std::array<std::uint32_t, CLASS_COUNT> weights)
+: m_mode(mode), m_weights(weights)
+{
+    for (auto& weight : m_weights)
+        weight = std::max(weight, std::uint32_t{1});
+}
+
+PriorityPolicy PriorityPolicy::strict()
+{
+    return PriorityPolicy{PriorityMode::Strict};
+}
+
+PriorityPolicy PriorityPolicy::weighted(std::array<std::uint32_t, CLASS_COUNT> weights)
+{
+    return PriorityPolicy{PriorityMode::Weighted, weights};
+}
+
+PriorityMode PriorityPolicy::getMode() const
+{
+    return m_mode;
+}
+
+std::uint32_t PriorityPolicy::getWeight(FeedPriority priority) const
+{
+    return m_weights[std::min(static_cast<std::size_t>(priority), CLASS_COUNT - 1)];
+}
+}    // namespace connect
+}    // namespace wolkabout
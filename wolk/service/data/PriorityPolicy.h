@@ -0,0 +1,82 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WOLKABOUTCONNECTOR_PRIORITYPOLICY_H
+#define WOLKABOUTCONNECTOR_PRIORITYPOLICY_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace wolkabout
+{
+namespace connect
+{
+// The classes feeds are put in when readings are published. Feeds without a priority are in the `Normal` class.
+enum class FeedPriority
+{
+    Critical = 0,
+    High,
+    Normal,
+    Low
+};
+
+// The ways the readings of the priority classes are interleaved when they are published.
+enum class PriorityMode
+{
+    // A class is published only once all the classes above it have nothing left
+    Strict = 0,
+    // Classes take turns, each sending up to its weight in messages in a turn
+    Weighted
+};
+
+/**
+ * This class describes the order in which the readings of the priority classes are published.
+ * In the strict mode, control-plane and alarm data in the higher classes always goes out first, while the weighted
+ * mode keeps the lower classes from waiting for too long behind a busy higher class.
+ */
+class PriorityPolicy
+{
+public:
+    static const constexpr std::size_t CLASS_COUNT = 4;
+
+    /**
+     * Default parameter constructor.
+     *
+     * @param mode The way classes are interleaved.
+     * @param weights The count of messages each class can send in a turn, starting from `Critical`. Only used in the
+     * weighted mode, and a weight of zero is treated as one.
+     */
+    explicit PriorityPolicy(PriorityMode mode = PriorityMode::Strict,
+                            std::array<std::uint32_t, CLASS_COUNT> weights = {{8, 4, 2, 1}});
+
+    static PriorityPolicy strict();
+
+    static PriorityPolicy weighted(std::array<std::uint32_t, CLASS_COUNT> weights = {{8, 4, 2, 1}});
+
+    PriorityMode getMode() const;
+
+    std::uint32_t getWeight(FeedPriority priority) const;
+
+private:
+    PriorityMode m_mode;
+    std::array<std::uint32_t, CLASS_COUNT> m_weights;
+};
+}    // namespace connect
+}    // namespace wolkabout
+
+#endif    // WOLKABOUTCONNECTOR_PRIORITYPOLICY_H
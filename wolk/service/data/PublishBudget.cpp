@@ -0,0 +1,93 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/service/data/PublishBudget.h"
+
+namespace wolkabout
+{
+namespace connect
+{
+PublishBudget::PublishBudget(std::uint64_t messages, std::uint64_t bytes, std::chrono::milliseconds time)
+: m_messages(messages)
+, m_bytes(bytes)
+, m_time(time)
+, m_spentMessages(0)
+, m_spentBytes(0)
+, m_failed(false)
+, m_started(std::chrono::steady_clock::now())
+{
+}
+
+bool PublishBudget::isUnlimited() const
+{
+    return m_messages == 0 && m_bytes == 0 && m_time.count() == 0;
+}
+
+void PublishBudget::restart()
+{
+    m_spentMessages = 0;
+    m_spentBytes = 0;
+    m_failed = false;
+    m_started = std::chrono::steady_clock::now();
+}
+
+void PublishBudget::consume(std::uint64_t bytes)
+{
+    ++m_spentMessages;
+    m_spentBytes += bytes;
+}
+
+bool PublishBudget::isExhausted() const
+{
+    if (m_messages > 0 && m_spentMessages >= m_messages)
+        return true;
+    if (m_bytes > 0 && m_spentBytes >= m_bytes)
+        return true;
+    return m_time.count() > 0 && std::chrono::steady_clock::now() - m_started >= m_time;
+}
+
+std::uint64_t PublishBudget::getSpentMessages() const
+{
+    return m_spentMessages;
+}
+
+std::uint64_t PublishBudget::getMessageLimit() const
+{
+    return m_messages;
+}
+
+void PublishBudget::setMessageLimit(std::uint64_t messages)
+{
+    m_messages = messages;
+}
+
+std::uint64_t PublishBudget::getSpentBytes() const
+{
+    return m_spentBytes;
+}
+
+void PublishBudget::fail()
+{
+    m_failed = true;
+}
+
+bool PublishBudget::hasFailed() const
+{
+    return m_failed;
+}
+}    // namespace connect
+}    // namespace wolkabout
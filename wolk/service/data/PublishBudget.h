@@ -0,0 +1,112 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WOLKABOUTCONNECTOR_PUBLISHBUDGET_H
+#define WOLKABOUTCONNECTOR_PUBLISHBUDGET_H
+
+#include <chrono>
+#include <cstdint>
+
+namespace wolkabout
+{
+namespace connect
+{
+/**
+ * This class describes how much work a single publishing pass is allowed to do before it has to yield.
+ * The budget can be limited by the count of sent messages, the count of sent bytes and the time spent publishing.
+ * A limit set to zero means that the budget is not limited in that dimension.
+ */
+class PublishBudget
+{
+public:
+    /**
+     * Default parameter constructor.
+     *
+     * @param messages The maximum count of messages that can be sent.
+     * @param bytes The maximum count of payload bytes that can be sent.
+     * @param time The maximum time that can be spent publishing.
+     */
+    explicit PublishBudget(std::uint64_t messages = 0, std::uint64_t bytes = 0,
+                           std::chrono::milliseconds time = std::chrono::milliseconds{0});
+
+    /**
+     * This method is used to check whether the budget has any limits at all.
+     *
+     * @return Whether all the limits are set to zero.
+     */
+    bool isUnlimited() const;
+
+    /**
+     * This method will reset everything that was spent and restart the time measurement.
+     */
+    void restart();
+
+    /**
+     * This method is used to record a single sent message.
+     *
+     * @param bytes The size of the payload of the message.
+     */
+    void consume(std::uint64_t bytes);
+
+    /**
+     * This method is used to check whether any of the limits has been reached.
+     *
+     * @return Whether the publishing pass should yield.
+     */
+    bool isExhausted() const;
+
+    std::uint64_t getSpentMessages() const;
+
+    std::uint64_t getMessageLimit() const;
+
+    /**
+     * This method will change the limit of messages, keeping everything that was already spent.
+     *
+     * @param messages The maximum count of messages that can be sent, counting the ones already sent.
+     */
+    void setMessageLimit(std::uint64_t messages);
+
+    std::uint64_t getSpentBytes() const;
+
+    /**
+     * This method is used to record that a message could not be sent.
+     */
+    void fail();
+
+    /**
+     * This method is used to check whether a message could not be sent since the last restart.
+     *
+     * @return Whether sending a message failed.
+     */
+    bool hasFailed() const;
+
+private:
+    // Here are the limits
+    std::uint64_t m_messages;
+    std::uint64_t m_bytes;
+    std::chrono::milliseconds m_time;
+
+    // Here is what has been spent
+    std::uint64_t m_spentMessages;
+    std::uint64_t m_spentBytes;
+    bool m_failed;
+    std::chrono::steady_clock::time_point m_started;
+};
+}    // namespace connect
+}    // namespace wolkabout
+
+#endif    // WOLKABOUTCONNECTOR_PUBLISHBUDGET_H
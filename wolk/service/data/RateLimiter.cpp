@@ -0,0 +1,121 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/service/data/RateLimiter.h"
+
+#include <algorithm>
+
+namespace wolkabout
+{
+namespace connect
+{
+namespace
+{
+// A single token, in the millionths the buckets are kept in
+const constexpr std::int64_t TOKEN = 1000000;
+}    // namespace
+
+
+RateLimiter::RateLimiter(std::uint64_t messagesPerSecond, std::uint64_t bytesPerSecond, std::uint64_t messageBurst,
+                         std::uint64_t byteBurst)
+: m_messages(makeBucket(messagesPerSecond, messageBurst))
+, m_bytes(makeBucket(bytesPerSecond, byteBurst))
+, m_lastRefill(Clock::now())
+, m_metrics{0, 0, 0}
+{
+}
+
+bool RateLimiter::isEnabled() const
+{
+    return m_messages.rate > 0 || m_bytes.rate > 0;
+}
+
+bool RateLimiter::isAvailable(Clock::time_point now)
+{
+    if (!isEnabled())
+        return true;
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - m_lastRefill).count();
+    if (elapsed > 0)
+    {
+        refill(m_messages, static_cast<std::int64_t>(elapsed));
+        refill(m_bytes, static_cast<std::int64_t>(elapsed));
+        m_lastRefill = now;
+    }
+
+    const auto available =
+      (m_messages.rate == 0 || m_messages.tokens >= TOKEN) && (m_bytes.rate == 0 || m_bytes.tokens > 0);
+    if (!available)
+        ++m_metrics.throttled;
+    return available;
+}
+
+void RateLimiter::consume(std::uint64_t bytes)
+{
+    ++m_metrics.publishedMessages;
+    m_metrics.publishedBytes += bytes;
+    if (m_messages.rate > 0)
+        m_messages.tokens -= TOKEN;
+    if (m_bytes.rate > 0)
+        m_bytes.tokens -= static_cast<std::int64_t>(bytes) * TOKEN;
+}
+
+std::chrono::milliseconds RateLimiter::getDelay(Clock::time_point now) const
+{
+    if (!isEnabled())
+        return std::chrono::milliseconds{0};
+
+    // The buckets refill since the last check, so that is taken off the wait
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - m_lastRefill).count();
+    const auto wait =
+      std::max(timeUntil(m_messages, TOKEN), timeUntil(m_bytes, 1)) - static_cast<std::int64_t>(elapsed);
+    if (wait <= 0)
+        return std::chrono::milliseconds{0};
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::microseconds{wait + 999});
+}
+
+RateLimiterMetrics RateLimiter::getMetrics() const
+{
+    return m_metrics;
+}
+
+RateLimiter::Bucket RateLimiter::makeBucket(std::uint64_t rate, std::uint64_t burst)
+{
+    const auto capacity = static_cast<std::int64_t>(burst > 0 ? burst : rate) * TOKEN;
+    return Bucket{static_cast<std::int64_t>(rate), capacity, capacity};
+}
+
+void RateLimiter::refill(Bucket& bucket, std::int64_t elapsed)
+{
+    if (bucket.rate == 0)
+        return;
+
+    // Refilling for long enough fills up any bucket, so the product is only taken for short times
+    if (elapsed >= (bucket.capacity - bucket.tokens) / bucket.rate + 1)
+        bucket.tokens = bucket.capacity;
+    else
+        bucket.tokens = std::min(bucket.capacity, bucket.tokens + elapsed * bucket.rate);
+}
+
+std::int64_t RateLimiter::timeUntil(const Bucket& bucket, std::int64_t tokens)
+{
+    if (bucket.rate == 0 || bucket.tokens >= tokens)
+        return 0;
+    return (tokens - bucket.tokens + bucket.rate - 1) / bucket.rate;
+}
+}    // namespace connect
+}    // namespace wolkabout
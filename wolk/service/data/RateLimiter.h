@@ -0,0 +1,109 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WOLKABOUTCONNECTOR_RATELIMITER_H
+#define WOLKABOUTCONNECTOR_RATELIMITER_H
+
+#include <chrono>
+#include <cstdint>
+
+namespace wolkabout
+{
+namespace connect
+{
+// The counts of what went through the rate limiter, and how many times publishing had to wait for it.
+struct RateLimiterMetrics
+{
+    std::uint64_t publishedMessages;
+    std::uint64_t publishedBytes;
+    std::uint64_t throttled;
+};
+
+/**
+ * This class limits the rate of outbound messages with two token buckets, one for messages and one for bytes.
+ * The buckets refill at the set rates up to their burst size, so a short burst can go out at once, while a long
+ * backlog is spread out at the set rate. A message can go out once the buckets are not empty, and a message larger
+ * than the byte bucket puts it in debt, which the following messages wait out.
+ */
+class RateLimiter
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Default parameter constructor.
+     *
+     * @param messagesPerSecond The count of messages per second. A rate of zero is not enforced.
+     * @param bytesPerSecond The count of payload bytes per second. A rate of zero is not enforced.
+     * @param messageBurst The count of messages that can go out at once. Zero means one second of messages.
+     * @param byteBurst The count of payload bytes that can go out at once. Zero means one second of bytes.
+     */
+    explicit RateLimiter(std::uint64_t messagesPerSecond = 0, std::uint64_t bytesPerSecond = 0,
+                         std::uint64_t messageBurst = 0, std::uint64_t byteBurst = 0);
+
+    bool isEnabled() const;
+
+    /**
+     * This method will refill the buckets, and check whether a message can go out now.
+     *
+     * @param now The current time.
+     * @return Whether a message can be published. If not, the wait is counted in the metrics.
+     */
+    bool isAvailable(Clock::time_point now = Clock::now());
+
+    /**
+     * This method will take a published message out of the buckets.
+     *
+     * @param bytes The size of the payload of the message.
+     */
+    void consume(std::uint64_t bytes);
+
+    /**
+     * This method will return the time until a message can go out.
+     *
+     * @param now The current time.
+     * @return The time to wait, or zero if a message can go out now.
+     */
+    std::chrono::milliseconds getDelay(Clock::time_point now = Clock::now()) const;
+
+    RateLimiterMetrics getMetrics() const;
+
+private:
+    // The tokens are kept in millionths, so the buckets can refill every microsecond at any integer rate
+    struct Bucket
+    {
+        std::int64_t rate;
+        std::int64_t capacity;
+        std::int64_t tokens;
+    };
+
+    static Bucket makeBucket(std::uint64_t rate, std::uint64_t burst);
+
+    static void refill(Bucket& bucket, std::int64_t elapsed);
+
+    // The time in microseconds until the bucket has the tokens
+    static std::int64_t timeUntil(const Bucket& bucket, std::int64_t tokens);
+
+    Bucket m_messages;
+    Bucket m_bytes;
+    Clock::time_point m_lastRefill;
+    RateLimiterMetrics m_metrics;
+};
+}    // namespace connect
+}    // namespace wolkabout
+
+#endif    // WOLKABOUTCONNECTOR_RATELIMITER_H
@@ -0,0 +1,88 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/service/data/ReadingBatch.h"
+
+#include <utility>
+
+namespace wolkabout
+{
+namespace connect
+{
+ReadingBatch::ReadingBatch(std::string reference) : m_reference(std::move(reference)) {}
+
+ReadingBatch::ReadingBatch(std::string reference, std::vector<ReadingValue> values,
+                           std::vector<std::uint64_t> timestamps)
+: m_reference(std::move(reference)), m_values(std::move(values)), m_timestamps(std::move(timestamps))
+{
+}
+
+void ReadingBatch::reserve(std::size_t count)
+{
+    m_values.reserve(count);
+    m_timestamps.reserve(count);
+}
+
+void ReadingBatch::add(ReadingValue value, std::uint64_t timestamp)
+{
+    // Keep the timestamp column aligned, if it was left empty up until now
+    if (m_timestamps.size() < m_values.size())
+        m_timestamps.resize(m_values.size(), 0);
+    m_values.emplace_back(std::move(value));
+    m_timestamps.emplace_back(timestamp);
+}
+
+void ReadingBatch::stamp(std::uint64_t rtc)
+{
+    if (m_timestamps.empty())
+        m_timestamps.resize(m_values.size(), 0);
+    for (auto& timestamp : m_timestamps)
+        if (timestamp == 0)
+            timestamp = rtc;
+}
+
+bool ReadingBatch::isValid() const
+{
+    return m_values.size() == m_timestamps.size();
+}
+
+bool ReadingBatch::empty() const
+{
+    return m_values.empty();
+}
+
+std::size_t ReadingBatch::size() const
+{
+    return m_values.size();
+}
+
+const std::string& ReadingBatch::getReference() const
+{
+    return m_reference;
+}
+
+const std::vector<ReadingValue>& ReadingBatch::getValues() const
+{
+    return m_values;
+}
+
+const std::vector<std::uint64_t>& ReadingBatch::getTimestamps() const
+{
+    return m_timestamps;
+}
+}    // namespace connect
+}    // namespace wolkabout
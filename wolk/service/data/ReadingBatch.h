@@ -0,0 +1,129 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WOLKABOUTCONNECTOR_READINGBATCH_H
+#define WOLKABOUTCONNECTOR_READINGBATCH_H
+
+#include "wolk/service/data/ReadingValue.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace wolkabout
+{
+namespace connect
+{
+/**
+ * This class holds a bulk of samples of a single feed in a columnar form - one reference, an array of values and an
+ * array of timestamps. It is meant to be built once and moved into the connector as a single unit.
+ */
+class ReadingBatch
+{
+public:
+    /**
+     * Default parameter constructor.
+     *
+     * @param reference The reference of the feed the samples belong to.
+     */
+    explicit ReadingBatch(std::string reference);
+
+    /**
+     * Default parameter constructor.
+     *
+     * @param reference The reference of the feed the samples belong to.
+     * @param values The values of the samples.
+     * @param timestamps The timestamps of the samples. If left empty, the samples will be timestamped when added.
+     */
+    ReadingBatch(std::string reference, std::vector<ReadingValue> values, std::vector<std::uint64_t> timestamps = {});
+
+    /**
+     * Parameter constructor that takes in an array of native values.
+     *
+     * @param reference The reference of the feed the samples belong to.
+     * @param values The values of the samples.
+     * @param timestamps The timestamps of the samples. If left empty, the samples will be timestamped when added.
+     */
+    template <typename T>
+    ReadingBatch(std::string reference, const std::vector<T>& values, std::vector<std::uint64_t> timestamps = {});
+
+    /**
+     * This method will reserve space for the count of samples.
+     *
+     * @param count The count of samples.
+     */
+    void reserve(std::size_t count);
+
+    /**
+     * This method will append a sample to the batch.
+     *
+     * @param value The value of the sample.
+     * @param timestamp The timestamp of the sample. If zero, the sample will be timestamped when added.
+     */
+    template <typename T> void add(T value, std::uint64_t timestamp = 0);
+
+    void add(ReadingValue value, std::uint64_t timestamp = 0);
+
+    /**
+     * This method will set the timestamp of every sample that is missing one.
+     *
+     * @param rtc The timestamp that will be used.
+     */
+    void stamp(std::uint64_t rtc);
+
+    /**
+     * This method checks whether every value has its own timestamp.
+     *
+     * @return Whether the columns are of matching size.
+     */
+    bool isValid() const;
+
+    bool empty() const;
+
+    std::size_t size() const;
+
+    const std::string& getReference() const;
+
+    const std::vector<ReadingValue>& getValues() const;
+
+    const std::vector<std::uint64_t>& getTimestamps() const;
+
+private:
+    std::string m_reference;
+    std::vector<ReadingValue> m_values;
+    std::vector<std::uint64_t> m_timestamps;
+};
+
+template <typename T>
+ReadingBatch::ReadingBatch(std::string reference, const std::vector<T>& values, std::vector<std::uint64_t> timestamps)
+: ReadingBatch(std::move(reference))
+{
+    m_values.reserve(values.size());
+    for (const auto& value : values)
+        m_values.emplace_back(value);
+    m_timestamps = std::move(timestamps);
+}
+
+template <typename T> void ReadingBatch::add(T value, std::uint64_t timestamp)
+{
+    add(ReadingValue{value}, timestamp);
+}
+}    // namespace connect
+}    // namespace wolkabout
+
+#endif    // WOLKABOUTCONNECTOR_READINGBATCH_H
@@ -0,0 +1,136 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/service/data/ReadingValue.h"
+
+#include "core/utilities/StringUtils.h"
+
+#include <cstring>
+#include <utility>
+
+namespace wolkabout
+{
+namespace connect
+{
+ReadingValue::ReadingValue() : m_type(Type::String), m_unsigned(0) {}
+
+ReadingValue::ReadingValue(bool value) : m_type(Type::Boolean), m_bool(value) {}
+
+ReadingValue::ReadingValue(float value) : m_type(Type::Float), m_float(value) {}
+
+ReadingValue::ReadingValue(double value) : m_type(Type::Double), m_double(value) {}
+
+ReadingValue::ReadingValue(const char* value) : m_type(Type::String), m_unsigned(0), m_string(value) {}
+
+ReadingValue::ReadingValue(std::string value) : m_type(Type::String), m_unsigned(0), m_string(std::move(value)) {}
+
+ReadingValue::Type ReadingValue::getType() const
+{
+    return m_type;
+}
+
+bool ReadingValue::isString() const
+{
+    return m_type == Type::String;
+}
+
+bool ReadingValue::getBool() const
+{
+    return m_type == Type::Boolean && m_bool;
+}
+
+long long ReadingValue::getSigned() const
+{
+    return m_type == Type::Signed ? m_signed : static_cast<long long>(getNumber());
+}
+
+std::uint64_t ReadingValue::getUnsigned() const
+{
+    return m_type == Type::Unsigned ? m_unsigned : static_cast<std::uint64_t>(getNumber());
+}
+
+double ReadingValue::getNumber() const
+{
+    switch (m_type)
+    {
+    case Type::Boolean:
+        return m_bool ? 1.0 : 0.0;
+    case Type::Signed:
+        return static_cast<double>(m_signed);
+    case Type::Unsigned:
+        return static_cast<double>(m_unsigned);
+    case Type::Float:
+        return static_cast<double>(m_float);
+    case Type::Double:
+        return m_double;
+    default:
+        return 0.0;
+    }
+}
+
+const std::string& ReadingValue::getString() const
+{
+    return m_string;
+}
+
+std::string ReadingValue::toString() const
+{
+    switch (m_type)
+    {
+    case Type::Boolean:
+        return StringUtils::toString(m_bool);
+    case Type::Signed:
+        return StringUtils::toString(m_signed);
+    case Type::Unsigned:
+        return StringUtils::toString(m_unsigned);
+    case Type::Float:
+        return StringUtils::toString(m_float);
+    case Type::Double:
+        return StringUtils::toString(m_double);
+    default:
+        return m_string;
+    }
+}
+
+bool ReadingValue::operator==(const ReadingValue& other) const
+{
+    if (m_type != other.m_type)
+        return false;
+    switch (m_type)
+    {
+    case Type::Boolean:
+        return m_bool == other.m_bool;
+    case Type::Signed:
+        return m_signed == other.m_signed;
+    case Type::Unsigned:
+        return m_unsigned == other.m_unsigned;
+    // Floating point values are compared bit by bit, so a NaN is equal to the same NaN
+    case Type::Float:
+        return std::memcmp(&m_float, &other.m_float, sizeof(m_float)) == 0;
+    case Type::Double:
+        return std::memcmp(&m_double, &other.m_double, sizeof(m_double)) == 0;
+    default:
+        return m_string == other.m_string;
+    }
+}
+
+bool ReadingValue::operator!=(const ReadingValue& other) const
+{
+    return !(*this == other);
+}
+}    // namespace connect
+}    // namespace wolkabout
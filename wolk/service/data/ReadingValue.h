@@ -0,0 +1,126 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WOLKABOUTCONNECTOR_READINGVALUE_H
+#define WOLKABOUTCONNECTOR_READINGVALUE_H
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+namespace wolkabout
+{
+namespace connect
+{
+/**
+ * This class holds the value of a single reading in its native form.
+ * Numeric and boolean values are kept as they are, and are formatted into a string only when `toString` is called,
+ * so values that never reach the outbound payload never pay for the formatting.
+ */
+class ReadingValue
+{
+public:
+    enum class Type
+    {
+        String,
+        Boolean,
+        Signed,
+        Unsigned,
+        Float,
+        Double
+    };
+
+    /**
+     * Default constructor. Creates an empty string value.
+     */
+    ReadingValue();
+
+    explicit ReadingValue(bool value);
+
+    explicit ReadingValue(float value);
+
+    explicit ReadingValue(double value);
+
+    explicit ReadingValue(const char* value);
+
+    explicit ReadingValue(std::string value);
+
+    template <typename T, typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value &&
+                                                    !std::is_same<T, bool>::value,
+                                                  int>::type = 0>
+    explicit ReadingValue(T value) : m_type(Type::Signed), m_signed(static_cast<long long>(value))
+    {
+    }
+
+    template <typename T, typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value &&
+                                                    !std::is_same<T, bool>::value,
+                                                  int>::type = 0>
+    explicit ReadingValue(T value) : m_type(Type::Unsigned), m_unsigned(static_cast<std::uint64_t>(value))
+    {
+    }
+
+    Type getType() const;
+
+    /**
+     * This method returns whether the value is held as a string, and needs no formatting.
+     *
+     * @return Whether the value is a string.
+     */
+    bool isString() const;
+
+    bool getBool() const;
+
+    long long getSigned() const;
+
+    std::uint64_t getUnsigned() const;
+
+    /**
+     * This method returns any non-string value converted into a double.
+     *
+     * @return The value as a double. Zero for string values.
+     */
+    double getNumber() const;
+
+    const std::string& getString() const;
+
+    /**
+     * This method formats the value the same way the `StringUtils::toString` overload for its type would.
+     *
+     * @return The value as a string.
+     */
+    std::string toString() const;
+
+    bool operator==(const ReadingValue& other) const;
+
+    bool operator!=(const ReadingValue& other) const;
+
+private:
+    Type m_type;
+    union
+    {
+        bool m_bool;
+        long long m_signed;
+        std::uint64_t m_unsigned;
+        float m_float;
+        double m_double;
+    };
+    std::string m_string;
+};
+}    // namespace connect
+}    // namespace wolkabout
+
+#endif    // WOLKABOUTCONNECTOR_READINGVALUE_H
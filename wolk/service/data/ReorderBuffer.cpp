@@ -0,0 +1,144 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/service/data/ReorderBuffer.h"
+
+#include <algorithm>
+
+namespace wolkabout
+{
+namespace connect
+{
+ReorderBuffer::ReorderBuffer(std::chrono::milliseconds lateness) : m_lateness(lateness) {}
+
+void ReorderBuffer::setLateness(std::chrono::milliseconds lateness)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_lateness = lateness;
+}
+
+std::chrono::milliseconds ReorderBuffer::getLateness() const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_lateness;
+}
+
+bool ReorderBuffer::isEnabled() const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_lateness.count() > 0;
+}
+
+std::size_t ReorderBuffer::getBufferedCount() const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    auto count = std::size_t{0};
+    for (const auto& feed : m_feeds)
+        count += feed.second.entries.size();
+    return count;
+}
+
+std::vector<Reading> ReorderBuffer::push(const std::string& persistenceKey, Reading reading, Clock::time_point now)
+{
+    // Readings without a timestamp are stamped by the platform, so there is nothing to order them by
+    std::lock_guard<std::mutex> lock{m_mutex};
+    const auto timestamp = reading.getTimestamp();
+    if (m_lateness.count() <= 0 || timestamp == 0)
+        return {std::move(reading)};
+
+    auto& buffer = m_feeds[persistenceKey];
+
+    // Readings later than the window can no longer be put in order, so only the repeated ones are dropped
+    if (buffer.released && timestamp <= buffer.lastReleased)
+    {
+        if (timestamp == buffer.lastReleased && reading.getStringValues() == buffer.lastReleasedValues)
+            return {};
+        return {std::move(reading)};
+    }
+
+    // Distinct readings with the same timestamp are kept after the ones that arrived before them
+    const auto range = buffer.entries.equal_range(timestamp);
+    for (auto it = range.first; it != range.second; ++it)
+        if (it->second.reading.getStringValues() == reading.getStringValues())
+            return releaseDue(buffer, now);
+    buffer.entries.emplace_hint(range.second, timestamp, Entry{std::move(reading), now});
+    return releaseDue(buffer, now);
+}
+
+ReorderBuffer::ReleasedReadings ReorderBuffer::release(Clock::time_point now)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    auto released = ReleasedReadings{};
+    for (auto& feed : m_feeds)
+    {
+        auto readings = releaseDue(feed.second, now);
+        if (!readings.empty())
+            released.emplace_back(feed.first, std::move(readings));
+    }
+    return released;
+}
+
+void ReorderBuffer::order(std::vector<Reading>& readings)
+{
+    const auto before = [](const Reading& lhs, const Reading& rhs) {
+        if (lhs.getTimestamp() != rhs.getTimestamp())
+            return lhs.getTimestamp() < rhs.getTimestamp();
+        return lhs.getReference() < rhs.getReference();
+    };
+    if (!std::is_sorted(readings.begin(), readings.end(), before))
+        std::stable_sort(readings.begin(), readings.end(), before);
+
+    // Only the readings repeating the reference, the timestamp and the value of one before them are dropped
+    const auto repeats = [](const Reading& lhs, const Reading& rhs) {
+        return lhs.getTimestamp() != 0 && lhs.getTimestamp() == rhs.getTimestamp() &&
+               lhs.getReference() == rhs.getReference() && lhs.getStringValues() == rhs.getStringValues();
+    };
+    auto kept = std::vector<Reading>{};
+    kept.reserve(readings.size());
+    for (auto& reading : readings)
+    {
+        auto repeated = false;
+        for (auto it = kept.rbegin(); it != kept.rend() && it->getTimestamp() == reading.getTimestamp(); ++it)
+            repeated = repeated || repeats(*it, reading);
+        if (!repeated)
+            kept.emplace_back(std::move(reading));
+    }
+    readings = std::move(kept);
+}
+
+std::vector<Reading> ReorderBuffer::releaseDue(FeedBuffer& buffer, Clock::time_point now) const
+{
+    // Find the newest reading that is due, and everything older than it goes out with it
+    auto end = buffer.entries.begin();
+    for (auto it = buffer.entries.begin(); it != buffer.entries.end(); ++it)
+        if (now - it->second.arrived >= m_lateness)
+            end = std::next(it);
+
+    auto readings = std::vector<Reading>{};
+    for (auto it = buffer.entries.begin(); it != end; ++it)
+        readings.emplace_back(std::move(it->second.reading));
+    if (!readings.empty())
+    {
+        buffer.released = true;
+        buffer.lastReleased = readings.back().getTimestamp();
+        buffer.lastReleasedValues = readings.back().getStringValues();
+    }
+    buffer.entries.erase(buffer.entries.begin(), end);
+    return readings;
+}
+}    // namespace connect
+}    // namespace wolkabout
@@ -0,0 +1,118 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WOLKABOUTCONNECTOR_REORDERBUFFER_H
+#define WOLKABOUTCONNECTOR_REORDERBUFFER_H
+
+#include "core/model/Reading.h"
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace wolkabout
+{
+namespace connect
+{
+/**
+ * This class holds back the readings of every feed for a lateness window, so the ones that arrive out of order can be
+ * stored in the order of their timestamps. A reading is let through once it has waited for the lateness window, along
+ * with all the older readings of its feed. Readings that repeat both the timestamp and the value of another one are
+ * collapsed, while distinct readings with the same timestamp are kept in the order they arrived. Readings that arrive
+ * after newer ones were let through are stored right away, unless they repeat the last one. Readings without a
+ * timestamp are never held back.
+ */
+class ReorderBuffer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // The readings that were let through, with the persistence key of their feed
+    using ReleasedReadings = std::vector<std::pair<std::string, std::vector<Reading>>>;
+
+    /**
+     * Default parameter constructor.
+     *
+     * @param lateness The time readings are held back for. Zero lets every reading through right away.
+     */
+    explicit ReorderBuffer(std::chrono::milliseconds lateness = std::chrono::milliseconds{0});
+
+    void setLateness(std::chrono::milliseconds lateness);
+
+    std::chrono::milliseconds getLateness() const;
+
+    bool isEnabled() const;
+
+    std::size_t getBufferedCount() const;
+
+    /**
+     * This method will put a reading in the buffer of its feed.
+     *
+     * @param persistenceKey The persistence key of the feed.
+     * @param reading The new reading.
+     * @param now The current time.
+     * @return The readings of the feed that can be stored now, from the oldest one.
+     */
+    std::vector<Reading> push(const std::string& persistenceKey, Reading reading, Clock::time_point now = Clock::now());
+
+    /**
+     * This method will let through the readings that have waited for the lateness window, in all the feeds.
+     *
+     * @param now The current time.
+     * @return The readings that can be stored now, from the oldest one of every feed.
+     */
+    ReleasedReadings release(Clock::time_point now = Clock::now());
+
+    /**
+     * This method will sort the readings of a message by their timestamps, and collapse the readings of a feed that
+     * repeat both the timestamp and the value of another one.
+     *
+     * @param readings The readings, in the order they were stored.
+     */
+    static void order(std::vector<Reading>& readings);
+
+private:
+    struct Entry
+    {
+        Reading reading;
+        Clock::time_point arrived;
+    };
+
+    struct FeedBuffer
+    {
+        std::multimap<std::uint64_t, Entry> entries;
+        bool released;
+        std::uint64_t lastReleased;
+        std::vector<std::string> lastReleasedValues;
+    };
+
+    // Lets through the readings of the feed up to the newest one that is due
+    std::vector<Reading> releaseDue(FeedBuffer& buffer, Clock::time_point now) const;
+
+    mutable std::mutex m_mutex;
+    std::chrono::milliseconds m_lateness;
+    std::unordered_map<std::string, FeedBuffer> m_feeds;
+};
+}    // namespace connect
+}    // namespace wolkabout
+
+#endif    // WOLKABOUTCONNECTOR_REORDERBUFFER_H
@@ -0,0 +1,132 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "wolk/service/data/ReportingFilter.h"
+
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+
+namespace wolkabout
+{
+namespace connect
+{
+void ReportingFilter::setPolicy(const std::string& reference, const ReportingPolicy& policy)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    if (policy.isFiltering())
+        m_references[reference] = Feeds{policy, {}};
+    else
+        m_references.erase(reference);
+}
+
+ReportingPolicy ReportingFilter::getPolicy(const std::string& reference) const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    const auto it = m_references.find(reference);
+    return it != m_references.cend() ? it->second.policy : ReportingPolicy{};
+}
+
+bool ReportingFilter::shouldReport(const InternedKey& key, const ReadingValue& value, std::uint64_t rtc)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    const auto it = m_references.find(key.reference);
+    return it == m_references.end() || report(it->second, key.deviceId, makeSample(value, rtc));
+}
+
+bool ReportingFilter::shouldReport(const InternedKey& key, const std::string& value, std::uint64_t rtc)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    const auto it = m_references.find(key.reference);
+    return it == m_references.end() || report(it->second, key.deviceId, makeSample(value, rtc));
+}
+
+bool ReportingFilter::shouldReport(const InternedKey& key, const std::vector<std::string>& values, std::uint64_t rtc)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    const auto it = m_references.find(key.reference);
+    if (it == m_references.end())
+        return true;
+    if (values.size() == 1)
+        return report(it->second, key.deviceId, makeSample(values.front(), rtc));
+
+    // Values of multi-value feeds are only compared as a whole
+    auto text = std::string{};
+    for (const auto& value : values)
+        text += value + ',';
+    return report(it->second, key.deviceId, Sample{false, 0, std::move(text), rtc});
+}
+
+bool ReportingFilter::report(Feeds& feeds, DeviceId device, Sample sample)
+{
+    const auto last = feeds.lastReported.find(device);
+    if (last != feeds.lastReported.cend())
+    {
+        // Readings older than the last reported one do not count towards the heartbeat
+        const auto heartbeat = feeds.policy.getHeartbeat().count();
+        const auto heartbeatPassed = heartbeat > 0 && sample.rtc >= last->second.rtc &&
+                                     sample.rtc - last->second.rtc >= static_cast<std::uint64_t>(heartbeat);
+        if (!heartbeatPassed && !exceeds(feeds.policy, last->second, sample))
+            return false;
+    }
+    feeds.lastReported[device] = std::move(sample);
+    return true;
+}
+
+ReportingFilter::Sample ReportingFilter::makeSample(const ReadingValue& value, std::uint64_t rtc)
+{
+    switch (value.getType())
+    {
+    case ReadingValue::Type::Boolean:
+        return Sample{false, 0, value.toString(), rtc};
+    case ReadingValue::Type::String:
+        return makeSample(value.getString(), rtc);
+    default:
+        return Sample{true, value.getNumber(), {}, rtc};
+    }
+}
+
+ReportingFilter::Sample ReportingFilter::makeSample(const std::string& value, std::uint64_t rtc)
+{
+    // Numbers sent as strings are still compared as numbers
+    char* end = nullptr;
+    errno = 0;
+    const auto number = std::strtod(value.c_str(), &end);
+    if (!value.empty() && end == value.c_str() + value.size() && errno == 0 && std::isfinite(number))
+        return Sample{true, number, {}, rtc};
+    return Sample{false, 0, value, rtc};
+}
+
+bool ReportingFilter::exceeds(const ReportingPolicy& policy, const Sample& last, const Sample& current)
+{
+    if (!last.numeric || !current.numeric)
+        return last.numeric != current.numeric || last.text != current.text;
+
+    const auto difference = std::fabs(current.number - last.number);
+    switch (policy.getMode())
+    {
+    case ReportingMode::AbsoluteDeadband:
+        return difference > policy.getDeadband();
+    case ReportingMode::PercentDeadband:
+        return difference > std::fabs(last.number) * policy.getDeadband() / 100.0;
+    case ReportingMode::OnChange:
+        return difference > 0;
+    default:
+        return true;
+    }
+}
+}    // namespace connect
+}    // namespace wolkabout
@@ -0,0 +1,104 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WOLKABOUTCONNECTOR_REPORTINGFILTER_H
+#define WOLKABOUTCONNECTOR_REPORTINGFILTER_H
+
+#include "wolk/service/data/KeyInterner.h"
+#include "wolk/service/data/ReadingValue.h"
+#include "wolk/service/data/ReportingPolicy.h"
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace wolkabout
+{
+namespace connect
+{
+/**
+ * This class applies the `ReportingPolicy` of every reference to the readings of all devices.
+ * It remembers the last reported reading of every feed, and tells whether a new reading should be reported.
+ * Feeds of references without a policy are always reported, and are not tracked.
+ */
+class ReportingFilter
+{
+public:
+    /**
+     * This method will set the policy for all feeds with the reference. Setting a policy that reports everything
+     * removes the policy, and previous state of the feeds is forgotten whenever the policy changes.
+     *
+     * @param reference The feed reference.
+     * @param policy The new policy.
+     */
+    void setPolicy(const std::string& reference, const ReportingPolicy& policy);
+
+    /**
+     * This method returns the policy for all feeds with the reference.
+     *
+     * @param reference The feed reference.
+     * @return The policy, or a policy that reports everything if none was set.
+     */
+    ReportingPolicy getPolicy(const std::string& reference) const;
+
+    /**
+     * This method checks whether a reading should be reported, and if it should, remembers it as the last reported.
+     *
+     * @param key The interned key of the feed.
+     * @param value The value of the reading.
+     * @param rtc The timestamp of the reading (in milliseconds).
+     * @return Whether the reading should be reported.
+     */
+    bool shouldReport(const InternedKey& key, const ReadingValue& value, std::uint64_t rtc);
+
+    bool shouldReport(const InternedKey& key, const std::string& value, std::uint64_t rtc);
+
+    bool shouldReport(const InternedKey& key, const std::vector<std::string>& values, std::uint64_t rtc);
+
+private:
+    // The last reported reading of a feed. Numeric values are compared as numbers, everything else as text.
+    struct Sample
+    {
+        bool numeric;
+        double number;
+        std::string text;
+        std::uint64_t rtc;
+    };
+
+    struct Feeds
+    {
+        ReportingPolicy policy;
+        std::unordered_map<DeviceId, Sample> lastReported;
+    };
+
+    static Sample makeSample(const ReadingValue& value, std::uint64_t rtc);
+
+    static Sample makeSample(const std::string& value, std::uint64_t rtc);
+
+    static bool exceeds(const ReportingPolicy& policy, const Sample& last, const Sample& current);
+
+    // Compares the sample against the last reported one of the device, and remembers it if it is reported
+    static bool report(Feeds& feeds, DeviceId device, Sample sample);
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, Feeds> m_references;
+};
+}    // namespace connect
+}    // namespace wolkabout
+
+#endif    // WOLKABOUTCONNECTOR_REPORTINGFILTER_H
@@ -0,0 +1,65 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "wolk/service/data/ReportingPolicy.h"
+
+#include <cmath>
+
+namespace wolkabout
+{
+namespace connect
+{
+ReportingPolicy::ReportingPolicy(ReportingMode mode, double deadband, std::chrono::milliseconds heartbeat)
+: m_mode(mode), m_deadband(std::fabs(deadband)), m_heartbeat(heartbeat)
+{
+}
+
+ReportingPolicy ReportingPolicy::onChange(std::chrono::milliseconds heartbeat)
+{
+    return ReportingPolicy{ReportingMode::OnChange, 0, heartbeat};
+}
+
+ReportingPolicy ReportingPolicy::absoluteDeadband(double deadband, std::chrono::milliseconds heartbeat)
+{
+    return ReportingPolicy{ReportingMode::AbsoluteDeadband, deadband, heartbeat};
+}
+
+ReportingPolicy ReportingPolicy::percentDeadband(double percent, std::chrono::milliseconds heartbeat)
+{
+    return ReportingPolicy{ReportingMode::PercentDeadband, percent, heartbeat};
+}
+
+bool ReportingPolicy::isFiltering() const
+{
+    return m_mode != ReportingMode::Always;
+}
+
+ReportingMode ReportingPolicy::getMode() const
+{
+    return m_mode;
+}
+
+double ReportingPolicy::getDeadband() const
+{
+    return m_deadband;
+}
+
+std::chrono::milliseconds ReportingPolicy::getHeartbeat() const
+{
+    return m_heartbeat;
+}
+}    // namespace connect
+}    // namespace wolkabout
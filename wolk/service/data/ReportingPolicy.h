@@ -0,0 +1,84 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WOLKABOUTCONNECTOR_REPORTINGPOLICY_H
+#define WOLKABOUTCONNECTOR_REPORTINGPOLICY_H
+
+#include <chrono>
+
+namespace wolkabout
+{
+namespace connect
+{
+// The ways a new reading can be compared against the last reported reading of the same feed.
+enum class ReportingMode
+{
+    Always = 0,
+    OnChange,
+    AbsoluteDeadband,
+    PercentDeadband
+};
+
+/**
+ * This class describes which readings of a feed are worth reporting to the platform.
+ * Readings that the policy filters out are dropped before they reach the persistence.
+ * Deadbands apply to numeric values (including strings holding a number); other values are reported on change.
+ * With a heartbeat set, a reading is reported anyway once the heartbeat has passed since the last reported one.
+ */
+class ReportingPolicy
+{
+public:
+    /**
+     * Default parameter constructor.
+     *
+     * @param mode The way readings are compared against the last reported reading.
+     * @param deadband The absolute difference, or the percentage of the last reported value, that a reading needs to
+     * exceed to be reported. Only used by the deadband modes.
+     * @param heartbeat The longest time between two reported readings. Zero means there is no heartbeat.
+     */
+    explicit ReportingPolicy(ReportingMode mode = ReportingMode::Always, double deadband = 0,
+                             std::chrono::milliseconds heartbeat = std::chrono::milliseconds{0});
+
+    static ReportingPolicy onChange(std::chrono::milliseconds heartbeat = std::chrono::milliseconds{0});
+
+    static ReportingPolicy absoluteDeadband(double deadband,
+                                            std::chrono::milliseconds heartbeat = std::chrono::milliseconds{0});
+
+    static ReportingPolicy percentDeadband(double percent,
+                                           std::chrono::milliseconds heartbeat = std::chrono::milliseconds{0});
+
+    /**
+     * This method checks whether the policy filters out anything.
+     *
+     * @return Whether some readings might not be reported.
+     */
+    bool isFiltering() const;
+
+    ReportingMode getMode() const;
+
+    double getDeadband() const;
+
+    std::chrono::milliseconds getHeartbeat() const;
+
+private:
+    ReportingMode m_mode;
+    double m_deadband;
+    std::chrono::milliseconds m_heartbeat;
+};
+}    // namespace connect
+}    // namespace wolkabout
+
+#endif    // WOLKABOUTCONNECTOR_REPORTINGPOLICY_H
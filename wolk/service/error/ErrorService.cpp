@@ -17,6 +17,7 @@
 #include "wolk/service/error/ErrorService.h"
 
 #include "core/utilities/Logger.h"
+#include "wolk/utilities/ThreadTimer.h"
 
 namespace wolkabout
 {
@@ -24,8 +25,12 @@ namespace connect
 {
 const std::chrono::milliseconds TIMER_PERIOD = std::chrono::milliseconds{10};
 
-ErrorService::ErrorService(ErrorProtocol& protocol, std::chrono::milliseconds retainTime)
-: m_protocol(protocol), m_working(true), m_retainTime(std::move(retainTime))
+ErrorService::ErrorService(ErrorProtocol& protocol, std::chrono::milliseconds retainTime,
+                           std::unique_ptr<CommandTimer> timer)
+: m_protocol(protocol)
+, m_working(true)
+, m_timer(timer != nullptr ? std::move(timer) : std::unique_ptr<CommandTimer>{new ThreadTimer})
+, m_retainTime(std::move(retainTime))
 {
 }
 
@@ -42,13 +47,13 @@ ErrorService::~ErrorService()
 void ErrorService::start()
 {
     LOG(TRACE) << METHOD_INFO;
-    m_timer.run(TIMER_PERIOD, [&] { timerRuntime(); });
+    m_timer->run(TIMER_PERIOD, [&] { timerRuntime(); });
 }
 
 void ErrorService::stop()
 {
     LOG(TRACE) << METHOD_INFO;
-    m_timer.stop();
+    m_timer->stop();
 }
 
 std::uint64_t ErrorService::peekMessagesForDevice(const std::string& deviceKey)
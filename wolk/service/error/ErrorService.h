@@ -20,12 +20,13 @@
 #include "core/MessageListener.h"
 #include "core/protocol/ErrorProtocol.h"
 #include "core/utilities/Service.h"
-#include "core/utilities/Timer.h"
+#include "wolk/utilities/CommandTimer.h"
 
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <queue>
 
@@ -51,9 +52,11 @@ public:
      *
      * @param protocol The protocol which the ErrorService will follow.
      * @param retainTime The time that defines how long will the ErrorService retain an ErrorMessage.
+     * @param timer The timer that will remove the expired messages. If none is given, the service uses its own thread.
      */
     explicit ErrorService(ErrorProtocol& protocol,
-                          std::chrono::milliseconds retainTime = std::chrono::milliseconds{500});
+                          std::chrono::milliseconds retainTime = std::chrono::milliseconds{500},
+                          std::unique_ptr<CommandTimer> timer = nullptr);
 
     /**
      * Overridden destructor that will stop the running timer.
@@ -143,7 +146,7 @@ private:
 
     // Here we store cached error messages
     bool m_working;
-    Timer m_timer;
+    std::unique_ptr<CommandTimer> m_timer;
     std::chrono::milliseconds m_retainTime;
     std::mutex m_cacheMutex;
     ErrorMessageCache m_cached;
@@ -19,6 +19,7 @@
 #include "core/model/Message.h"
 #include "core/utilities/FileSystemUtils.h"
 #include "core/utilities/Logger.h"
+#include "wolk/utilities/CommandQueue.h"
 
 #include <algorithm>
 #include <iomanip>
@@ -32,7 +33,8 @@ FileManagementService::FileManagementService(ConnectivityService& connectivitySe
                                              FileManagementProtocol& protocol, std::string fileLocation,
                                              bool fileTransferEnabled, bool fileTransferUrlEnabled,
                                              std::shared_ptr<FileDownloader> fileDownloader,
-                                             std::shared_ptr<FileListener> fileListener)
+                                             std::shared_ptr<FileListener> fileListener,
+                                             std::unique_ptr<CommandExecutor> commandExecutor)
 : m_connectivityService(connectivityService)
 , m_dataService(dataService)
 , m_fileTransferEnabled(fileTransferEnabled)
@@ -41,6 +43,8 @@ FileManagementService::FileManagementService(ConnectivityService& connectivitySe
 , m_fileLocation(std::move(fileLocation))
 , m_downloader(std::move(fileDownloader))
 , m_fileListener(std::move(fileListener))
+, m_commandBuffer(commandExecutor != nullptr ? std::move(commandExecutor)
+                                             : std::unique_ptr<CommandExecutor>{new CommandQueue})
 {
     if (!(fileTransferEnabled || fileTransferUrlEnabled))
         throw std::runtime_error("Failed to create 'FileManagementService' with both flags disabled.");
@@ -324,7 +328,7 @@ void FileManagementService::onFileUploadInit(const std::string& deviceKey, const
                               [this, deviceKey](FileTransferStatus status, FileTransferError error) {
                                   this->onFileSessionStatus(deviceKey, status, error);
                               },
-                              m_commandBuffer}};
+                              *m_commandBuffer}};
 
     // Obtain the first message for the session
     auto firstMessage = m_sessions[deviceKey]->getNextChunkRequest();
@@ -378,7 +382,7 @@ void FileManagementService::onFileUrlDownloadInit(const std::string& deviceKey,
       [this, deviceKey](FileTransferStatus status, FileTransferError error) {
           this->onFileSessionStatus(deviceKey, status, error);
       },
-      m_commandBuffer, m_downloader));
+      *m_commandBuffer, m_downloader));
 
     // Trigger the download
     m_sessions[deviceKey]->triggerDownload();
@@ -535,8 +539,7 @@ void FileManagementService::onFileSessionStatus(const std::string& deviceKey, Fi
     case FileTransferStatus::ABORTED:
     {
         // Queue the session deletion
-        m_commandBuffer.pushCommand(
-          std::make_shared<std::function<void()>>([this, deviceKey] { m_sessions[deviceKey].reset(); }));
+        m_commandBuffer->pushCommand([this, deviceKey] { m_sessions[deviceKey].reset(); });
     }
     default:
         break;
@@ -619,11 +622,10 @@ void FileManagementService::notifyListenerAddedFile(const std::string& deviceKey
     {
         if (listener != nullptr)
         {
-            m_commandBuffer.pushCommand(
-              std::make_shared<std::function<void()>>([listener, deviceKey, fileName, absolutePath]() {
-                  if (listener != nullptr)
-                      listener->onAddedFile(deviceKey, fileName, absolutePath);
-              }));
+            m_commandBuffer->pushCommand([listener, deviceKey, fileName, absolutePath]() {
+                if (listener != nullptr)
+                    listener->onAddedFile(deviceKey, fileName, absolutePath);
+            });
         }
     }
 }
@@ -637,10 +639,10 @@ void FileManagementService::notifyListenerRemovedFile(const std::string& deviceK
     {
         if (listener != nullptr)
         {
-            m_commandBuffer.pushCommand(std::make_shared<std::function<void()>>([listener, deviceKey, fileName]() {
+            m_commandBuffer->pushCommand([listener, deviceKey, fileName]() {
                 if (listener != nullptr)
                     listener->onRemovedFile(deviceKey, fileName);
-            }));
+            });
         }
     }
 }
@@ -20,11 +20,13 @@
 #include "core/connectivity/ConnectivityService.h"
 #include "core/connectivity/InboundMessageHandler.h"
 #include "core/protocol/FileManagementProtocol.h"
-#include "core/utilities/CommandBuffer.h"
 #include "wolk/api/FileListener.h"
 #include "wolk/service/data/DataService.h"
 #include "wolk/service/file_management/FileDownloader.h"
 #include "wolk/service/file_management/FileTransferSession.h"
+#include "wolk/utilities/CommandExecutor.h"
+
+#include <memory>
 
 namespace wolkabout
 {
@@ -39,7 +41,8 @@ public:
     FileManagementService(ConnectivityService& connectivityService, DataService& dataService,
                           FileManagementProtocol& protocol, std::string fileLocation, bool fileTransferEnabled = true,
                           bool fileTransferUrlEnabled = true, std::shared_ptr<FileDownloader> fileDownloader = nullptr,
-                          std::shared_ptr<FileListener> fileListener = nullptr);
+                          std::shared_ptr<FileListener> fileListener = nullptr,
+                          std::unique_ptr<CommandExecutor> commandExecutor = nullptr);
 
     std::string getDeviceFileFolder(const std::string& deviceKey) const;
 
@@ -189,7 +192,7 @@ private:
 
     // Make place for the listener pointer
     std::weak_ptr<FileListener> m_fileListener;
-    CommandBuffer m_commandBuffer;
+    std::unique_ptr<CommandExecutor> m_commandBuffer;
 };
 }    // namespace connect
 }    // namespace wolkabout
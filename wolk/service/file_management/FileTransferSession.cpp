@@ -32,7 +32,7 @@ namespace connect
 {
 FileTransferSession::FileTransferSession(std::string deviceKey, const FileUploadInitiateMessage& message,
                                          std::function<void(FileTransferStatus, FileTransferError)> callback,
-                                         CommandBuffer& commandBuffer)
+                                         CommandExecutor& commandBuffer)
 : m_deviceKey(std::move(deviceKey))
 , m_name(message.getName())
 , m_retryCount(0)
@@ -48,7 +48,7 @@ FileTransferSession::FileTransferSession(std::string deviceKey, const FileUpload
 
 FileTransferSession::FileTransferSession(std::string deviceKey, const FileUrlDownloadInitMessage& message,
                                          std::function<void(FileTransferStatus, FileTransferError)> callback,
-                                         CommandBuffer& commandBuffer, std::shared_ptr<FileDownloader> fileDownloader)
+                                         CommandExecutor& commandBuffer, std::shared_ptr<FileDownloader> fileDownloader)
 : m_deviceKey(std::move(deviceKey))
 , m_url(message.getPath())
 , m_retryCount(0)
@@ -303,10 +303,10 @@ void FileTransferSession::changeStatusAndError(FileTransferStatus status, FileTr
 
         // Queue the callback call
         if (m_callback)
-            m_commandBuffer.pushCommand(std::make_shared<std::function<void()>>([this, status, error]() {
+            m_commandBuffer.pushCommand([this, status, error]() {
                 if (m_callback)
                     m_callback(status, error);
-            }));
+            });
     }
 }
 }    // namespace connect
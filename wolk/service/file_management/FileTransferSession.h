@@ -18,10 +18,13 @@
 #define WOLKABOUTCONNECTOR_FILETRANSFERSESSION_H
 
 #include "core/utilities/ByteUtils.h"
-#include "core/utilities/CommandBuffer.h"
 #include "wolk/service/file_management/FileDownloader.h"
+#include "wolk/utilities/CommandExecutor.h"
 
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 
 namespace wolkabout
@@ -61,7 +64,7 @@ public:
      */
     FileTransferSession(std::string deviceKey, const FileUploadInitiateMessage& message,
                         std::function<void(FileTransferStatus, FileTransferError)> callback,
-                        CommandBuffer& commandBuffer);
+                        CommandExecutor& commandBuffer);
 
     /**
      * Default constructor for the FileTransferSession in case of a url download transfer.
@@ -74,7 +77,7 @@ public:
      */
     FileTransferSession(std::string deviceKey, const FileUrlDownloadInitMessage& message,
                         std::function<void(FileTransferStatus, FileTransferError)> callback,
-                        CommandBuffer& commandBuffer, std::shared_ptr<FileDownloader> fileDownloader);
+                        CommandExecutor& commandBuffer, std::shared_ptr<FileDownloader> fileDownloader);
 
     /**
      * Default virtual destructor.
@@ -210,7 +213,7 @@ private:
     FileTransferStatus m_status;
     FileTransferError m_error;
     std::function<void(FileTransferStatus, FileTransferError)> m_callback;
-    CommandBuffer& m_commandBuffer;
+    CommandExecutor& m_commandBuffer;
 };
 }    // namespace connect
 }    // namespace wolkabout
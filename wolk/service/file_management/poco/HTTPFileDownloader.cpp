@@ -17,6 +17,7 @@
 #include "wolk/service/file_management/poco/HTTPFileDownloader.h"
 
 #include "core/utilities/Logger.h"
+#include "wolk/utilities/CommandQueue.h"
 
 #include <Poco/Crypto/CipherKey.h>
 #include <Poco/JSON/Object.h>
@@ -42,7 +43,12 @@ const std::string HTTPS_PATH_PREFIX = "https://";
 const std::regex URL_REGEX = std::regex(
   R"(https?:\/\/(www\.)?[-a-zA-Z0-9@:%._\+~#=]{1,256}\.[a-zA-Z0-9()]{1,6}\b([-a-zA-Z0-9()@:%_\+.~#?&//=]*))");
 
-HTTPFileDownloader::HTTPFileDownloader() : m_status(FileTransferStatus::AWAITING_DEVICE) {}
+HTTPFileDownloader::HTTPFileDownloader(std::unique_ptr<CommandExecutor> commandExecutor)
+: m_status(FileTransferStatus::AWAITING_DEVICE)
+, m_commandBuffer(commandExecutor != nullptr ? std::move(commandExecutor)
+                                             : std::unique_ptr<CommandExecutor>{new CommandQueue})
+{
+}
 
 HTTPFileDownloader::~HTTPFileDownloader()
 {
@@ -235,8 +241,8 @@ void HTTPFileDownloader::changeStatus(FileTransferStatus status, FileTransferErr
         // Check if there's a callback to call
         if (m_statusCallback)
         {
-            m_commandBuffer.pushCommand(std::make_shared<std::function<void()>>(
-              [this, status, error, fileName]() { this->m_statusCallback(status, error, fileName); }));
+            m_commandBuffer->pushCommand(
+              [this, status, error, fileName]() { this->m_statusCallback(status, error, fileName); });
         }
     }
 }
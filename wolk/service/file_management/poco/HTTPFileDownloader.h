@@ -18,10 +18,12 @@
 #define WOLKABOUTCONNECTOR_HTTPFILEDOWNLOADER_H
 
 #include "core/utilities/ByteUtils.h"
-#include "core/utilities/CommandBuffer.h"
 #include "wolk/service/file_management/FileDownloader.h"
+#include "wolk/utilities/CommandExecutor.h"
 
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <thread>
 
 namespace Poco
@@ -41,8 +43,10 @@ class HTTPFileDownloader : public FileDownloader
 public:
     /**
      * Default constructor.
+     *
+     * @param commandExecutor The executor for the status callbacks. If none is given, the downloader runs its own.
      */
-    HTTPFileDownloader();
+    explicit HTTPFileDownloader(std::unique_ptr<CommandExecutor> commandExecutor = nullptr);
 
     /**
      * Overridden destructor. Will abort the download and stop the thread.
@@ -144,7 +148,7 @@ private:
     std::string m_name;
     ByteArray m_bytes;
     std::function<void(FileTransferStatus, FileTransferError, std::string)> m_statusCallback;
-    CommandBuffer m_commandBuffer;
+    std::unique_ptr<CommandExecutor> m_commandBuffer;
 
     // Here we store the session so the session can be closed in case of abort
     std::mutex m_sessionMutex;
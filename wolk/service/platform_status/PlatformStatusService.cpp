@@ -18,6 +18,7 @@
 
 #include "core/protocol/PlatformStatusProtocol.h"
 #include "core/utilities/Logger.h"
+#include "wolk/utilities/CommandQueue.h"
 
 #include <utility>
 
@@ -26,8 +27,12 @@ namespace wolkabout
 namespace connect
 {
 PlatformStatusService::PlatformStatusService(PlatformStatusProtocol& protocol,
-                                             std::shared_ptr<PlatformStatusListener> listener)
-: m_protocol(protocol), m_listener(std::move(listener))
+                                             std::shared_ptr<PlatformStatusListener> listener,
+                                             std::unique_ptr<CommandExecutor> commandExecutor)
+: m_protocol(protocol)
+, m_listener(std::move(listener))
+, m_commandBuffer(commandExecutor != nullptr ? std::move(commandExecutor)
+                                             : std::unique_ptr<CommandExecutor>{new CommandQueue})
 {
 }
 
@@ -46,8 +51,7 @@ void PlatformStatusService::messageReceived(std::shared_ptr<Message> message)
     // Now, do an external call with the received data.
     if (m_listener)
     {
-        m_commandBuffer.pushCommand(std::make_shared<std::function<void()>>(
-          [this, parsed]() { m_listener->platformStatus(parsed->getStatus()); }));
+        m_commandBuffer->pushCommand([this, parsed]() { m_listener->platformStatus(parsed->getStatus()); });
     }
 }
 
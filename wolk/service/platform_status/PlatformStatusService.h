@@ -18,10 +18,11 @@
 #define WOLKABOUTCONNECTOR_PLATFORMSTATUSSERVICE_H
 
 #include "core/MessageListener.h"
-#include "core/utilities/CommandBuffer.h"
 #include "wolk/api/PlatformStatusListener.h"
+#include "wolk/utilities/CommandExecutor.h"
 
 #include <functional>
+#include <memory>
 
 namespace wolkabout
 {
@@ -41,8 +42,10 @@ public:
      *
      * @param protocol The protocol by which the service will oblige.
      * @param listener The listener object which will receive information.
+     * @param commandExecutor The executor for the calls to the listener. If none is given, the service runs its own.
      */
-    PlatformStatusService(PlatformStatusProtocol& protocol, std::shared_ptr<PlatformStatusListener> listener);
+    PlatformStatusService(PlatformStatusProtocol& protocol, std::shared_ptr<PlatformStatusListener> listener,
+                          std::unique_ptr<CommandExecutor> commandExecutor = nullptr);
 
     /**
      * This is an overridden method from the `MessageListener` interface.
@@ -68,7 +71,7 @@ private:
     std::shared_ptr<PlatformStatusListener> m_listener;
 
     // Here we have the command buffer that will execute external calls.
-    CommandBuffer m_commandBuffer;
+    std::unique_ptr<CommandExecutor> m_commandBuffer;
 };
 }    // namespace connect
 }    // namespace wolkabout
@@ -17,6 +17,7 @@
 #include "wolk/service/registration_service/RegistrationService.h"
 
 #include "core/utilities/Logger.h"
+#include "wolk/utilities/CommandQueue.h"
 
 #include <algorithm>
 
@@ -68,8 +69,13 @@ std::size_t DeviceQueryDataHash::operator()(const DeviceQueryData& data) const
     return timestamp ^ (deviceType << 1) ^ (externalId << 2);
 }
 
-RegistrationService::RegistrationService(RegistrationProtocol& protocol, ConnectivityService& connectivityService)
-: m_exitCondition{false}, m_protocol(protocol), m_connectivityService(connectivityService)
+RegistrationService::RegistrationService(RegistrationProtocol& protocol, ConnectivityService& connectivityService,
+                                         std::unique_ptr<CommandExecutor> commandExecutor)
+: m_exitCondition{false}
+, m_protocol(protocol)
+, m_connectivityService(connectivityService)
+, m_commandBuffer(commandExecutor != nullptr ? std::move(commandExecutor)
+                                             : std::unique_ptr<CommandExecutor>{new CommandQueue})
 {
 }
 
@@ -440,8 +446,7 @@ void RegistrationService::handleChildrenSynchronizationResponse(
         const auto children = responseMessage->getChildren();
 
         // And invoke the callback
-        m_commandBuffer.pushCommand(
-          std::make_shared<std::function<void()>>([callback, children] { callback(children); }));
+        m_commandBuffer->pushCommand([callback, children] { callback(children); });
     }
 }
 
@@ -468,8 +473,7 @@ void RegistrationService::handleDeviceRegistrationResponse(
     const auto callback = std::move(it->second);
     const auto success = responseMessage->getSuccess();
     const auto failed = responseMessage->getFailed();
-    m_commandBuffer.pushCommand(
-      std::make_shared<std::function<void()>>([callback, success, failed] { callback(success, failed); }));
+    m_commandBuffer->pushCommand([callback, success, failed] { callback(success, failed); });
     m_deviceRegistrationCallbacks.erase(it);
 }
 
@@ -495,8 +499,7 @@ void RegistrationService::handleRegisteredDevicesResponse(
         {    // Just invoke the callback
             const auto callback = std::move(it->first.getCallback());
             const auto devices = responseMessage->getMatchingDevices();
-            m_commandBuffer.pushCommand(
-              std::make_shared<std::function<void()>>([callback, devices]() { callback(devices); }));
+            m_commandBuffer->pushCommand([callback, devices]() { callback(devices); });
         }
         else
         {
@@ -23,10 +23,15 @@
 #include "core/model/Attribute.h"
 #include "core/model/Feed.h"
 #include "core/protocol/RegistrationProtocol.h"
-#include "core/utilities/CommandBuffer.h"
 #include "core/utilities/Service.h"
 #include "wolk/service/error/ErrorService.h"
+#include "wolk/utilities/CommandExecutor.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 
 namespace wolkabout
@@ -92,8 +97,10 @@ public:
      *
      * @param protocol The protocol this service will follow.
      * @param connectivityService The connectivity service used to send outgoing messages.
+     * @param commandExecutor The executor for the callbacks. If none is given, the service runs its own.
      */
-    explicit RegistrationService(RegistrationProtocol& protocol, ConnectivityService& connectivityService);
+    explicit RegistrationService(RegistrationProtocol& protocol, ConnectivityService& connectivityService,
+                                 std::unique_ptr<CommandExecutor> commandExecutor = nullptr);
 
     /**
      * Overridden constructor. Will stop all running condition variables.
@@ -259,7 +266,7 @@ private:
       m_deviceRegistrationResponses;
 
     // Have a command buffer for calling some callbacks
-    CommandBuffer m_commandBuffer;
+    std::unique_ptr<CommandExecutor> m_commandBuffer;
 };
 }    // namespace connect
 }    // namespace wolkabout
@@ -0,0 +1,152 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/utilities/BoundedCommandQueue.h"
+
+namespace wolkabout
+{
+namespace connect
+{
+namespace
+{
+// The queue whose command the current thread executes
+thread_local const BoundedCommandQueue* executingQueue = nullptr;
+}    // namespace
+
+BoundedCommandQueue::BoundedCommandQueue(std::unique_ptr<CommandExecutor> executor, std::size_t capacity,
+                                         BackpressureMode mode)
+: m_capacity(capacity), m_mode(mode), m_depth(0), m_waiting(0), m_closed(false), m_executor(std::move(executor))
+{
+}
+
+BoundedCommandQueue::~BoundedCommandQueue()
+{
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_closed = true;
+    }
+    m_condition.notify_all();
+
+    // Stop the executor while the state its commands use still exists
+    m_executor.reset();
+}
+
+void BoundedCommandQueue::pushCommand(Task command)
+{
+    if (!command)
+        return;
+    pushCommand<Task>(std::move(command));
+}
+
+std::size_t BoundedCommandQueue::getDepth() const
+{
+    return m_depth;
+}
+
+std::size_t BoundedCommandQueue::getCapacity() const
+{
+    return m_capacity;
+}
+
+BackpressureMode BoundedCommandQueue::getMode() const
+{
+    return m_mode;
+}
+
+bool BoundedCommandQueue::tryReserve()
+{
+    if (m_capacity == 0)
+    {
+        ++m_depth;
+        return true;
+    }
+    auto depth = m_depth.load();
+    while (depth < m_capacity)
+        if (m_depth.compare_exchange_weak(depth, depth + 1))
+            return true;
+    return false;
+}
+
+bool BoundedCommandQueue::reserve()
+{
+    if (m_closed)
+        return false;
+    if (m_mode == BackpressureMode::CoalesceByFeed)
+    {
+        // Commands kept aside must not be overtaken by a command that holds readings of their feeds
+        std::lock_guard<std::mutex> lock{m_mutex};
+        return m_coalesced.empty() && tryReserve();
+    }
+    if (tryReserve())
+        return true;
+    if (m_mode == BackpressureMode::Reject)
+        return false;
+
+    // A command of this queue that waited for room would wait for itself
+    if (isExecuting())
+    {
+        ++m_depth;
+        return true;
+    }
+    auto reserved = false;
+    std::unique_lock<std::mutex> lock{m_mutex};
+    ++m_waiting;
+    m_condition.wait(lock, [&] { return m_closed || (reserved = tryReserve()); });
+    --m_waiting;
+    return reserved;
+}
+
+void BoundedCommandQueue::release()
+{
+    --m_depth;
+    if (m_waiting > 0)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_condition.notify_one();
+    }
+}
+
+void BoundedCommandQueue::drainCoalesced()
+{
+    auto coalesced = std::map<std::pair<std::string, std::string>, Task>{};
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        coalesced.swap(m_coalesced);
+    }
+    m_depth -= coalesced.size();
+    for (auto& command : coalesced)
+        command.second();
+}
+
+const BoundedCommandQueue* BoundedCommandQueue::enter() const
+{
+    const auto previous = executingQueue;
+    executingQueue = this;
+    return previous;
+}
+
+void BoundedCommandQueue::leave(const BoundedCommandQueue* previous)
+{
+    executingQueue = previous;
+}
+
+bool BoundedCommandQueue::isExecuting() const
+{
+    return executingQueue == this;
+}
+}    // namespace connect
+}    // namespace wolkabout
@@ -0,0 +1,219 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WOLKABOUTCONNECTOR_BOUNDEDCOMMANDQUEUE_H
+#define WOLKABOUTCONNECTOR_BOUNDEDCOMMANDQUEUE_H
+
+#include "wolk/utilities/CommandExecutor.h"
+#include "wolk/utilities/Task.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace wolkabout
+{
+namespace connect
+{
+// The ways a producer is held back when the queue is full.
+enum class BackpressureMode
+{
+    // The producer waits until there is room in the queue
+    Block = 0,
+    // The command is refused, and the producer is told so
+    Reject,
+    // Commands of a feed that do not fit are kept aside, and only the latest one of every feed is executed
+    CoalesceByFeed
+};
+
+/**
+ * This class puts a limit on the count of commands waiting in another executor.
+ * Only the commands that are offered count towards the limit, while the pushed ones are always taken, so the internal
+ * commands of the connector are never held back by the producers of readings. A command that offers another one
+ * while being executed is never made to wait, as it would wait for itself.
+ */
+class BoundedCommandQueue : public CommandExecutor
+{
+public:
+    /**
+     * Default parameter constructor.
+     *
+     * @param executor The executor that executes the commands.
+     * @param capacity The count of offered commands that may wait at once. Zero means the count is not limited.
+     * @param mode The way producers are held back once the capacity is reached.
+     */
+    explicit BoundedCommandQueue(std::unique_ptr<CommandExecutor> executor, std::size_t capacity = 0,
+                                 BackpressureMode mode = BackpressureMode::Block);
+
+    /**
+     * Default destructor. Wakes up the producers that wait, and stops the executor.
+     */
+    ~BoundedCommandQueue() override;
+
+    BoundedCommandQueue(const BoundedCommandQueue&) = delete;
+    BoundedCommandQueue& operator=(const BoundedCommandQueue&) = delete;
+
+    void pushCommand(Task command) override;
+
+    template <typename F> void pushCommand(F&& command);
+
+    /**
+     * This method will push a command that counts towards the capacity.
+     * In the coalescing mode, the command does not belong to a feed, so it is refused like in the rejecting mode.
+     *
+     * @param command The command that will be executed.
+     * @return Whether the command was taken.
+     */
+    template <typename F> bool offerCommand(F&& command);
+
+    /**
+     * This method will push a command for a feed that counts towards the capacity.
+     * In the coalescing mode, a command that does not fit replaces the one of the feed that was kept aside.
+     *
+     * @param deviceKey The key of the device the feed belongs to.
+     * @param reference The reference of the feed.
+     * @param command The command that will be executed.
+     * @return Whether the command was taken.
+     */
+    template <typename F> bool offerCommand(const std::string& deviceKey, const std::string& reference, F&& command);
+
+    /**
+     * This method returns the count of offered commands that wait to be executed, including the ones kept aside.
+     *
+     * @return The depth of the queue.
+     */
+    std::size_t getDepth() const;
+
+    std::size_t getCapacity() const;
+
+    BackpressureMode getMode() const;
+
+private:
+    // Marks the commands of this queue while they execute, and counts the offered ones out
+    template <typename Callable> class Marked
+    {
+    public:
+        template <typename F>
+        Marked(BoundedCommandQueue& queue, bool offered, F&& command)
+        : m_queue(&queue), m_offered(offered), m_command(std::forward<F>(command))
+        {
+        }
+
+        void operator()()
+        {
+            if (m_offered)
+                m_queue->release();
+            const auto previous = m_queue->enter();
+            m_command();
+            leave(previous);
+        }
+
+    private:
+        BoundedCommandQueue* m_queue;
+        bool m_offered;
+        Callable m_command;
+    };
+
+    bool tryReserve();
+
+    // Takes a place for an offered command, waiting for one if the mode says so
+    bool reserve();
+
+    void release();
+
+    void drainCoalesced();
+
+    const BoundedCommandQueue* enter() const;
+    static void leave(const BoundedCommandQueue* previous);
+
+    bool isExecuting() const;
+
+    std::size_t m_capacity;
+    BackpressureMode m_mode;
+
+    std::atomic<std::size_t> m_depth;
+    std::atomic<std::size_t> m_waiting;
+    std::atomic_bool m_closed;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::map<std::pair<std::string, std::string>, Task> m_coalesced;
+
+    std::unique_ptr<CommandExecutor> m_executor;
+};
+
+template <typename F> void BoundedCommandQueue::pushCommand(F&& command)
+{
+    m_executor->pushCommand(Marked<typename std::decay<F>::type>{*this, false, std::forward<F>(command)});
+}
+
+template <typename F> bool BoundedCommandQueue::offerCommand(F&& command)
+{
+    if (!reserve())
+        return false;
+    m_executor->pushCommand(Marked<typename std::decay<F>::type>{*this, true, std::forward<F>(command)});
+    return true;
+}
+
+template <typename F>
+bool BoundedCommandQueue::offerCommand(const std::string& deviceKey, const std::string& reference, F&& command)
+{
+    if (m_mode != BackpressureMode::CoalesceByFeed)
+        return offerCommand(std::forward<F>(command));
+
+    using Callable = typename std::decay<F>::type;
+    auto callable = Callable(std::forward<F>(command));
+    auto drain = false;
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        if (m_closed)
+            return false;
+
+        // Once a command of the feed is kept aside, the newer ones replace it, so they never overtake it
+        auto key = std::make_pair(deviceKey, reference);
+        const auto it = m_coalesced.find(key);
+        if (it != m_coalesced.end())
+        {
+            it->second = Task{std::move(callable)};
+            return true;
+        }
+        if (!tryReserve())
+        {
+            drain = m_coalesced.empty();
+            m_coalesced.emplace(std::move(key), Task{std::move(callable)});
+            ++m_depth;
+            if (!drain)
+                return true;
+        }
+    }
+
+    // The executor is given the command outside of the lock, as it may wait for room itself
+    if (drain)
+        pushCommand([this] { drainCoalesced(); });
+    else
+        m_executor->pushCommand(Marked<Callable>{*this, true, std::move(callable)});
+    return true;
+}
+}    // namespace connect
+}    // namespace wolkabout
+
+#endif    // WOLKABOUTCONNECTOR_BOUNDEDCOMMANDQUEUE_H
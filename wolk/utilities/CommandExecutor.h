@@ -0,0 +1,46 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WOLKABOUTCONNECTOR_COMMANDEXECUTOR_H
+#define WOLKABOUTCONNECTOR_COMMANDEXECUTOR_H
+
+#include "wolk/utilities/Task.h"
+
+namespace wolkabout
+{
+namespace connect
+{
+/**
+ * This interface describes an object that executes commands one by one, in the order they were pushed, on its own
+ * worker thread. Commands can be pushed from any thread, including the worker thread itself.
+ */
+class CommandExecutor
+{
+public:
+    virtual ~CommandExecutor() = default;
+
+    /**
+     * This method will push a command to the end of the queue.
+     *
+     * @param command The command that will be executed. Empty commands are ignored.
+     */
+    virtual void pushCommand(Task command) = 0;
+};
+}    // namespace connect
+}    // namespace wolkabout
+
+#endif    // WOLKABOUTCONNECTOR_COMMANDEXECUTOR_H
@@ -0,0 +1,72 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/utilities/CommandQueue.h"
+
+#include <utility>
+
+namespace wolkabout
+{
+namespace connect
+{
+CommandQueue::CommandQueue() : m_running(true), m_worker(&CommandQueue::run, this) {}
+
+CommandQueue::~CommandQueue()
+{
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_running = false;
+    }
+    m_condition.notify_one();
+    if (m_worker.joinable())
+        m_worker.join();
+}
+
+void CommandQueue::pushCommand(Task command)
+{
+    if (!command)
+        return;
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_commands.emplace_back(std::move(command));
+    }
+    m_condition.notify_one();
+}
+
+void CommandQueue::run()
+{
+    auto commands = std::deque<Task>{};
+    while (m_running)
+    {
+        // Take everything that was pushed, so the producers are not blocked while the commands execute
+        {
+            std::unique_lock<std::mutex> lock{m_mutex};
+            m_condition.wait(lock, [this] { return !m_commands.empty() || !m_running; });
+            commands.swap(m_commands);
+        }
+
+        while (!commands.empty() && m_running)
+        {
+            auto command = std::move(commands.front());
+            commands.pop_front();
+            command();
+        }
+        commands.clear();
+    }
+}
+}    // namespace connect
+}    // namespace wolkabout
@@ -0,0 +1,73 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WOLKABOUTCONNECTOR_COMMANDQUEUE_H
+#define WOLKABOUTCONNECTOR_COMMANDQUEUE_H
+
+#include "wolk/utilities/CommandExecutor.h"
+#include "wolk/utilities/Task.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace wolkabout
+{
+namespace connect
+{
+/**
+ * This class executes commands one by one, in the order they were pushed, on its own worker thread.
+ * Commands are moved in and out of the queue, and are never copied.
+ */
+class CommandQueue : public CommandExecutor
+{
+public:
+    /**
+     * Default constructor. Starts the worker thread.
+     */
+    CommandQueue();
+
+    /**
+     * Default destructor. Stops the worker thread. Commands that were not yet executed are discarded.
+     */
+    ~CommandQueue() override;
+
+    CommandQueue(const CommandQueue&) = delete;
+    CommandQueue& operator=(const CommandQueue&) = delete;
+
+    /**
+     * This method will push a command to the end of the queue.
+     *
+     * @param command The command that will be executed.
+     */
+    void pushCommand(Task command) override;
+
+private:
+    void run();
+
+    std::atomic_bool m_running;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<Task> m_commands;
+    std::thread m_worker;
+};
+}    // namespace connect
+}    // namespace wolkabout
+
+#endif    // WOLKABOUTCONNECTOR_COMMANDQUEUE_H
@@ -0,0 +1,63 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WOLKABOUTCONNECTOR_COMMANDTIMER_H
+#define WOLKABOUTCONNECTOR_COMMANDTIMER_H
+
+#include <chrono>
+#include <functional>
+
+namespace wolkabout
+{
+namespace connect
+{
+/**
+ * This interface describes a timer, that invokes a callback once after a delay, or periodically.
+ * The callback should not block, and is best used to push a command to the executor of the service.
+ */
+class CommandTimer
+{
+public:
+    virtual ~CommandTimer() = default;
+
+    /**
+     * This method will invoke the callback once, after the delay. A previous run of the timer is stopped.
+     *
+     * @param delay The time after which the callback is invoked.
+     * @param callback The callback that will be invoked.
+     */
+    virtual void start(std::chrono::milliseconds delay, std::function<void()> callback) = 0;
+
+    /**
+     * This method will invoke the callback periodically, until the timer is stopped. A previous run of the timer is
+     * stopped.
+     *
+     * @param period The time between two invocations of the callback.
+     * @param callback The callback that will be invoked.
+     */
+    virtual void run(std::chrono::milliseconds period, std::function<void()> callback) = 0;
+
+    /**
+     * This method will stop the timer, and wait for the callback if it is being invoked, unless it is invoked on the
+     * calling thread.
+     */
+    virtual void stop() = 0;
+};
+}    // namespace connect
+}    // namespace wolkabout
+
+#endif    // WOLKABOUTCONNECTOR_COMMANDTIMER_H
@@ -0,0 +1,68 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "wolk/utilities/ReconnectPolicy.h"
+
+#include <algorithm>
+
+namespace wolkabout
+{
+namespace connect
+{
+ReconnectPolicy::ReconnectPolicy(std::chrono::milliseconds initialDelay, std::chrono::milliseconds maxDelay,
+                                 double multiplier, double jitter)
+: m_initialDelay(std::max(initialDelay, std::chrono::milliseconds{1}))
+, m_maxDelay(std::max(maxDelay, m_initialDelay))
+, m_multiplier(std::max(multiplier, 1.0))
+, m_jitter(std::min(std::max(jitter, 0.0), 1.0))
+{
+}
+
+std::chrono::milliseconds ReconnectPolicy::getInitialDelay() const
+{
+    return m_initialDelay;
+}
+
+std::chrono::milliseconds ReconnectPolicy::getMaxDelay() const
+{
+    return m_maxDelay;
+}
+
+double ReconnectPolicy::getMultiplier() const
+{
+    return m_multiplier;
+}
+
+double ReconnectPolicy::getJitter() const
+{
+    return m_jitter;
+}
+
+std::chrono::milliseconds ReconnectPolicy::getDelay(std::uint32_t attempt, double random) const
+{
+    // Grow the delay one attempt at a time, so it stops growing as soon as it reaches the maximum
+    const auto maxDelay = static_cast<double>(m_maxDelay.count());
+    auto delay = static_cast<double>(m_initialDelay.count());
+    for (auto i = std::uint32_t{0}; m_multiplier > 1.0 && i < attempt && delay < maxDelay; ++i)
+        delay *= m_multiplier;
+    delay = std::min(delay, maxDelay);
+
+    // Leave out the random part of the jitter
+    delay -= delay * m_jitter * std::min(std::max(random, 0.0), 1.0);
+    return std::chrono::milliseconds{static_cast<std::int64_t>(delay)};
+}
+}    // namespace connect
+}    // namespace wolkabout
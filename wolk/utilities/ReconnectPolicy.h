@@ -0,0 +1,74 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WOLKABOUTCONNECTOR_RECONNECTPOLICY_H
+#define WOLKABOUTCONNECTOR_RECONNECTPOLICY_H
+
+#include <chrono>
+#include <cstdint>
+
+namespace wolkabout
+{
+namespace connect
+{
+/**
+ * This class describes how long to wait before each attempt to reconnect.
+ * The delay starts at the initial delay and grows by the multiplier with every failed attempt, up to the maximum delay.
+ * A random part of the delay, up to the jitter fraction of it, is left out, so devices that lost the connection at the
+ * same time do not all reconnect at the same time.
+ */
+class ReconnectPolicy
+{
+public:
+    /**
+     * Default parameter constructor.
+     *
+     * @param initialDelay The delay before the first attempt, at least a millisecond.
+     * @param maxDelay The longest delay between two attempts.
+     * @param multiplier The factor the delay grows by after a failed attempt. Values below one are taken as one.
+     * @param jitter The fraction of the delay that is randomized, between zero and one.
+     */
+    explicit ReconnectPolicy(std::chrono::milliseconds initialDelay = std::chrono::milliseconds{1000},
+                             std::chrono::milliseconds maxDelay = std::chrono::milliseconds{60000},
+                             double multiplier = 2.0, double jitter = 0.5);
+
+    std::chrono::milliseconds getInitialDelay() const;
+
+    std::chrono::milliseconds getMaxDelay() const;
+
+    double getMultiplier() const;
+
+    double getJitter() const;
+
+    /**
+     * This method calculates the delay before an attempt.
+     *
+     * @param attempt The count of attempts that failed before this one.
+     * @param random A random value between zero and one, deciding which part of the jitter is left out.
+     * @return The delay before the attempt.
+     */
+    std::chrono::milliseconds getDelay(std::uint32_t attempt, double random) const;
+
+private:
+    std::chrono::milliseconds m_initialDelay;
+    std::chrono::milliseconds m_maxDelay;
+    double m_multiplier;
+    double m_jitter;
+};
+}    // namespace connect
+}    // namespace wolkabout
+
+#endif    // WOLKABOUTCONNECTOR_RECONNECTPOLICY_H
@@ -0,0 +1,185 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/utilities/RingCommandQueue.h"
+
+#include <utility>
+
+namespace wolkabout
+{
+namespace connect
+{
+namespace
+{
+std::size_t roundUpToPowerOfTwo(std::size_t value)
+{
+    auto result = std::size_t{2};
+    while (result < value)
+        result <<= 1;
+    return result;
+}
+}    // namespace
+
+RingCommandQueue::RingCommandQueue(std::size_t capacity)
+: m_mask(roundUpToPowerOfTwo(capacity) - 1)
+, m_slots(new Slot[m_mask + 1])
+, m_enqueue(0)
+, m_running(true)
+, m_sleeping(false)
+, m_overflowing(false)
+{
+    for (auto i = std::size_t{0}; i <= m_mask; ++i)
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    m_worker = std::thread{&RingCommandQueue::run, this};
+}
+
+RingCommandQueue::~RingCommandQueue()
+{
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_running = false;
+    }
+    m_condition.notify_one();
+    if (m_worker.joinable())
+        m_worker.join();
+}
+
+void RingCommandQueue::pushCommand(Task command)
+{
+    if (!command)
+        return;
+
+    // Waiting for a free slot could wait forever, if the worker waits for this thread, so the command is kept aside
+    if (m_overflowing.load(std::memory_order_relaxed) || !tryPush(command))
+    {
+        pushOverflow(std::move(command));
+        return;
+    }
+
+    // Wake up the worker only if it went to sleep, the fences make sure one of the two sees the other
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleeping.load(std::memory_order_relaxed))
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_condition.notify_one();
+    }
+}
+
+std::size_t RingCommandQueue::getCapacity() const
+{
+    return m_mask + 1;
+}
+
+bool RingCommandQueue::tryPush(Task& command)
+{
+    auto position = m_enqueue.load(std::memory_order_relaxed);
+    while (true)
+    {
+        auto& slot = m_slots[position & m_mask];
+        const auto sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence == position)
+        {
+            if (m_enqueue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                slot.command = std::move(command);
+                slot.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (sequence < position)
+        {
+            // The slot still holds a command from the previous lap, so the ring is full
+            return false;
+        }
+        else
+        {
+            position = m_enqueue.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool RingCommandQueue::tryPop(std::size_t position, Task& command)
+{
+    auto& slot = m_slots[position & m_mask];
+    if (slot.sequence.load(std::memory_order_acquire) != position + 1)
+        return false;
+    command = std::move(slot.command);
+    slot.sequence.store(position + m_mask + 1, std::memory_order_release);
+    return true;
+}
+
+void RingCommandQueue::pushOverflow(Task command)
+{
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_overflow.emplace_back(std::move(command));
+        m_overflowing.store(true, std::memory_order_relaxed);
+    }
+    m_condition.notify_one();
+}
+
+bool RingCommandQueue::tryPopOverflow(std::size_t position, Task& command)
+{
+    // The commands in the ring that were claimed before are older, so they go first
+    if (!m_overflowing.load(std::memory_order_relaxed) || m_enqueue.load(std::memory_order_acquire) != position)
+        return false;
+
+    std::lock_guard<std::mutex> lock{m_mutex};
+    command = std::move(m_overflow.front());
+    m_overflow.pop_front();
+    if (m_overflow.empty())
+        m_overflowing.store(false, std::memory_order_relaxed);
+    return true;
+}
+
+bool RingCommandQueue::isWritten(std::size_t position) const
+{
+    return m_slots[position & m_mask].sequence.load(std::memory_order_acquire) == position + 1;
+}
+
+void RingCommandQueue::run()
+{
+    auto position = std::size_t{0};
+    auto command = Task{};
+    while (m_running)
+    {
+        if (tryPop(position, command))
+        {
+            ++position;
+            command();
+            command = Task{};
+            continue;
+        }
+        if (tryPopOverflow(position, command))
+        {
+            command();
+            command = Task{};
+            continue;
+        }
+
+        // Out of commands, so announce going to sleep, and check once more before sleeping
+        std::unique_lock<std::mutex> lock{m_mutex};
+        m_sleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        m_condition.wait(lock, [&] {
+            return isWritten(position) || (!m_overflow.empty() && m_enqueue.load() == position) || !m_running;
+        });
+        m_sleeping.store(false, std::memory_order_relaxed);
+    }
+}
+}    // namespace connect
+}    // namespace wolkabout
@@ -0,0 +1,105 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WOLKABOUTCONNECTOR_RINGCOMMANDQUEUE_H
+#define WOLKABOUTCONNECTOR_RINGCOMMANDQUEUE_H
+
+#include "wolk/utilities/CommandExecutor.h"
+#include "wolk/utilities/Task.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace wolkabout
+{
+namespace connect
+{
+/**
+ * This class executes commands one by one, in the order they were pushed, on its own worker thread.
+ * Commands are kept in a fixed ring of slots, and producers claim a slot with a single atomic operation, so pushing a
+ * command neither allocates nor takes a lock. The lock is only taken to wake up the worker when it ran out of
+ * commands, and when the ring is full. Then the commands are kept aside in a list until the worker catches up, so a
+ * producer never waits for the worker, which might itself be waiting for the producer.
+ */
+class RingCommandQueue : public CommandExecutor
+{
+public:
+    /**
+     * Default parameter constructor. Starts the worker thread.
+     *
+     * @param capacity The count of slots in the ring, rounded up to a power of two.
+     */
+    explicit RingCommandQueue(std::size_t capacity = 1024);
+
+    /**
+     * Default destructor. Stops the worker thread. Commands that were not yet executed are discarded.
+     */
+    ~RingCommandQueue() override;
+
+    RingCommandQueue(const RingCommandQueue&) = delete;
+    RingCommandQueue& operator=(const RingCommandQueue&) = delete;
+
+    void pushCommand(Task command) override;
+
+    std::size_t getCapacity() const;
+
+private:
+    struct Slot
+    {
+        // Equal to the position when the slot is free, and one past it once the command is written
+        std::atomic<std::size_t> sequence;
+        Task command;
+    };
+
+    bool tryPush(Task& command);
+
+    // Takes the command at the position, if it was written
+    bool tryPop(std::size_t position, Task& command);
+
+    bool isWritten(std::size_t position) const;
+
+    void pushOverflow(Task command);
+
+    // Takes the command kept aside, once the ring has no commands left before it
+    bool tryPopOverflow(std::size_t position, Task& command);
+
+    void run();
+
+    std::size_t m_mask;
+    std::unique_ptr<Slot[]> m_slots;
+    std::atomic<std::size_t> m_enqueue;
+
+    std::atomic_bool m_running;
+    std::atomic_bool m_sleeping;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+
+    // The commands pushed while the ring was full, and while there are any, all the others are pushed after them
+    std::deque<Task> m_overflow;
+    std::atomic_bool m_overflowing;
+
+    std::thread m_worker;
+};
+}    // namespace connect
+}    // namespace wolkabout
+
+#endif    // WOLKABOUTCONNECTOR_RINGCOMMANDQUEUE_H
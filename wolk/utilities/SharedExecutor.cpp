@@ -0,0 +1,346 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/utilities/SharedExecutor.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace wolkabout
+{
+namespace connect
+{
+namespace
+{
+// The count of commands a strand executes before it lets the other strands take their turn
+const constexpr std::size_t COMMANDS_PER_TURN = 64;
+}    // namespace
+
+// The strands that have commands waiting, in the order they take their turns, and the timers waiting to be due
+struct SharedExecutor::RunQueue
+{
+    using Clock = std::chrono::steady_clock;
+
+    // A run of a timer, that is dropped if the timer was stopped or started again since
+    struct Firing
+    {
+        std::shared_ptr<TimerState> timer;
+        std::uint64_t generation;
+    };
+
+    RunQueue() : running(true) {}
+
+    void schedule(std::shared_ptr<StrandState> strand)
+    {
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            if (!running)
+                return;
+            strands.emplace_back(std::move(strand));
+        }
+        condition.notify_one();
+    }
+
+    void schedule(Clock::time_point due, std::shared_ptr<TimerState> timer, std::uint64_t generation)
+    {
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            if (!running)
+                return;
+            timers.emplace(due, Firing{std::move(timer), generation});
+        }
+        // The waiting workers may all be sleeping until a later timer
+        condition.notify_all();
+    }
+
+    bool running;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<std::shared_ptr<StrandState>> strands;
+    std::multimap<Clock::time_point, Firing> timers;
+};
+
+struct SharedExecutor::StrandState : public std::enable_shared_from_this<StrandState>
+{
+    explicit StrandState(std::shared_ptr<RunQueue> runQueue)
+    : queue(std::move(runQueue)), scheduled(false), closed(false)
+    {
+    }
+
+    void execute()
+    {
+        auto commands = std::deque<Task>{};
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            if (closed)
+            {
+                scheduled = false;
+                return;
+            }
+            while (!pending.empty() && commands.size() < COMMANDS_PER_TURN)
+            {
+                commands.emplace_back(std::move(pending.front()));
+                pending.pop_front();
+            }
+            executing = std::this_thread::get_id();
+        }
+
+        while (!commands.empty() && !closed)
+        {
+            auto command = std::move(commands.front());
+            commands.pop_front();
+            command();
+        }
+        commands.clear();
+
+        auto again = false;
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            executing = std::thread::id{};
+            again = !closed && !pending.empty();
+            scheduled = again;
+        }
+        condition.notify_all();
+        if (again)
+            queue->schedule(shared_from_this());
+    }
+
+    std::shared_ptr<RunQueue> queue;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<Task> pending;
+    bool scheduled;
+    std::atomic_bool closed;
+    std::thread::id executing;
+};
+
+class SharedExecutor::Strand : public CommandExecutor
+{
+public:
+    explicit Strand(std::shared_ptr<RunQueue> queue) : m_state(std::make_shared<StrandState>(std::move(queue))) {}
+
+    ~Strand() override
+    {
+        auto discarded = std::deque<Task>{};
+        {
+            std::unique_lock<std::mutex> lock{m_state->mutex};
+            m_state->closed = true;
+            discarded.swap(m_state->pending);
+
+            // A command may destroy its own strand, and then it is the only one left to wait for
+            m_state->condition.wait(lock, [this] {
+                return m_state->executing == std::thread::id{} ||
+                       m_state->executing == std::this_thread::get_id();
+            });
+        }
+    }
+
+    void pushCommand(Task command) override
+    {
+        if (!command)
+            return;
+        {
+            std::lock_guard<std::mutex> lock{m_state->mutex};
+            if (m_state->closed)
+                return;
+            m_state->pending.emplace_back(std::move(command));
+            if (m_state->scheduled)
+                return;
+            m_state->scheduled = true;
+        }
+        m_state->queue->schedule(m_state);
+    }
+
+private:
+    std::shared_ptr<StrandState> m_state;
+};
+
+struct SharedExecutor::TimerState : public std::enable_shared_from_this<TimerState>
+{
+    explicit TimerState(std::shared_ptr<RunQueue> runQueue)
+    : queue(std::move(runQueue)), generation(0), period(0)
+    {
+    }
+
+    void fire(std::uint64_t firing)
+    {
+        auto invoked = std::function<void()>{};
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            if (firing != generation)
+                return;
+            invoked = callback;
+            executing = std::this_thread::get_id();
+        }
+
+        invoked();
+
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            executing = std::thread::id{};
+            if (firing == generation && period.count() > 0)
+                queue->schedule(RunQueue::Clock::now() + period, shared_from_this(), generation);
+        }
+        condition.notify_all();
+    }
+
+    std::shared_ptr<RunQueue> queue;
+    std::mutex mutex;
+    std::condition_variable condition;
+    // Every start and stop moves to a new generation, so the runs scheduled before are dropped
+    std::uint64_t generation;
+    std::function<void()> callback;
+    std::chrono::milliseconds period;
+    std::thread::id executing;
+};
+
+class SharedExecutor::Timer : public CommandTimer
+{
+public:
+    explicit Timer(std::shared_ptr<RunQueue> queue) : m_state(std::make_shared<TimerState>(std::move(queue))) {}
+
+    ~Timer() override { stop(); }
+
+    void start(std::chrono::milliseconds delay, std::function<void()> callback) override
+    {
+        schedule(delay, std::chrono::milliseconds{0}, std::move(callback));
+    }
+
+    void run(std::chrono::milliseconds period, std::function<void()> callback) override
+    {
+        schedule(period, period, std::move(callback));
+    }
+
+    void stop() override
+    {
+        auto discarded = std::function<void()>{};
+        {
+            std::unique_lock<std::mutex> lock{m_state->mutex};
+            ++m_state->generation;
+            discarded.swap(m_state->callback);
+
+            // A callback may stop its own timer, and then it is the only one left to wait for
+            m_state->condition.wait(lock, [this] {
+                return m_state->executing == std::thread::id{} ||
+                       m_state->executing == std::this_thread::get_id();
+            });
+        }
+    }
+
+private:
+    void schedule(std::chrono::milliseconds delay, std::chrono::milliseconds period, std::function<void()> callback)
+    {
+        stop();
+        if (!callback)
+            return;
+
+        std::lock_guard<std::mutex> lock{m_state->mutex};
+        m_state->callback = std::move(callback);
+        m_state->period = period;
+        m_state->queue->schedule(RunQueue::Clock::now() + delay, m_state, m_state->generation);
+    }
+
+    std::shared_ptr<TimerState> m_state;
+};
+
+SharedExecutor::SharedExecutor(std::size_t workers) : m_queue(std::make_shared<RunQueue>())
+{
+    for (auto i = std::size_t{0}; i < (workers > 0 ? workers : 1); ++i)
+        m_workers.emplace_back(&SharedExecutor::run, this);
+}
+
+SharedExecutor::~SharedExecutor()
+{
+    auto discarded = std::deque<std::shared_ptr<StrandState>>{};
+    auto discardedTimers = std::multimap<RunQueue::Clock::time_point, RunQueue::Firing>{};
+    {
+        std::lock_guard<std::mutex> lock{m_queue->mutex};
+        m_queue->running = false;
+        discarded.swap(m_queue->strands);
+        discardedTimers.swap(m_queue->timers);
+    }
+    m_queue->condition.notify_all();
+    for (auto& worker : m_workers)
+    {
+        if (worker.get_id() == std::this_thread::get_id())
+            worker.detach();
+        else if (worker.joinable())
+            worker.join();
+    }
+}
+
+std::unique_ptr<CommandExecutor> SharedExecutor::makeStrand()
+{
+    return std::unique_ptr<CommandExecutor>{new Strand{m_queue}};
+}
+
+std::unique_ptr<CommandTimer> SharedExecutor::makeTimer()
+{
+    return std::unique_ptr<CommandTimer>{new Timer{m_queue}};
+}
+
+std::size_t SharedExecutor::getWorkerCount() const
+{
+    return m_workers.size();
+}
+
+void SharedExecutor::run()
+{
+    // The queue is held here, so a worker left running by a detach still has it
+    const auto queue = m_queue;
+    while (true)
+    {
+        auto strand = std::shared_ptr<StrandState>{};
+        auto firing = RunQueue::Firing{};
+        {
+            std::unique_lock<std::mutex> lock{queue->mutex};
+            while (queue->running && strand == nullptr && firing.timer == nullptr)
+            {
+                // The timers that are due go first, so a busy strand can not hold them back
+                if (!queue->timers.empty() && queue->timers.begin()->first <= RunQueue::Clock::now())
+                {
+                    firing = std::move(queue->timers.begin()->second);
+                    queue->timers.erase(queue->timers.begin());
+                }
+                else if (!queue->strands.empty())
+                {
+                    strand = std::move(queue->strands.front());
+                    queue->strands.pop_front();
+                }
+                else if (!queue->timers.empty())
+                    queue->condition.wait_until(lock, queue->timers.begin()->first);
+                else
+                    queue->condition.wait(lock);
+            }
+            if (!queue->running)
+                return;
+        }
+        if (firing.timer != nullptr)
+            firing.timer->fire(firing.generation);
+        else
+            strand->execute();
+    }
+}
+}    // namespace connect
+}    // namespace wolkabout
@@ -0,0 +1,93 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WOLKABOUTCONNECTOR_SHAREDEXECUTOR_H
+#define WOLKABOUTCONNECTOR_SHAREDEXECUTOR_H
+
+#include "wolk/utilities/CommandExecutor.h"
+#include "wolk/utilities/CommandTimer.h"
+
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace wolkabout
+{
+namespace connect
+{
+/**
+ * This class runs commands of many services on a small, fixed pool of worker threads.
+ * Each service gets its own strand, a `CommandExecutor` whose commands are executed one by one, in the order they were
+ * pushed, never at the same time, although not always on the same worker. Strands take turns on the workers, so a
+ * strand with many commands does not keep the others waiting.
+ * The timers it makes are serviced by the same workers, so the delays of the services do not need threads of their
+ * own either.
+ */
+class SharedExecutor
+{
+public:
+    /**
+     * Default parameter constructor. Starts the worker threads.
+     *
+     * @param workers The count of worker threads. At least one worker is always started.
+     */
+    explicit SharedExecutor(std::size_t workers = 1);
+
+    /**
+     * Default destructor. Stops the worker threads. Commands that were not yet executed are discarded, and strands
+     * that outlive the executor discard the commands pushed to them.
+     */
+    ~SharedExecutor();
+
+    SharedExecutor(const SharedExecutor&) = delete;
+    SharedExecutor& operator=(const SharedExecutor&) = delete;
+
+    /**
+     * This method creates a new strand, that executes its commands on the workers of this executor.
+     * Destroying the strand discards its commands that were not yet executed, and waits for the one being executed.
+     *
+     * @return The new strand.
+     */
+    std::unique_ptr<CommandExecutor> makeStrand();
+
+    /**
+     * This method creates a new timer, whose callbacks are invoked on the workers of this executor once they are due.
+     * Destroying the timer stops it. A timer that outlives the executor never invokes its callback.
+     *
+     * @return The new timer.
+     */
+    std::unique_ptr<CommandTimer> makeTimer();
+
+    std::size_t getWorkerCount() const;
+
+private:
+    struct RunQueue;
+    struct StrandState;
+    class Strand;
+    struct TimerState;
+    class Timer;
+
+    void run();
+
+    std::shared_ptr<RunQueue> m_queue;
+    std::vector<std::thread> m_workers;
+};
+}    // namespace connect
+}    // namespace wolkabout
+
+#endif    // WOLKABOUTCONNECTOR_SHAREDEXECUTOR_H
@@ -0,0 +1,190 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WOLKABOUTCONNECTOR_TASK_H
+#define WOLKABOUTCONNECTOR_TASK_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace wolkabout
+{
+namespace connect
+{
+/**
+ * This class is a move-only replacement for `std::function<void()>` used for commands.
+ * Callables that fit into the internal buffer are stored in place, so enqueueing a command does not allocate.
+ * Larger callables are stored on the heap, with a single allocation.
+ */
+class Task
+{
+public:
+    /**
+     * Default constructor. Creates an empty task.
+     */
+    Task() noexcept : m_operations(nullptr) {}
+
+    /**
+     * Constructor that takes in any callable that can be invoked with no arguments.
+     *
+     * @param callable The callable that will be invoked by the task.
+     */
+    template <typename F, typename = typename std::enable_if<
+                            !std::is_same<typename std::decay<F>::type, Task>::value>::type>
+    Task(F&& callable) : m_operations(nullptr)
+    {
+        using Callable = typename std::decay<F>::type;
+        store<Callable>(std::forward<F>(callable), std::integral_constant<bool, fitsInPlace<Callable>()>{});
+    }
+
+    Task(Task&& other) noexcept : m_operations(other.m_operations)
+    {
+        if (m_operations != nullptr)
+        {
+            m_operations->move(&m_storage, &other.m_storage);
+            other.m_operations = nullptr;
+        }
+    }
+
+    Task& operator=(Task&& other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            if (other.m_operations != nullptr)
+            {
+                other.m_operations->move(&m_storage, &other.m_storage);
+                m_operations = other.m_operations;
+                other.m_operations = nullptr;
+            }
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() { reset(); }
+
+    /**
+     * This method checks whether the task holds a callable.
+     *
+     * @return Whether the task can be invoked.
+     */
+    explicit operator bool() const noexcept { return m_operations != nullptr; }
+
+    /**
+     * This method will invoke the callable. Invoking an empty task does nothing.
+     */
+    void operator()()
+    {
+        if (m_operations != nullptr)
+            m_operations->invoke(&m_storage);
+    }
+
+    /**
+     * This method checks whether a callable type would be stored without an allocation.
+     *
+     * @return Whether the callable type fits into the internal buffer.
+     */
+    template <typename Callable> static constexpr bool fitsInPlace()
+    {
+        return sizeof(Callable) <= BUFFER_SIZE && alignof(Callable) <= BUFFER_ALIGNMENT &&
+               std::is_nothrow_move_constructible<Callable>::value;
+    }
+
+    static const constexpr std::size_t BUFFER_SIZE = 128;
+    static const constexpr std::size_t BUFFER_ALIGNMENT = alignof(std::max_align_t);
+
+private:
+    using Storage = typename std::aligned_storage<BUFFER_SIZE, BUFFER_ALIGNMENT>::type;
+
+    struct Operations
+    {
+        void (*invoke)(Storage*);
+        void (*move)(Storage* destination, Storage* source);
+        void (*destroy)(Storage*);
+    };
+
+    // Operations for the callables that are stored in place
+    template <typename Callable> struct InPlace
+    {
+        static Callable* get(Storage* storage) { return reinterpret_cast<Callable*>(storage); }
+        static void invoke(Storage* storage) { (*get(storage))(); }
+        static void move(Storage* destination, Storage* source)
+        {
+            new (destination) Callable(std::move(*get(source)));
+            get(source)->~Callable();
+        }
+        static void destroy(Storage* storage) { get(storage)->~Callable(); }
+        static const Operations operations;
+    };
+
+    // Operations for the callables that are stored on the heap, where the buffer holds only the pointer
+    template <typename Callable> struct OnHeap
+    {
+        static Callable*& get(Storage* storage) { return *reinterpret_cast<Callable**>(storage); }
+        static void invoke(Storage* storage) { (*get(storage))(); }
+        static void move(Storage* destination, Storage* source)
+        {
+            new (destination) Callable*(get(source));
+            get(source) = nullptr;
+        }
+        static void destroy(Storage* storage) { delete get(storage); }
+        static const Operations operations;
+    };
+
+    template <typename Callable, typename F> void store(F&& callable, std::true_type)
+    {
+        new (&m_storage) Callable(std::forward<F>(callable));
+        m_operations = &InPlace<Callable>::operations;
+    }
+
+    template <typename Callable, typename F> void store(F&& callable, std::false_type)
+    {
+        new (&m_storage) Callable*(new Callable(std::forward<F>(callable)));
+        m_operations = &OnHeap<Callable>::operations;
+    }
+
+    void reset() noexcept
+    {
+        if (m_operations != nullptr)
+        {
+            m_operations->destroy(&m_storage);
+            m_operations = nullptr;
+        }
+    }
+
+    Storage m_storage;
+    const Operations* m_operations;
+};
+
+template <typename Callable>
+const Task::Operations Task::InPlace<Callable>::operations = {&Task::InPlace<Callable>::invoke,
+                                                              &Task::InPlace<Callable>::move,
+                                                              &Task::InPlace<Callable>::destroy};
+
+template <typename Callable>
+const Task::Operations Task::OnHeap<Callable>::operations = {&Task::OnHeap<Callable>::invoke,
+                                                             &Task::OnHeap<Callable>::move,
+                                                             &Task::OnHeap<Callable>::destroy};
+}    // namespace connect
+}    // namespace wolkabout
+
+#endif    // WOLKABOUTCONNECTOR_TASK_H
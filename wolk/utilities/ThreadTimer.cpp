@@ -0,0 +1,43 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "wolk/utilities/ThreadTimer.h"
+
+#include <utility>
+
+namespace wolkabout
+{
+namespace connect
+{
+void ThreadTimer::start(std::chrono::milliseconds delay, std::function<void()> callback)
+{
+    m_timer.stop();
+    m_timer.start(delay, std::move(callback));
+}
+
+void ThreadTimer::run(std::chrono::milliseconds period, std::function<void()> callback)
+{
+    m_timer.stop();
+    m_timer.run(period, std::move(callback));
+}
+
+void ThreadTimer::stop()
+{
+    m_timer.stop();
+}
+}    // namespace connect
+}    // namespace wolkabout
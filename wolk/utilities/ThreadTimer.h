@@ -0,0 +1,47 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WOLKABOUTCONNECTOR_THREADTIMER_H
+#define WOLKABOUTCONNECTOR_THREADTIMER_H
+
+#include "core/utilities/Timer.h"
+#include "wolk/utilities/CommandTimer.h"
+
+namespace wolkabout
+{
+namespace connect
+{
+/**
+ * This class is the timer that invokes its callback on a thread of its own. It is used by the services that were not
+ * given a timer of a shared executor.
+ */
+class ThreadTimer : public CommandTimer
+{
+public:
+    void start(std::chrono::milliseconds delay, std::function<void()> callback) override;
+
+    void run(std::chrono::milliseconds period, std::function<void()> callback) override;
+
+    void stop() override;
+
+private:
+    Timer m_timer;
+};
+}    // namespace connect
+}    // namespace wolkabout
+
+#endif    // WOLKABOUTCONNECTOR_THREADTIMER_H